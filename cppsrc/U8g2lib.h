@@ -189,6 +189,9 @@ class U8G2
     
     void firstPage(void) { u8g2_FirstPage(&u8g2); }
     uint8_t nextPage(void) { return u8g2_NextPage(&u8g2); }
+    void drawCanvas(uint16_t canvas_height, void (*draw_cb)(u8g2_t *u8g2, uint16_t y)) { u8g2_DrawCanvas(&u8g2, canvas_height, draw_cb); }
+    void scrollUp(uint8_t tile_rows) { u8g2_ScrollUp(&u8g2, tile_rows); }
+    void sendScroll(void) { u8g2_SendScroll(&u8g2); }
     
     #ifdef U8G2_USE_DYNAMIC_ALLOC
     void setBufferPtr(uint8_t *buf) { u8g2_SetBufferPtr(&u8g2, buf); }
@@ -211,6 +214,18 @@ class U8G2
       { u8g2_UpdateDisplay(&u8g2); }
     void refreshDisplay(void)
       { u8x8_RefreshDisplay(u8g2_GetU8x8(&u8g2)); }
+    void setDisplayMemory(void *mem, uint16_t size)
+      { u8x8_SetDisplayMemory(u8g2_GetU8x8(&u8g2), mem, size); }
+    void setEPaperPartialRefresh(void *mem, uint16_t size, uint8_t partial_limit, uint8_t area_percent)
+      { u8x8_SetEPaperPartialRefresh(u8g2_GetU8x8(&u8g2), mem, size, partial_limit, area_percent); }
+    void toggleVCOM(void)
+      { u8x8_ToggleVCOM(u8g2_GetU8x8(&u8g2)); }
+    void setTextLayer(uint8_t is_enable)
+      { u8x8_SetTextLayer(u8g2_GetU8x8(&u8g2), is_enable); }
+    uint8_t drawTextLayerString(uint8_t x, uint8_t y, const char *s)
+      { return u8x8_DrawTextLayerString(u8g2_GetU8x8(&u8g2), x, y, s); }
+    void loadTextLayerGlyph(uint8_t code, uint8_t encoding)
+      { u8x8_LoadTextLayerGlyph(u8g2_GetU8x8(&u8g2), code, encoding); }
     
 
 
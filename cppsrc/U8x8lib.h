@@ -273,6 +273,27 @@ class U8X8
 
     void refreshDisplay(void) {			// Dec 16: Only required for SSD1606
       u8x8_RefreshDisplay(&u8x8); }
+
+    void setDisplayMemory(void *mem, uint16_t size) {	// call before begin()
+      u8x8_SetDisplayMemory(&u8x8, mem, size); }
+
+    void setEPaperPartialRefresh(void *mem, uint16_t size, uint8_t partial_limit, uint8_t area_percent) {
+      u8x8_SetEPaperPartialRefresh(&u8x8, mem, size, partial_limit, area_percent); }
+
+    void toggleVCOM(void) {			// Sharp memory LCD
+      u8x8_ToggleVCOM(&u8x8); }
+
+    void setTextLayer(uint8_t is_enable) {	// T6963, SED1330
+      u8x8_SetTextLayer(&u8x8, is_enable); }
+      
+    uint8_t drawTextLayerString(uint8_t x, uint8_t y, const char *s) {
+      return u8x8_DrawTextLayerString(&u8x8, x, y, s); }
+      
+    void loadTextLayerGlyph(uint8_t code, uint8_t encoding) {
+      u8x8_LoadTextLayerGlyph(&u8x8, code, encoding); }
+      
+    uint8_t setDisplayStartLine(uint8_t line) {	// SSD1306/SH1106 128x64
+      return u8x8_SetDisplayStartLine(&u8x8, line); }
       
     void clearLine(uint8_t line) {
       u8x8_ClearLine(&u8x8, line); }
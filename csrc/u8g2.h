@@ -158,6 +158,17 @@
 #define U8G2_WITH_UNICODE
 #endif
 
+/*
+  Statistic counters for the drawing procedures (hvline, intersection test, 
+  font decoder, bitmaps) and the u8x8 display transfer, see u8g2_GetStats().
+  This is disabled by default. Without this macro, the counters do not use 
+  any code or memory.
+  
+  The macro must be defined for all files of u8g2 and the application,
+  so it should be set as compiler option: -DU8G2_WITH_STATS
+*/
+//#define U8G2_WITH_STATS
+
 
 /*
   See issue https://github.com/olikraus/u8g2/issues/1561
@@ -311,6 +322,21 @@ struct u8g2_cb_struct
 typedef u8g2_uint_t (*u8g2_font_calc_vref_fnptr)(u8g2_t *u8g2);
 
 
+#ifdef U8G2_WITH_STATS
+/* statistic counters, see u8g2_GetStats() */
+struct _u8g2_stats_t
+{
+  uint32_t hvline_calls;	/* calls to the low level hvline procedure (u8g2->ll_hvline) */
+  uint32_t hvline_pixels;	/* pixels drawn by the low level hvline procedure */
+  uint32_t intersection_rejects;	/* u8g2_IsIntersection() calls which returned 0 */
+  uint32_t glyphs_decoded;	/* glyphs, which are decoded and drawn by the font procedures */
+  uint32_t rle_runs;		/* run length segments of the decoded glyphs */
+  uint32_t bitmap_pixels;	/* pixels drawn by the bitmap procedures */
+  u8x8_stats_t u8x8;		/* u8x8 counters, copied by u8g2_GetStats() */
+};
+typedef struct _u8g2_stats_t u8g2_stats_t;
+#endif
+
 struct u8g2_struct
 {
   u8x8_t u8x8;
@@ -383,9 +409,22 @@ struct u8g2_struct
 	// the following variable should be renamed to is_buffer_auto_clear
   uint8_t is_auto_page_clear; 		/* set to 0 to disable automatic clear of the buffer in firstPage() and nextPage() */
   
+  /* hardware scroll, see u8g2_ScrollUp(), the display RAM tile row at the top is u8x8.start_line/8 */
+  uint8_t tile_scroll_pending;	/* number of tile rows, which are scrolled in the buffer, but not on the display */
+
+#ifdef U8G2_WITH_STATS
+  u8g2_stats_t stats;		/* the u8x8 member is not used, u8x8 counts in u8g2->u8x8.stats */
+#endif
 };
 
 #define u8g2_GetU8x8(u8g2) ((u8x8_t *)(u8g2))
+
+/* internal: update a statistic counter, no code is generated without U8G2_WITH_STATS */
+#ifdef U8G2_WITH_STATS
+#define u8g2_stats_add(u8g2, counter, cnt) ((u8g2)->stats.counter += (cnt))
+#else
+#define u8g2_stats_add(u8g2, counter, cnt) ((void)0)
+#endif
 //#define u8g2_GetU8x8(u8g2) (&((u8g2)->u8x8))
 
 #ifdef U8X8_WITH_USER_PTR
@@ -463,6 +502,12 @@ void u8g2_SetDisplayRotation(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
 
 void u8g2_SendF(u8g2_t * u8g2, const char *fmt, ...);
 
+#ifdef U8G2_WITH_STATS
+/* copy u8g2 and u8x8 counters to "stats" (snapshot), counters are cleared by u8g2_SetupBuffer() and u8g2_ResetStats() */
+void u8g2_GetStats(u8g2_t *u8g2, u8g2_stats_t *stats);
+void u8g2_ResetStats(u8g2_t *u8g2);
+#endif
+
 /* null device setup */
 void u8g2_Setup_null(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
 
@@ -1590,6 +1635,8 @@ void u8g2_SetBufferCurrTileRow(u8g2_t *u8g2, uint8_t row) U8G2_NOINLINE;
 
 void u8g2_FirstPage(u8g2_t *u8g2);
 uint8_t u8g2_NextPage(u8g2_t *u8g2);
+/* render a canvas with arbitrary height band by band, e.g. for the A2 printer */
+void u8g2_DrawCanvas(u8g2_t *u8g2, uint16_t canvas_height, void (*draw_cb)(u8g2_t *u8g2, uint16_t y));
 
 // Add ability to set buffer pointer
 #ifdef __ARM_LINUX__
@@ -1611,6 +1658,10 @@ uint8_t u8g2_NextPage(u8g2_t *u8g2);
 void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, uint8_t th);
 void u8g2_UpdateDisplay(u8g2_t *u8g2);
 
+/* full buffer only: move the buffer up by tile_rows, u8g2_SendScroll() will use the display start line, if available */
+void u8g2_ScrollUp(u8g2_t *u8g2, uint8_t tile_rows);
+void u8g2_SendScroll(u8g2_t *u8g2);
+
 void u8g2_WriteBufferPBM(u8g2_t *u8g2, void (*out)(const char *s));
 void u8g2_WriteBufferXBM(u8g2_t *u8g2, void (*out)(const char *s));
 /* SH1122, LD7032, ST7920, ST7986, LC7981, T6963, SED1330, RA8835, MAX7219, LS0 */ 
@@ -1815,6 +1866,8 @@ uint8_t u8g2_UserInterfaceInputValue(u8g2_t *u8g2, const char *title, const char
 void u8g2_SetupBuffer_SDL_128x64(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
 void u8g2_SetupBuffer_SDL_128x64_4(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
 void u8g2_SetupBuffer_SDL_128x64_1(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
+void u8g2_SetupBuffer_SDL_240x160(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb);
+void u8g2_SetupBuffer_SDL(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, uint16_t pixel_width, uint16_t pixel_height);
 
 /*==========================================*/
 /* u8x8_d_tga.c */
@@ -1829,6 +1882,14 @@ void u8g2_SetupBitmap(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, uint16_t pixel_wid
 /* u8x8_d_framebuffer.c */
 void u8g2_SetupLinuxFb(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *fb_device);
 
+/*==========================================*/
+/* u8x8_d_shm.c */
+uint8_t u8g2_SetupShm(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *name, uint16_t pixel_width, uint16_t pixel_height, uint8_t frame_cnt);
+
+/*==========================================*/
+/* u8x8_d_record.c */
+uint8_t u8g2_SetupRecord(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *filename, uint16_t pixel_width, uint16_t pixel_height, uint16_t keyframe_interval);
+
 
 /*==========================================*/
 /* u8x8_d_utf8.c */
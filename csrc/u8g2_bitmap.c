@@ -63,9 +63,11 @@ void u8g2_DrawHorizontalBitmap(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_
   {
     if ( *b & mask ) {
       u8g2->draw_color = color;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     } else if ( u8g2->bitmap_transparency == 0 ) {
       u8g2->draw_color = ncolor;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     }
 
@@ -118,9 +120,11 @@ void u8g2_DrawHXBM(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len,
   while(len > 0) {
     if ( *b & mask ) {
       u8g2->draw_color = color;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     } else if ( u8g2->bitmap_transparency == 0 ) {
       u8g2->draw_color = ncolor;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     }
     x++;
@@ -176,9 +180,11 @@ void u8g2_DrawHXBMP(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t len,
   {
     if( u8x8_pgm_read(b) & mask ) {
       u8g2->draw_color = color;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     } else if( u8g2->bitmap_transparency == 0 ) {
       u8g2->draw_color = ncolor;
+      u8g2_stats_add(u8g2, bitmap_pixels, 1);
       u8g2_DrawHVLine(u8g2, x, y, 1, 0);
     }
    
@@ -48,45 +48,56 @@ void u8g2_ClearBuffer(u8g2_t *u8g2)
 
 /*============================================*/
 
-static void u8g2_send_tile_row(u8g2_t *u8g2, uint8_t src_tile_row, uint8_t dest_tile_row)
-{
-  uint8_t *ptr;
-  uint16_t offset;
-  uint8_t w;
-  
-  w = u8g2_GetU8x8(u8g2)->display_info->tile_width;
-  offset = src_tile_row;
-  ptr = u8g2->tile_buf_ptr;
-  offset *= w;
-  offset *= 8;
-  ptr += offset;
-  u8x8_DrawTile(u8g2_GetU8x8(u8g2), 0, dest_tile_row, w, ptr);
-}
-
 /* 
   write the buffer to the display RAM. 
   For most displays, this will make the content visible to the user.
   Some displays (like the SSD1606) require a u8x8_RefreshDisplay()
 */
+/*
+  send tile rows of the buffer, starting with buffer row "src_row".
+  With hardware scroll, tile row 0 of the buffer is located at display RAM 
+  row start_line/8 (see u8x8_SetDisplayStartLine()), so the rows might be 
+  sent in two parts.
+*/
+static void u8g2_send_rows(u8g2_t *u8g2, uint8_t src_row, uint8_t rows) U8X8_NOINLINE;
+static void u8g2_send_rows(u8g2_t *u8g2, uint8_t src_row, uint8_t rows)
+{
+  uint8_t tile_width = u8g2_GetU8x8(u8g2)->display_info->tile_width;
+  uint8_t dest_max = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  uint8_t *ptr = u8g2->tile_buf_ptr;
+  uint8_t dest_row;
+  uint8_t cnt;
+  
+  ptr += (size_t)(src_row - u8g2->tile_curr_row)*tile_width*8;
+  dest_row = src_row + (u8g2_GetU8x8(u8g2)->start_line >> 3);
+  if ( dest_row >= dest_max )
+    dest_row -= dest_max;
+  while( rows > 0 )
+  {
+    cnt = rows;
+    if ( cnt > dest_max - dest_row )
+      cnt = dest_max - dest_row;
+    /* all rows with one U8X8_MSG_DISPLAY_DRAW_FRAME, if supported by the display */
+    u8x8_DrawTileRows(u8g2_GetU8x8(u8g2), 0, dest_row, tile_width, cnt, ptr);
+    ptr += (size_t)cnt*tile_width*8;
+    rows -= cnt;
+    dest_row = 0;
+  }
+}
+
 static void u8g2_send_buffer(u8g2_t *u8g2) U8X8_NOINLINE;
 static void u8g2_send_buffer(u8g2_t *u8g2)
 {
-  uint8_t src_row;
-  uint8_t src_max;
-  uint8_t dest_row;
+  uint8_t rows;
   uint8_t dest_max;
 
-  src_row = 0;
-  src_max = u8g2->tile_buf_height;
-  dest_row = u8g2->tile_curr_row;
+  rows = u8g2->tile_buf_height;
   dest_max = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  if ( rows > dest_max - u8g2->tile_curr_row )
+    rows = dest_max - u8g2->tile_curr_row;
   
-  do
-  {
-    u8g2_send_tile_row(u8g2, src_row, dest_row);
-    src_row++;
-    dest_row++;
-  } while( src_row < src_max && dest_row < dest_max );
+  u8g2_send_rows(u8g2, u8g2->tile_curr_row, rows);
+  u8g2->tile_scroll_pending = 0;	/* display is in sync with the buffer */
 }
 
 /* same as u8g2_send_buffer but also send the DISPLAY_REFRESH message (used by SSD1606) */
@@ -134,6 +145,51 @@ uint8_t u8g2_NextPage(u8g2_t *u8g2)
 
 
 
+/*============================================*/
+/*
+  Description:
+    Render a canvas, which is higher than the display (for example a 
+    receipt for the A2 printer). The canvas is split into sections with 
+    the height of the display. Each section is rendered with the page 
+    buffer (one tile row band after the other) and each band is sent as 
+    soon as it is complete. 
+    draw_cb is called for each band with the canvas position "y" of the 
+    first line of the current section: It must draw the canvas content
+    between y and y+u8g2_GetDisplayHeight() at y positions relative to y.
+    Use u8g2->user_y0/user_y1 or u8g2_IsIntersection() to skip objects 
+    outside of the current band.
+    Tile rows below canvas_height are not sent.
+*/
+void u8g2_DrawCanvas(u8g2_t *u8g2, uint16_t canvas_height, void (*draw_cb)(u8g2_t *u8g2, uint16_t y))
+{
+  uint16_t section_y = 0;
+  uint16_t canvas_rows = (canvas_height+7)/8;
+  uint8_t display_rows = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  uint8_t section_rows;
+  uint8_t row, rows;
+  
+  while( canvas_rows > 0 )
+  {
+    section_rows = display_rows;
+    if ( canvas_rows < section_rows )
+      section_rows = canvas_rows;
+    for( row = 0; row < section_rows; row += u8g2->tile_buf_height )
+    {
+      if ( u8g2->is_auto_page_clear )
+	u8g2_ClearBuffer(u8g2);
+      u8g2_SetBufferCurrTileRow(u8g2, row);
+      draw_cb(u8g2, section_y);
+      rows = u8g2->tile_buf_height;
+      if ( rows > section_rows - row )
+	rows = section_rows - row;
+      u8x8_DrawTileRows(u8g2_GetU8x8(u8g2), 0, row, u8g2_GetU8x8(u8g2)->display_info->tile_width, rows, u8g2->tile_buf_ptr);
+    }
+    canvas_rows -= section_rows;
+    section_y += (uint16_t)section_rows*8;
+  }
+  u8x8_RefreshDisplay( u8g2_GetU8x8(u8g2) );
+}
+
 /*============================================*/
 /*
   Description:
@@ -165,8 +221,11 @@ void u8g2_UpdateDisplayArea(u8g2_t *u8g2, uint8_t  tx, uint8_t ty, uint8_t tw, u
   ptr += tx*8;
   ptr += page_size*ty;
   
+  ty += u8g2_GetU8x8(u8g2)->start_line >> 3;
   while( th > 0 )
   {
+    if ( ty >= u8g2_GetU8x8(u8g2)->display_info->tile_height )
+      ty -= u8g2_GetU8x8(u8g2)->display_info->tile_height;
     u8x8_DrawTile( u8g2_GetU8x8(u8g2), tx, ty, tw, ptr );
     ptr += page_size;
     ty++;
@@ -180,6 +239,62 @@ void u8g2_UpdateDisplay(u8g2_t *u8g2)
   u8g2_send_buffer(u8g2);
 }
 
+/*============================================*/
+/*
+  Description:
+    Scroll the content of the buffer up by tile_rows (tile_rows*8 pixel)
+    and clear the tile rows at the bottom. The application should draw the 
+    new content into the cleared rows and call u8g2_SendScroll().
+    u8g2_SendScroll() will move the display start line and send only the 
+    cleared tile rows, if the display supports U8X8_MSG_DISPLAY_SET_START_LINE 
+    (SSD1306/SH1106 128x64). For all other displays the complete 
+    buffer is sent.
+
+  Limitations:
+    - Only available in full buffer mode (will not do anything in page mode)
+    - u8g2_InitDisplay() resets the display start line to 0, call 
+      u8g2_SendBuffer() afterwards
+*/
+void u8g2_ScrollUp(u8g2_t *u8g2, uint8_t tile_rows)
+{
+  uint8_t tile_height = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  size_t row_size = (size_t)u8g2_GetU8x8(u8g2)->display_info->tile_width*8;
+  
+  /* check, whether we are in full buffer mode */
+  if ( u8g2->tile_buf_height != tile_height )
+    return;
+  if ( tile_rows > tile_height )
+    tile_rows = tile_height;
+  memmove(u8g2->tile_buf_ptr, u8g2->tile_buf_ptr+row_size*tile_rows, row_size*(tile_height-tile_rows));
+  memset(u8g2->tile_buf_ptr+row_size*(tile_height-tile_rows), 0, row_size*tile_rows);
+  u8g2->tile_scroll_pending += tile_rows;
+  if ( u8g2->tile_scroll_pending > tile_height )
+    u8g2->tile_scroll_pending = tile_height;
+}
+
+void u8g2_SendScroll(u8g2_t *u8g2)
+{
+  uint8_t tile_height = u8g2_GetU8x8(u8g2)->display_info->tile_height;
+  uint8_t rows = u8g2->tile_scroll_pending;
+  uint8_t row;
+  
+  if ( rows == 0 )
+    return;
+  if ( rows < tile_height )
+  {
+    row = (u8g2_GetU8x8(u8g2)->start_line >> 3) + rows;
+    if ( row >= tile_height )
+      row -= tile_height;
+    if ( u8x8_SetDisplayStartLine(u8g2_GetU8x8(u8g2), row*8) != 0 )
+    {
+      u8g2_send_rows(u8g2, tile_height-rows, rows);
+      u8g2->tile_scroll_pending = 0;
+      return;
+    }
+  }
+  u8g2_send_buffer(u8g2);	/* software scroll */
+}
+
 
 /*============================================*/
 
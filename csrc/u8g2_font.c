@@ -687,6 +687,7 @@ int8_t u8g2_font_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
     /* reset local x/y position */
     decode->x = 0;
     decode->y = 0;
+    u8g2_stats_add(u8g2, glyphs_decoded, 1);
     
     /* decode glyph */
     for(;;)
@@ -697,6 +698,7 @@ int8_t u8g2_font_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
       {
 	u8g2_font_decode_len(u8g2, a, 0);
 	u8g2_font_decode_len(u8g2, b, 1);
+	u8g2_stats_add(u8g2, rle_runs, 2);
       } while( u8g2_font_decode_get_unsigned_bits(decode, 1) != 0 );
 
       if ( decode->y >= h )
@@ -749,6 +751,7 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
     /* reset local x/y position */
     decode->x = 0;
     decode->y = 0;
+    u8g2_stats_add(u8g2, glyphs_decoded, 1);
     
     /* decode glyph */
     for(;;)
@@ -759,6 +762,7 @@ int8_t u8g2_font_2x_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data)
       {
 	u8g2_font_2x_decode_len(u8g2, a, 0);
 	u8g2_font_2x_decode_len(u8g2, b, 1);
+	u8g2_stats_add(u8g2, rle_runs, 2);
       } while( u8g2_font_decode_get_unsigned_bits(decode, 1) != 0 );
 
       if ( decode->y >= h )
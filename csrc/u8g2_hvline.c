@@ -137,6 +137,8 @@ void u8g2_draw_hv_line_2dir(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, u8g2_uin
   /* transform to pixel buffer coordinates */
   y -= u8g2->pixel_curr_row;
   
+  u8g2_stats_add(u8g2, hvline_calls, 1);
+  u8g2_stats_add(u8g2, hvline_pixels, len);
   u8g2->ll_hvline(u8g2, x, y, len, dir);
 }
 
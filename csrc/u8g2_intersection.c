@@ -166,9 +166,21 @@ uint8_t u8g2_is_intersection_decision_tree(u8g2_uint_t a0, u8g2_uint_t a1, u8g2_
 uint8_t u8g2_IsIntersection(u8g2_t *u8g2, u8g2_uint_t x0, u8g2_uint_t y0, u8g2_uint_t x1, u8g2_uint_t y1)
 {
   if ( u8g2_is_intersection_decision_tree(u8g2->user_y0, u8g2->user_y1, y0, y1) == 0 )
+  {
+    u8g2_stats_add(u8g2, intersection_rejects, 1);
     return 0; 
+  }
   
+#ifdef U8G2_WITH_STATS
+  if ( u8g2_is_intersection_decision_tree(u8g2->user_x0, u8g2->user_x1, x0, x1) == 0 )
+  {
+    u8g2_stats_add(u8g2, intersection_rejects, 1);
+    return 0;
+  }
+  return 1;
+#else
   return u8g2_is_intersection_decision_tree(u8g2->user_x0, u8g2->user_x1, x0, x1);
+#endif
 }
 
 
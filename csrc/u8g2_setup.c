@@ -81,6 +81,7 @@ void u8g2_SetupBuffer(u8g2_t *u8g2, uint8_t *buf, uint8_t tile_buf_height, u8g2_
   u8g2->tile_buf_height = tile_buf_height;
   
   u8g2->tile_curr_row = 0;
+  u8g2->tile_scroll_pending = 0;
   
   u8g2->font_decode.is_transparent = 0; /* issue 443 */
   u8g2->bitmap_transparency = 0;
@@ -102,7 +103,36 @@ void u8g2_SetupBuffer(u8g2_t *u8g2, uint8_t *buf, uint8_t tile_buf_height, u8g2_
 #ifdef U8G2_WITH_FONT_ROTATION  
   u8g2->font_decode.dir = 0;
 #endif
+
+#ifdef U8G2_WITH_STATS
+  u8g2_ResetStats(u8g2);
+#endif
+}
+
+#ifdef U8G2_WITH_STATS
+/*
+  Copy the u8g2 and u8x8 statistic counters to "stats". The counters continue 
+  to count, use u8g2_ResetStats() to start a new measurement, e.g. before 
+  the picture loop of a new screen.
+*/
+void u8g2_GetStats(u8g2_t *u8g2, u8g2_stats_t *stats)
+{
+  *stats = u8g2->stats;
+  u8x8_GetStats(u8g2_GetU8x8(u8g2), &(stats->u8x8));
+}
+
+/* clear the u8g2 and the u8x8 counters */
+void u8g2_ResetStats(u8g2_t *u8g2)
+{
+  u8g2->stats.hvline_calls = 0;
+  u8g2->stats.hvline_pixels = 0;
+  u8g2->stats.intersection_rejects = 0;
+  u8g2->stats.glyphs_decoded = 0;
+  u8g2->stats.rle_runs = 0;
+  u8g2->stats.bitmap_pixels = 0;
+  u8x8_ResetStats(u8g2_GetU8x8(u8g2));
 }
+#endif /* U8G2_WITH_STATS */
 
 /*
   Usually the display rotation is set initially, but it could be done later also
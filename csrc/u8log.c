@@ -63,26 +63,64 @@ static void u8log_clear_screen(u8log_t *u8log)
   
 }
 
+/* mark terminal line y for the next redraw */
+static void u8log_mark_dirty(u8log_t *u8log, uint8_t y)
+{
+  if ( u8log->dirty_first > u8log->dirty_last )
+  {
+    u8log->dirty_first = y;
+    u8log->dirty_last = y;
+  }
+  else if ( y < u8log->dirty_first )
+    u8log->dirty_first = y;
+  else if ( y > u8log->dirty_last )
+    u8log->dirty_last = y;
+}
 
-/* scroll the content of the complete buffer, set redraw_line to 255 */
+uint8_t *u8log_GetLine(u8log_t *u8log, uint8_t y)
+{
+  uint16_t line = u8log->head;
+  line += y;
+  if ( line >= u8log->height )
+    line -= u8log->height;
+  return u8log->screen_buffer + line * u8log->width;
+}
+
+static void u8log_clear_dirty(u8log_t *u8log)
+{
+  u8log->dirty_first = 255;
+  u8log->dirty_last = 0;
+  u8log->scroll_cnt = 0;
+}
+
+/* 
+  scroll the content of the terminal: The first line becomes the new 
+  (empty) last line of the circular buffer.
+*/
 static void u8log_scroll_up(u8log_t *u8log)
 {
-  uint8_t *dest = u8log->screen_buffer;
-  uint8_t *src = dest+u8log->width;
-  uint16_t cnt = u8log->height;
-  cnt--;
-  cnt *= u8log->width;
-  do
-  {
-    *dest++ = *src++;
-    cnt--;
-  } while( cnt > 0 );
-  cnt = u8log->width;
+  uint8_t *dest = u8log->screen_buffer + u8log->head * u8log->width;
+  uint8_t cnt = u8log->width;
   do
   {
     *dest++ = ' ';
     cnt--;
   } while(cnt > 0);
+  u8log->head++;
+  if ( u8log->head >= u8log->height )
+    u8log->head = 0;
+  
+  /* dirty lines move up together with the content */
+  if ( u8log->dirty_first <= u8log->dirty_last )
+  {
+    if ( u8log->dirty_first > 0 )
+      u8log->dirty_first--;
+    if ( u8log->dirty_last > 0 )
+      u8log->dirty_last--;
+  }
+  u8log_mark_dirty(u8log, u8log->height-1);
+  if ( u8log->scroll_cnt < 255 )
+    u8log->scroll_cnt++;
   
   if ( u8log->is_redraw_line_for_each_char )
     u8log->is_redraw_all = 1;
@@ -114,7 +152,8 @@ static void u8log_cursor_on_screen(u8log_t *u8log)
 static void u8log_write_to_screen(u8log_t *u8log, uint8_t c)
 {
   u8log_cursor_on_screen(u8log);
-  u8log->screen_buffer[u8log->cursor_y * u8log->width + u8log->cursor_x] = c;
+  u8log_GetLine(u8log, u8log->cursor_y)[u8log->cursor_x] = c;
+  u8log_mark_dirty(u8log, u8log->cursor_y);
   u8log->cursor_x++;
   
   if ( u8log->is_redraw_line_for_each_char )
@@ -158,6 +197,8 @@ void u8log_write_char(u8log_t *u8log, uint8_t c)
       break;
     case '\f':	// 12
       u8log_clear_screen(u8log);
+      u8log->dirty_first = 0;
+      u8log->dirty_last = u8log->height-1;
       u8log->is_redraw_all = 1;
       u8log->cursor_x = 0;
       u8log->cursor_y = 0;
@@ -175,6 +216,7 @@ void u8log_Init(u8log_t *u8log, uint8_t width, uint8_t height, uint8_t *buf)
   u8log->height = height;
   u8log->screen_buffer = buf;
   u8log_clear_screen(u8log);
+  u8log_clear_dirty(u8log);
 }
 
 void u8log_SetCallback(u8log_t *u8log, u8log_cb cb, void *aux_data)
@@ -207,6 +249,7 @@ void u8log_WriteChar(u8log_t *u8log, uint8_t c)
     }
     u8log->is_redraw_line = 0;
     u8log->is_redraw_all = 0;
+    u8log_clear_dirty(u8log);
   }
 }
 
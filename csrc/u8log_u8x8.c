@@ -40,11 +40,10 @@ static void u8x8_DrawLogLine(u8x8_t *u8x8, uint8_t disp_x, uint8_t disp_y, uint8
 static void u8x8_DrawLogLine(u8x8_t *u8x8, uint8_t disp_x, uint8_t disp_y, uint8_t buf_y, u8log_t *u8log)
 {
   uint8_t buf_x;
-  uint8_t c;
+  uint8_t *line = u8log_GetLine(u8log, buf_y);
   for( buf_x = 0; buf_x < u8log->width; buf_x++ )
   {
-    c = u8log->screen_buffer[buf_y * u8log->width + buf_x];
-    u8x8_DrawGlyph(u8x8, disp_x, disp_y, c);
+    u8x8_DrawGlyph(u8x8, disp_x, disp_y, line[buf_x]);
     disp_x++;
   }
 }
@@ -59,17 +58,42 @@ void u8x8_DrawLog(u8x8_t *u8x8, uint8_t x, uint8_t y, u8log_t *u8log)
   }
 }
 
-
+/*
+  Redraw the changed lines only.
+  If the terminal has the same height as the display, scrolling is done 
+  with the display start line (u8x8_SetDisplayStartLine()), if supported:
+  Each line is drawn at its position in the circular buffer and the start 
+  line points to the first line of the terminal. Only the new line must 
+  be drawn after a scroll.
+*/
 void u8log_u8x8_cb(u8log_t * u8log)
 {
   u8x8_t *u8x8 = (u8x8_t *)(u8log->aux_data);
-  if ( u8log->is_redraw_all )
+  uint8_t y, disp_y;
+  
+  if ( u8log->scroll_cnt > 0 )
   {
-    u8x8_DrawLog(u8x8, 0, 0, u8log);
+    u8log->is_hw_scroll = 0;
+    if ( u8log->height == u8x8_GetRows(u8x8) )
+      u8log->is_hw_scroll = u8x8_SetDisplayStartLine(u8x8, u8log->head*8);
+    if ( u8log->is_hw_scroll == 0 || u8log->scroll_cnt >= u8log->height )
+    {
+      /* all lines have been moved */
+      u8log->dirty_first = 0;
+      u8log->dirty_last = u8log->height-1;
+    }
   }
-  else if ( u8log->is_redraw_line )
+  
+  for( y = u8log->dirty_first; y <= u8log->dirty_last && y < u8log->height; y++ )
   {
-    u8x8_DrawLogLine(u8x8, 0, u8log->redraw_line, u8log->redraw_line, u8log);
+    disp_y = y;
+    if ( u8log->is_hw_scroll )
+    {
+      disp_y += u8log->head;
+      if ( disp_y >= u8log->height )
+	disp_y -= u8log->height;
+    }
+    u8x8_DrawLogLine(u8x8, 0, disp_y, y, u8log);
   }
 }
 
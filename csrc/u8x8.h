@@ -96,6 +96,27 @@
 /* Define this for an additional user pointer inside the u8x8 data struct */
 //#define U8X8_WITH_USER_PTR
 
+/* 
+  Define this for the statistic counters inside the u8x8 data struct, see u8x8_GetStats().
+  This is also enabled by U8G2_WITH_STATS. The macro must be defined for all files,
+  e.g. with -DU8G2_WITH_STATS. Without this macro, the counters do not use any code or memory.
+*/
+//#define U8X8_WITH_STATS
+#if defined(U8G2_WITH_STATS) && !defined(U8X8_WITH_STATS)
+#define U8X8_WITH_STATS
+#endif
+
+/* Size of the static row buffer for the 4 bit gray scale controller (SSD1322, SSD1327, SSD1362). */
+/* A tile requires 32 bytes (64 bytes for SSD1322 with doubled pixels), the minimum is 64. */
+/* This buffer is shared by all displays, use u8x8_SetDisplayMemory() with */
+/* U8X8_GRAY4_MEM_SIZE() bytes to transfer a tile row with one column window. */
+#ifndef U8X8_GRAY4_BUF_SIZE
+#define U8X8_GRAY4_BUF_SIZE 64
+#endif
+#if U8X8_GRAY4_BUF_SIZE < 64
+#error "U8X8_GRAY4_BUF_SIZE must be 64 or more"
+#endif
+
 
 /* Undefine this to remove u8x8_SetFlipMode function */
 /* 26 May 2016: Obsolete */
@@ -339,6 +360,18 @@ struct u8x8_display_info_struct
 #define U8X8_PIN_NONE 255
 #endif
 
+#ifdef U8X8_WITH_STATS
+/* statistic counters, see u8x8_GetStats() */
+struct _u8x8_stats_t
+{
+  uint32_t draw_tile_calls;	/* number of U8X8_MSG_DISPLAY_DRAW_TILE messages */
+  uint32_t tiles_sent;		/* number of tiles, also includes tiles of U8X8_MSG_DISPLAY_DRAW_FRAME */
+  uint32_t cad_cmds;		/* number of command bytes, sent by the u8x8_cad_Send procedures */
+  uint32_t cad_data_bytes;	/* number of data bytes, sent by u8x8_cad_SendData() */
+};
+typedef struct _u8x8_stats_t u8x8_stats_t;
+#endif
+
 struct u8x8_struct
 {
   const u8x8_display_info_t *display_info;
@@ -356,6 +389,7 @@ struct u8x8_struct
 					/* i2c_address is the address for writing data to the display */
 					/* usually, the lowest bit must be zero for a valid address */
   uint8_t i2c_started;	/* for i2c interface */
+  uint8_t cad_state;	/* transfer state of the i2c cad procedures (U8X8_CAD_IN_TRANSFER, U8X8_CAD_IS_DATA) */
   //uint8_t device_address;	/* OBSOLETE???? - this is the device address, replacement for U8X8_MSG_CAD_SET_DEVICE */
   uint8_t utf8_state;		/* number of chars which are still to scan */
   uint8_t gpio_result;	/* return value from the gpio call (only for MENU keys at the moment) */ 
@@ -363,9 +397,16 @@ struct u8x8_struct
   uint8_t debounce_last_pin_state;
   uint8_t debounce_state;
   uint8_t debounce_result_msg;	/* result msg or event after debounce */
+  void *display_mem;		/* optional memory for the display procedure (refresh state, shadow RAM), see u8x8_SetDisplayMemory() */
+  uint16_t display_mem_size;	/* size of display_mem in bytes, 0 if not available */
+  uint8_t display_flags;	/* state bits of the display procedure, e.g. VCOM of the Sharp memory LCD */
+  uint8_t start_line;		/* display RAM line shown at the top, see u8x8_SetDisplayStartLine(), reset by u8x8_d_helper_display_init() */
 #ifdef U8X8_WITH_USER_PTR
   void *user_ptr;
 #endif
+#ifdef U8X8_WITH_STATS
+  u8x8_stats_t stats;
+#endif
 #ifdef U8X8_USE_PINS 
   uint8_t pins[U8X8_PIN_CNT];	/* defines a pinlist: Mainly a list of pins for the Arduino Environment, use U8X8_PIN_xxx to access */
 #endif
@@ -376,6 +417,13 @@ struct u8x8_struct
 #define u8x8_SetUserPtr(u8x8, p) ((u8x8)->user_ptr = (p))
 #endif
 
+/* internal: update a statistic counter, no code is generated without U8X8_WITH_STATS */
+#ifdef U8X8_WITH_STATS
+#define u8x8_stats_add(u8x8, counter, cnt) ((u8x8)->stats.counter += (cnt))
+#else
+#define u8x8_stats_add(u8x8, counter, cnt) ((void)0)
+#endif
+
 
 #define u8x8_GetCols(u8x8) ((u8x8)->display_info->tile_width)
 #define u8x8_GetRows(u8x8) ((u8x8)->display_info->tile_height)
@@ -427,6 +475,12 @@ struct u8log_struct
   uint8_t is_redraw_line;
   uint8_t is_redraw_all;
   uint8_t is_redraw_all_required_for_next_nl; /* in nl mode, redraw all instead of current line */
+  
+  /* the screen buffer is a circular list of lines, use u8log_GetLine() */
+  uint8_t head;			/* buffer line, which is shown in the first line of the terminal */
+  uint8_t dirty_first, dirty_last;	/* terminal lines, which have changed, nothing changed if dirty_first > dirty_last */
+  uint8_t scroll_cnt;		/* number of scrolled lines since the last redraw */
+  uint8_t is_hw_scroll;	/* u8log_u8x8_cb: lines are drawn at their buffer position, display start line follows head */
 };
 
 
@@ -435,6 +489,28 @@ struct u8log_struct
 /* helper functions */
 void u8x8_d_helper_display_setup_memory(u8x8_t *u8x8, const u8x8_display_info_t *display_info);
 void u8x8_d_helper_display_init(u8x8_t *u8g2);
+uint8_t u8x8_d_helper_ssd1306_draw_frame(u8x8_t *u8x8, uint8_t rows, u8x8_tile_t *tile, uint8_t addr_mode, uint8_t tile_cmd_cnt);
+
+/* u8x8_gray4.c */
+uint8_t u8x8_d_helper_gray4_max_tiles(u8x8_t *u8x8, uint8_t bytes_per_tile);
+void u8x8_d_helper_gray4_send_tiles(u8x8_t *u8x8, uint8_t *ptr, uint8_t width, uint8_t is_narrow);
+
+/* u8x8_epaper.c, partial refresh manager for SSD1607 and IL3820 */
+#define U8X8_EPAPER_MAX_ROWS 40
+typedef struct u8x8_epaper_struct u8x8_epaper_t;
+struct u8x8_epaper_struct
+{
+  uint8_t state[U8X8_EPAPER_MAX_ROWS];
+  uint8_t partial_limit;	/* 0: manager disabled */
+  uint8_t area_percent;
+  uint8_t partial_cnt;	/* number of partial refreshes since the last full refresh */
+  uint8_t is_partial_lut;	/* 1: the partial update LUT might be loaded */
+};
+void u8x8_d_helper_epaper_init(u8x8_t *u8x8);
+uint8_t u8x8_d_helper_epaper_draw_tile(u8x8_t *u8x8, uint8_t arg_int, u8x8_tile_t *tile);
+uint8_t u8x8_d_helper_epaper_refresh(u8x8_t *u8x8, const uint8_t *full_lut_seq);
+/* memory size for u8x8_SetEPaperPartialRefresh(): state and a copy of all tile rows */
+#define U8X8_EPAPER_MEM_SIZE(pixel_width, pixel_height) (sizeof(u8x8_epaper_t) + (uint16_t)(((pixel_width)+7)/8)*8*(((pixel_height)+7)/8))
 
 /* Display Interface */
 
@@ -533,6 +609,111 @@ void u8x8_d_helper_display_init(u8x8_t *u8g2);
 */
 #define U8X8_MSG_DISPLAY_REFRESH 16
 
+/*
+  Name: 	U8X8_MSG_DISPLAY_DRAW_FRAME
+  Args:	
+    arg_int: Number of tile rows
+    arg_ptr: pointer to u8x8_tile_t
+        uint8_t *tile_ptr;	pointer to arg_int rows of tiles
+	uint8_t cnt;		number of tiles in each row
+	uint8_t x_pos;		first tile x position
+	uint8_t y_pos;		first tile row
+  Tasks:
+    Optional message: Draw arg_int rows with one address setup. The 
+    memory layout is the same as for U8X8_MSG_DISPLAY_DRAW_TILE, rows follow 
+    each other with cnt*8 bytes per row.
+    The display procedure must set "cnt" to 0 if the message was handled.
+    Otherwise the rows are sent with U8X8_MSG_DISPLAY_DRAW_TILE (many 
+    display procedures return 1 for unknown messages, so the return value 
+    can not be used for this). A display procedure may also leave "cnt"
+    unchanged if U8X8_MSG_DISPLAY_DRAW_TILE requires less bytes, for 
+    example for a single page.
+  Use
+    void u8x8_DrawTileRows(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr)
+  to send the message to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_DRAW_FRAME 17
+
+/*
+  Name: 	U8X8_MSG_DISPLAY_TOGGLE_VCOM
+  Args:	
+    arg_int: -
+    arg_ptr: -
+  
+  Sharp memory LCDs require a periodic inversion of VCOM (about 1 Hz).
+  If EXTMODE is low, this message will toggle the VCOM bit with a short
+  display mode command. Other display procedures ignore this message.
+  Use
+    void u8x8_ToggleVCOM(u8x8_t *u8x8)
+  to send the message to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_TOGGLE_VCOM 18
+
+/*
+  Name: 	U8X8_MSG_DISPLAY_SET_TEXT_LAYER
+  Args:	
+    arg_int: 0: graphics only, 1: text layer on top of the graphics (OR)
+    arg_ptr: -
+  
+  Optional message for controllers with a character generator (T6963, 
+  SED1330). The text RAM is placed behind the graphics RAM and is cleared 
+  if the text layer is enabled. Other display procedures ignore this message.
+  Use
+    void u8x8_SetTextLayer(u8x8_t *u8x8, uint8_t is_enable)
+  to send the message to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_SET_TEXT_LAYER 19
+
+/*
+  Name: 	U8X8_MSG_DISPLAY_DRAW_TEXT
+  Args:	
+    arg_int: -
+    arg_ptr: pointer to u8x8_tile_t
+        uint8_t *tile_ptr;	pointer to cnt character codes (one byte per cell)
+	uint8_t cnt;		number of characters
+	uint8_t x_pos;		first tile x position
+	uint8_t y_pos;		tile row
+  Tasks:
+    Optional message: Write character codes into the text RAM. Codes 
+    0x20..0x7f are ASCII (internal character generator), codes 0x80..0x9f
+    show the glyphs loaded with U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH.
+    The display procedure must set "cnt" to 0 if the message was handled.
+  Use
+    uint8_t u8x8_DrawTextLayer(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *codes)
+  to send the message to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_DRAW_TEXT 20
+
+/*
+  Name: 	U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH
+  Args:	
+    arg_int: character code 0x80..0x9f
+    arg_ptr: pointer to 8 bytes, one byte per pixel row, MSB is the left pixel
+  
+  Optional message: Upload a glyph into the CG RAM of the controller.
+  Use
+    void u8x8_LoadTextLayerGlyph(u8x8_t *u8x8, uint8_t code, uint8_t encoding)
+  to send a glyph of the current u8x8 font to the display handler.
+*/
+#define U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH 21
+
+/*
+  Name: 	U8X8_MSG_DISPLAY_SET_START_LINE
+  Args:	
+    arg_int: display RAM line, which is shown at the top of the display
+    arg_ptr: pointer to uint8_t, must be set to 1 by the display procedure
+  
+  Optional message for controllers with a display start line register 
+  (SSD1306/SH1106 128x64). The content of the display RAM is rotated 
+  vertically, which allows hardware scrolling, see u8g2_ScrollUp().
+  The display procedure stores the line in u8x8->start_line, 
+  u8x8_d_helper_display_init() resets it to 0.
+  Use
+    uint8_t u8x8_SetDisplayStartLine(u8x8_t *u8x8, uint8_t line)
+  to send the message to the display handler. 
+*/
+#define U8X8_MSG_DISPLAY_SET_START_LINE 22
+
 /*==========================================*/
 /* u8x8_setup.c */
 
@@ -548,9 +729,16 @@ void u8x8_SetupDefaults(u8x8_t *u8x8); /* do not use this, use u8x8_Setup() inst
 
 void u8x8_Setup(u8x8_t *u8x8, u8x8_msg_cb display_cb, u8x8_msg_cb cad_cb, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
 
+#ifdef U8X8_WITH_STATS
+/* copy the current statistic counters to "stats" (snapshot), counters are cleared by u8x8_Setup() and u8x8_ResetStats() */
+void u8x8_GetStats(u8x8_t *u8x8, u8x8_stats_t *stats);
+void u8x8_ResetStats(u8x8_t *u8x8);
+#endif
+
 /*==========================================*/
 /* u8x8_display.c */
 uint8_t u8x8_DrawTile(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *tile_ptr);
+void u8x8_DrawTileRows(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr);
 
 /* 
   After a call to u8x8_SetupDefaults, 
@@ -583,6 +771,24 @@ void u8x8_ClearDisplayWithTile(u8x8_t *u8x8, const uint8_t *buf)  U8X8_NOINLINE;
 void u8x8_ClearDisplay(u8x8_t *u8x8);	// this does not work for u8g2 in some cases
 void u8x8_FillDisplay(u8x8_t *u8x8);
 void u8x8_RefreshDisplay(u8x8_t *u8x8);	// make RAM content visible on the display (Dec 16: SSD1606 only)
+/* SSD1607/IL3820: Use the partial update LUT for small changes, mem = NULL disables this (default), see u8x8_epaper.c */
+void u8x8_SetEPaperPartialRefresh(u8x8_t *u8x8, void *mem, uint16_t size, uint8_t partial_limit, uint8_t area_percent);
+/* provide memory to the display procedure, call before u8x8_InitDisplay(), see u8x8_display.c */
+void u8x8_SetDisplayMemory(u8x8_t *u8x8, void *mem, uint16_t size);
+void u8x8_ToggleVCOM(u8x8_t *u8x8);	// Sharp memory LCD: invert VCOM, call this about once per second
+/* Sharp memory LCD: memory size for u8x8_SetDisplayMemory(), only changed lines are transfered */
+#define U8X8_LS013B7DH03_MEM_SIZE(pixel_width, pixel_height) (((pixel_height)+7)/8 + (uint16_t)(pixel_height)*((pixel_width)/8))
+/* ST7920: memory size for u8x8_SetDisplayMemory(), only changed words are transfered */
+#define U8X8_ST7920_MEM_SIZE 1088
+/* SSD1322/SSD1327/SSD1362: memory size for u8x8_SetDisplayMemory(), one column window per tile row */
+/* column_cnt: number of controller columns (256 for SSD1322, also for the NHD 128x64 with doubled pixels) */
+#define U8X8_GRAY4_MEM_SIZE(column_cnt) ((uint16_t)(column_cnt)*4)
+/* MAX7219: memory size for u8x8_SetDisplayMemory(), unchanged rows and modules are skipped */
+#define U8X8_MAX7219_MEM_SIZE(modules) (1+8*(modules))
+/* T6963/SED1330: Show the text RAM on top of the graphics */
+void u8x8_SetTextLayer(u8x8_t *u8x8, uint8_t is_enable);
+uint8_t u8x8_DrawTextLayer(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *codes);	// returns 0 if the display has no text layer
+uint8_t u8x8_SetDisplayStartLine(u8x8_t *u8x8, uint8_t line);	// returns 0 if not supported by the display
 void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line);
 
 
@@ -612,10 +818,42 @@ void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line);
 //#define U8X8_MSG_CAD_SET_I2C_ADR 26
 //#define U8X8_MSG_CAD_SET_DEVICE 27
 
+/*
+  U8X8_MSG_CAD_SEND_RUN
+    arg_int: number of bytes in the run
+    arg_ptr: u8x8_cad_run_t
+  A sequence of commands and args, which can be sent together.
+  The cad procedure should use as few transfers as possible.
+  Bit i of cmd_mask is 1 if data[i] is a command, otherwise it is an arg.
+  The cad procedure must set "handled" to 1 if the run was sent. Otherwise
+  the caller will send each byte with U8X8_MSG_CAD_SEND_CMD or 
+  U8X8_MSG_CAD_SEND_ARG.
+*/
+#define U8X8_MSG_CAD_SEND_RUN 28
+
+typedef struct u8x8_cad_run_struct u8x8_cad_run_t;
+struct u8x8_cad_run_struct
+{
+  uint8_t *data;		/* command and arg bytes */
+  const uint8_t *cmd_mask;	/* one bit for each byte in data, 1: command, 0: arg */
+  uint8_t handled;		/* set to 1 by the cad procedure, if the run was sent */
+};
+
+#define u8x8_cad_IsRunCmd(run, i) (((run)->cmd_mask[(i)>>3] >> ((i)&7)) & 1)
+
+/* max number of bytes, which are collected by u8x8_cad_SendSequence() */
+#ifndef U8X8_CAD_RUN_MAX
+#define U8X8_CAD_RUN_MAX 32
+#endif
+
 
 
 /* u8g_cad.c */
 
+/* bits of u8x8->cad_state */
+#define U8X8_CAD_IN_TRANSFER 1
+#define U8X8_CAD_IS_DATA 2
+
 #define u8x8_cad_Init(u8x8) ((u8x8)->cad_cb((u8x8), U8X8_MSG_CAD_INIT, 0, NULL ))
 
 uint8_t u8x8_cad_SendCmd(u8x8_t *u8x8, uint8_t cmd) U8X8_NOINLINE;
@@ -624,6 +862,7 @@ uint8_t u8x8_cad_SendMultipleArg(u8x8_t *u8x8, uint8_t cnt, uint8_t arg) U8X8_NO
 uint8_t u8x8_cad_SendData(u8x8_t *u8x8, uint8_t cnt, uint8_t *data) U8X8_NOINLINE;
 uint8_t u8x8_cad_StartTransfer(u8x8_t *u8x8) U8X8_NOINLINE;
 uint8_t u8x8_cad_EndTransfer(u8x8_t *u8x8) U8X8_NOINLINE;
+uint8_t u8x8_cad_SendRun(u8x8_t *u8x8, uint8_t cnt, u8x8_cad_run_t *run) U8X8_NOINLINE;
 void u8x8_cad_vsendf(u8x8_t * u8x8, const char *fmt, va_list va);
 void u8x8_SendF(u8x8_t * u8x8, const char *fmt, ...);
 
@@ -654,6 +893,9 @@ void u8x8_SendF(u8x8_t * u8x8, const char *fmt, ...);
 #define U8X8_DLY(m)			(0xfe),(m)		/* delay in milli seconds */
 #define U8X8_END()			(0xff)
 
+/* number of cmd_mask bytes for a run of cnt commands and args */
+#define U8X8_CAD_RUN_MASK_SIZE(cnt)	(((cnt)+7)>>3)
+
 void u8x8_cad_SendSequence(u8x8_t *u8x8, uint8_t const *data);
 uint8_t u8x8_cad_empty(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_cad_110(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
@@ -727,6 +969,31 @@ uint8_t u8x8_byte_sed1520(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_
 /* delay of one i2c unit, should be 5us for 100K, and 1.25us for 400K */
 #define U8X8_MSG_DELAY_I2C		45
 
+/*
+  U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER
+  U8X8_MSG_GPIO_I2C_SHIFT_OUT_BUFFER
+  arg_ptr: u8x8_shift_out_t
+  Optional messages, sent by the software SPI and I2C byte procedures for a complete
+  buffer. The gpio_and_delay procedure may shift out the bytes with a native 
+  implementation. It must advance "data" and decrease "cnt" for all bytes, which
+  have been sent. Remaining bytes are sent bit by bit with the U8X8_MSG_GPIO_SPI_xxx
+  or U8X8_MSG_GPIO_I2C_xxx messages, so ignoring these messages is always valid.
+  SPI: MSB first, "bits" is 9 for the 3-wire SPI, the first bit is "dc" then.
+  I2C: SCL is low before and after the transfer, each byte is followed by 
+    a ninth (ACK) clock with SDA released.
+*/
+#define U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER	46
+#define U8X8_MSG_GPIO_I2C_SHIFT_OUT_BUFFER	47
+
+typedef struct u8x8_shift_out_struct u8x8_shift_out_t;
+struct u8x8_shift_out_struct
+{
+  uint8_t *data;
+  uint8_t cnt;
+  uint8_t bits;		/* 8 or 9 (3-wire SPI) */
+  uint8_t dc;		/* value of the first bit for 3-wire SPI */
+};
+
 #define U8X8_MSG_GPIO(x) (64+(x))
 #ifdef U8X8_USE_PINS 
 #define u8x8_GetPinIndex(u8x8, msg) ((msg)&0x3f)
@@ -800,6 +1067,10 @@ void u8x8_SetupStdio(u8x8_t *u8x8);
 /* u8x8_d_sdl_128x64.c */
 void u8x8_Setup_SDL_128x64(u8x8_t *u8x8);
 void u8x8_Setup_SDL_240x160(u8x8_t *u8x8);
+void u8x8_Setup_SDL(u8x8_t *u8x8, uint16_t pixel_width, uint16_t pixel_height);
+void u8g_sdl_set_fps(int fps);
+void u8g_sdl_set_scale(int scale);
+void u8g_sdl_flush(void);
 int u8g_sdl_get_key(void);
 
 /*==========================================*/
@@ -815,15 +1086,53 @@ void u8x8_SaveBitmapTGA(u8x8_t *u8x8, const char *filename);
 void u8x8_SetupBitmap(u8x8_t *u8x8, uint16_t pixel_width, uint16_t pixel_height);
 uint8_t u8x8_ConnectBitmapToU8x8(u8x8_t *u8x8);
 
+/*==========================================*/
+/* u8x8_emu.c */
+#define U8X8_EMU_SSD1306 1
+#define U8X8_EMU_SH1106 2
+#define U8X8_EMU_ST7565 3
+#define U8X8_EMU_ST7920 4
+#define U8X8_EMU_SSD1322 5
+#define U8X8_EMU_SPI 0
+#define U8X8_EMU_I2C 1
+uint8_t u8x8_byte_emu(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+uint8_t u8x8_gpio_and_delay_emu(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+void u8x8_ConnectEmu(u8x8_t *u8x8, uint8_t controller, uint8_t interface);
+void u8x8_ResetEmuStatistics(void);
+uint32_t u8x8_GetEmuByteCnt(void);
+uint32_t u8x8_GetEmuTransferCnt(void);
+uint32_t u8x8_GetEmuCmdCnt(void);
+uint32_t u8x8_GetEmuDataCnt(void);
+uint8_t u8x8_GetEmuPixel(u8x8_t *u8x8, uint16_t x, uint16_t y);
+void u8x8_SaveEmuPBM(u8x8_t *u8x8, const char *filename);
+
 /*==========================================*/
 /* u8x8_d_framebuffer.c */
-void u8x8_SetupLinuxFb(u8x8_t *u8x8, int fbfd);
-void u8x8_LinuxFbSetActiveColor(uint32_t color);
+uint8_t u8x8_SetupLinuxFb(u8x8_t *u8x8, int fbfd);
+void u8x8_LinuxFbSetActiveColor(u8x8_t *u8x8, uint32_t color);
+uint8_t u8x8_LinuxFbSetDoubleBuffer(u8x8_t *u8x8, uint8_t is_enable);
+void u8x8_LinuxFbClose(u8x8_t *u8x8);
+
+/*==========================================*/
+/* u8x8_d_shm.c */
+uint8_t u8x8_SetupShm(u8x8_t *u8x8, const char *name, uint16_t pixel_width, uint16_t pixel_height, uint8_t frame_cnt);
+void u8x8_CloseShm(u8x8_t *u8x8, uint8_t is_unlink);
+
+/*==========================================*/
+/* u8x8_d_record.c */
+uint8_t u8x8_SetupRecord(u8x8_t *u8x8, const char *filename, uint16_t pixel_width, uint16_t pixel_height, uint16_t keyframe_interval);
+uint8_t u8x8_CloseRecord(u8x8_t *u8x8);	// returns 0 if frames are missing in the recording
 
 /*==========================================*/
 /* u8x8_d_utf8.c */
 void u8x8_Setup_Utf8(u8x8_t *u8x8);	/* stdout UTF-8 display */
 void utf8_show(void);		/* show content of UTF-8 frame buffer */
+#define UTF8_TERM_OFF 0
+#define UTF8_TERM_QUADRANT 1
+#define UTF8_TERM_BRAILLE 2
+void utf8_term_set_mode(int mode);	/* UTF8_TERM_xxx, output with U8X8_MSG_DISPLAY_REFRESH */
+void utf8_term_reset(void);		/* write all cells with the next utf8_term_show() */
+size_t utf8_term_show(void);	/* write changed cells with ANSI escape sequences */
 
 
 /*==========================================*/
@@ -1053,6 +1362,10 @@ uint8_t u8x8_Draw2x2UTF8(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s);
 uint8_t u8x8_Draw1x2String(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s);
 uint8_t u8x8_Draw1x2UTF8(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s);
 uint8_t u8x8_GetUTF8Len(u8x8_t *u8x8, const char *s);
+/* text layer of T6963/SED1330, falls back to u8x8_DrawString() for other displays */
+uint8_t u8x8_DrawTextLayerString(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s);
+/* copy a 8x8 glyph of the current font into the CG RAM, code: 0x80..0x9f */
+void u8x8_LoadTextLayerGlyph(u8x8_t *u8x8, uint8_t code, uint8_t encoding);
 #define u8x8_SetInverseFont(u8x8, b) (u8x8)->is_font_inverse_mode = (b)
 
 /*==========================================*/
@@ -1120,6 +1433,41 @@ void u8x8_capture_write_xbm_buffer(uint8_t *buffer, uint8_t tile_width, uint8_t
 
 
 
+/*==========================================*/
+/* u8x8_trace.c */
+
+#define U8X8_TRACE_VERSION 2
+#define U8X8_TRACE_HEADER_SIZE 8
+#define U8X8_TRACE_RECORD_SIZE 6
+/* record type for a display message: U8X8_TRACE_DISPLAY|msg, byte messages use msg */
+#define U8X8_TRACE_DISPLAY 0x40
+/* record type for the end of a display message: U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|msg */
+#define U8X8_TRACE_DONE 0x80
+/* record type for u8x8_trace_MarkFrame() */
+#define U8X8_TRACE_FRAME 0x7f
+
+typedef struct u8x8_trace_struct u8x8_trace_t;
+
+struct u8x8_trace_struct
+{
+  u8x8_msg_cb byte_cb;		/* byte procedure, which is traced */
+  u8x8_msg_cb display_cb;	/* display procedure, which is traced */
+  uint32_t (*get_time)(void);	/* monotonic time, for example micro seconds, might be NULL */
+  void (*flush)(const uint8_t *data, uint16_t cnt);	/* called if buf is full, might be NULL */
+  uint8_t *buf;
+  uint16_t size;
+  uint16_t pos;			/* number of bytes in buf */
+  uint32_t dropped;		/* number of lost bytes, if buf is full and there is no flush procedure */
+};
+
+void u8x8_trace_Init(u8x8_trace_t *trace, uint8_t *buf, uint16_t size, uint32_t (*get_time)(void), void (*flush)(const uint8_t *data, uint16_t cnt));
+void u8x8_trace_Flush(u8x8_trace_t *trace);
+void u8x8_trace_MarkFrame(u8x8_trace_t *trace);
+uint8_t u8x8_byte_trace(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+uint8_t u8x8_d_trace(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+uint8_t u8x8_ConnectTrace(u8x8_t *u8x8, u8x8_trace_t *trace);
+void u8x8_DisconnectTrace(u8x8_t *u8x8);
+
 /*==========================================*/
 
 /* u8x8_input_value.c  */
@@ -1139,6 +1487,7 @@ void u8log_WriteHex16(u8log_t *u8log, uint16_t v);
 void u8log_WriteHex32(u8log_t *u8log, uint32_t v);
 void u8log_WriteDec8(u8log_t *u8log, uint8_t v, uint8_t d);
 void u8log_WriteDec16(u8log_t *u8log, uint16_t v, uint8_t d);
+uint8_t *u8log_GetLine(u8log_t *u8log, uint8_t y);	/* chars of terminal line y */
 
 /*==========================================*/
 /* u8log_u8x8.c */
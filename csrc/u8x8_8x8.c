@@ -355,26 +355,114 @@ uint16_t u8x8_utf8_next(u8x8_t *u8x8, uint8_t b)
 
 
 
-static uint8_t u8x8_draw_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s) U8X8_NOINLINE;
-static uint8_t u8x8_draw_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
+/* number of tiles, which are collected for one u8x8_DrawTile() call by the string procedures */
+#ifndef U8X8_STRING_TILE_BUF
+#if defined(__AVR__)
+#define U8X8_STRING_TILE_BUF 4
+#else
+#define U8X8_STRING_TILE_BUF 16
+#endif
+#endif
+
+/*
+  Draw a string with horizontal scale sx and vertical scale sy (1 or 2).
+  The glyphs are decoded into runs: All tiles of one tile row of a run
+  are sent with a single u8x8_DrawTile() call instead of one call per tile.
+  Glyphs wider than the tile buffer are drawn one by one.
+*/
+static uint8_t u8x8_draw_scaled_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s, uint8_t sx, uint8_t sy) U8X8_NOINLINE;
+static uint8_t u8x8_draw_scaled_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s, uint8_t sx, uint8_t sy)
 {
-  uint16_t e;
-  uint8_t cnt = 0;
+  uint8_t encoding[U8X8_STRING_TILE_BUF];
+  uint8_t buf[U8X8_STRING_TILE_BUF*8];
+  uint8_t glyph[8];
+  uint16_t e, t;
   uint8_t th = u8x8_pgm_read(u8x8->font+2);		/* new 2019 format */
-
+  uint8_t tv = u8x8_pgm_read(u8x8->font+3);	/* new 2019 format */
+  uint8_t tw, max, n, i, k, tr, hy, tc, yy;
+  uint8_t cnt = 0;
+  uint8_t *p;
+  
+  tw = th*sx;	/* tiles per glyph within one tile row */
+  max = U8X8_STRING_TILE_BUF / tw;
+  
   u8x8_utf8_init(u8x8);
   for(;;)
   {
-    e = u8x8->next_cb(u8x8, (uint8_t)*s);
-    if ( e == 0x0ffff )
+    /* collect the next run of glyphs */
+    n = 0;
+    for(;;)
+    {
+      e = u8x8->next_cb(u8x8, (uint8_t)*s);
+      if ( e == 0x0ffff )
+	break;
+      s++;
+      if ( e != 0x0fffe )
+      {
+	if ( max == 0 )
+	{
+	  if ( sx == 2 )
+	    u8x8_Draw2x2Glyph(u8x8, x, y, e);
+	  else if ( sy == 2 )
+	    u8x8_Draw1x2Glyph(u8x8, x, y, e);
+	  else
+	    u8x8_DrawGlyph(u8x8, x, y, e);
+	  x += tw;
+	  cnt++;
+	  continue;
+	}
+	encoding[n++] = e;
+	if ( n >= max )
+	  break;
+      }
+    }
+    if ( n == 0 )
       break;
-    s++;
-    if ( e != 0x0fffe )
+    
+    /* send the run, one u8x8_DrawTile() per tile row */
+    yy = y;
+    for( tr = 0; tr < tv; tr++ )
     {
-      u8x8_DrawGlyph(u8x8, x, y, e);
-      x+=th;
-      cnt++;
+      for( hy = 0; hy < sy; hy++ )
+      {
+	p = buf;
+	for( i = 0; i < n; i++ )
+	{
+	  for( tc = 0; tc < th; tc++ )
+	  {
+	    u8x8_get_glyph_data(u8x8, encoding[i], glyph, tr*th+tc);
+	    if ( sy == 2 )
+	    {
+	      for( k = 0; k < 8; k++ )
+	      {
+		t = u8x8_upscale_byte(glyph[k]);
+		if ( hy == 0 )
+		  glyph[k] = t & 255;
+		else
+		  glyph[k] = t >> 8;
+	      }
+	    }
+	    if ( sx == 2 )
+	    {
+	      u8x8_upscale_buf(glyph, p);
+	      u8x8_upscale_buf(glyph+4, p+8);
+	      p += 16;
+	    }
+	    else
+	    {
+	      for( k = 0; k < 8; k++ )
+		*p++ = glyph[k];
+	    }
+	  }
+	}
+	u8x8_DrawTile(u8x8, x, yy, n*tw, buf);
+	yy++;
+      }
     }
+    x += n*tw;
+    cnt += n;
+    if ( e == 0x0ffff )
+      break;
   }
   return cnt;
 }
@@ -383,92 +471,39 @@ static uint8_t u8x8_draw_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *
 uint8_t u8x8_DrawString(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_ascii_next;
-  return u8x8_draw_string(u8x8, x, y, s);
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 1, 1);
 }
 
 uint8_t u8x8_DrawUTF8(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_utf8_next;
-  return u8x8_draw_string(u8x8, x, y, s);
-}
-
-
-
-static uint8_t u8x8_draw_2x2_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s) U8X8_NOINLINE;
-static uint8_t u8x8_draw_2x2_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
-{
-  uint16_t e;
-  uint8_t cnt = 0;
-  uint8_t th = u8x8_pgm_read(u8x8->font+2);	/* new 2019 format */
-  
-  th <<= 1;
-  
-  u8x8_utf8_init(u8x8);
-  for(;;)
-  {
-    e = u8x8->next_cb(u8x8, (uint8_t)*s);
-    if ( e == 0x0ffff )
-      break;
-    s++;
-    if ( e != 0x0fffe )
-    {
-      u8x8_Draw2x2Glyph(u8x8, x, y, e);
-      x+=th;
-      cnt++;
-    }
-  }
-  return cnt;
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 1, 1);
 }
 
 
 uint8_t u8x8_Draw2x2String(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_ascii_next;
-  return u8x8_draw_2x2_string(u8x8, x, y, s);
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 2, 2);
 }
 
 uint8_t u8x8_Draw2x2UTF8(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_utf8_next;
-  return u8x8_draw_2x2_string(u8x8, x, y, s);
-}
-
-
-
-static uint8_t u8x8_draw_1x2_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s) U8X8_NOINLINE;
-static uint8_t u8x8_draw_1x2_string(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
-{  
-  uint16_t e;
-  uint8_t cnt = 0;
-  uint8_t th = u8x8_pgm_read(u8x8->font+2);	/* new 2019 format */
-  u8x8_utf8_init(u8x8);
-  for(;;)
-  {
-    e = u8x8->next_cb(u8x8, (uint8_t)*s);
-    if ( e == 0x0ffff )
-      break;
-    s++;
-    if ( e != 0x0fffe )
-    {
-      u8x8_Draw1x2Glyph(u8x8, x, y, e);
-      x+=th;
-      cnt++;
-    }
-  }
-  return cnt;
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 2, 2);
 }
 
 
 uint8_t u8x8_Draw1x2String(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_ascii_next;
-  return u8x8_draw_1x2_string(u8x8, x, y, s);
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 1, 2);
 }
 
 uint8_t u8x8_Draw1x2UTF8(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
 {
   u8x8->next_cb = u8x8_utf8_next;
-  return u8x8_draw_1x2_string(u8x8, x, y, s);
+  return u8x8_draw_scaled_string(u8x8, x, y, s, 1, 2);
 }
 
 
@@ -491,3 +526,51 @@ uint8_t u8x8_GetUTF8Len(u8x8_t *u8x8, const char *s)
 }
 
 
+
+/*
+  Text layer of T6963 and SED1330: Only the character codes (one byte per 
+  cell) are transfered. The internal character generator is used for 
+  ASCII, codes 0x80..0x9f are taken from the CG RAM, see u8x8_LoadTextLayerGlyph().
+  Other displays will draw the string with the current font.
+*/
+uint8_t u8x8_DrawTextLayerString(u8x8_t *u8x8, uint8_t x, uint8_t y, const char *s)
+{
+  uint8_t buf[16];
+  const char *start;
+  uint8_t cnt;
+  uint8_t total = 0;
+  
+  while( *s != '\0' )
+  {
+    start = s;
+    cnt = 0;
+    while( cnt < 16 && *s != '\0' )
+      buf[cnt++] = (uint8_t)*s++;
+    if ( u8x8_DrawTextLayer(u8x8, x, y, cnt, buf) == 0 )
+      return total + u8x8_DrawString(u8x8, x, y, start);
+    x += cnt;
+    total += cnt;
+  }
+  return total;
+}
+
+void u8x8_LoadTextLayerGlyph(u8x8_t *u8x8, uint8_t code, uint8_t encoding)
+{
+  uint8_t buf[8];
+  uint8_t rows[8];
+  uint8_t i, j, b;
+  
+  u8x8_get_glyph_data(u8x8, encoding, buf, 0);
+  /* tiles are vertical bytes (LSB on top), the CG RAM expects horizontal bytes (MSB left) */
+  for( i = 0; i < 8; i++ )
+  {
+    b = 0;
+    for( j = 0; j < 8; j++ )
+    {
+      b <<= 1;
+      b |= (buf[j] >> i) & 1;
+    }
+    rows[i] = b;
+  }
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH, code, (void *)rows);
+}
@@ -96,6 +96,7 @@ uint8_t u8x8_byte_empty(U8X8_UNUSED u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8
     U8X8_MSG_GPIO_CS
     U8X8_MSG_GPIO_CLOCK
     U8X8_MSG_GPIO_DATA
+    U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER (optional)
   Handles:
     U8X8_MSG_BYTE_INIT
     U8X8_MSG_BYTE_SEND
@@ -110,11 +111,19 @@ uint8_t u8x8_byte_4wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
   uint8_t *data;
   uint8_t takeover_edge = u8x8_GetSPIClockPhase(u8x8);
   uint8_t not_takeover_edge = 1 - takeover_edge;
+  u8x8_shift_out_t shift_out;
  
   switch(msg)
   {
     case U8X8_MSG_BYTE_SEND:
-      data = (uint8_t *)arg_ptr;
+      /* let the gpio procedure send the buffer, if supported */
+      shift_out.data = (uint8_t *)arg_ptr;
+      shift_out.cnt = arg_int;
+      shift_out.bits = 8;
+      shift_out.dc = 0;
+      u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER, 0, &shift_out);
+      data = shift_out.data;
+      arg_int = shift_out.cnt;
       while( arg_int > 0 )
       {
 	b = *data;
@@ -273,11 +282,18 @@ uint8_t u8x8_byte_3wire_sw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
   uint8_t not_takeover_edge = 1 - takeover_edge;
   uint16_t b;
   static uint8_t last_dc;
+  u8x8_shift_out_t shift_out;
  
   switch(msg)
   {
     case U8X8_MSG_BYTE_SEND:
-      data = (uint8_t *)arg_ptr;
+      shift_out.data = (uint8_t *)arg_ptr;
+      shift_out.cnt = arg_int;
+      shift_out.bits = 9;
+      shift_out.dc = last_dc;
+      u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER, 0, &shift_out);
+      data = shift_out.data;
+      arg_int = shift_out.cnt;
       while( arg_int > 0 )
       {
 	b = *data;
@@ -578,11 +594,19 @@ static void i2c_write_byte(u8x8_t *u8x8, uint8_t b)
 uint8_t u8x8_byte_sw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t *data;
+  u8x8_shift_out_t shift_out;
 
   switch(msg)
   {
     case U8X8_MSG_BYTE_SEND:
-      data = (uint8_t *)arg_ptr;
+      /* let the gpio procedure send the buffer, if supported */
+      shift_out.data = (uint8_t *)arg_ptr;
+      shift_out.cnt = arg_int;
+      shift_out.bits = 8;
+      shift_out.dc = 0;
+      u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_GPIO_I2C_SHIFT_OUT_BUFFER, 0, &shift_out);
+      data = shift_out.data;
+      arg_int = shift_out.cnt;
     
       while( arg_int > 0 )
       {
@@ -87,6 +87,7 @@ uint8_t u8x8_cad_template(u8x8_t *u8x8, uint8_t msg, uint16_t arg_int, void *arg
 
 uint8_t u8x8_cad_SendCmd(u8x8_t *u8x8, uint8_t cmd)
 {
+  u8x8_stats_add(u8x8, cad_cmds, 1);
   return u8x8->cad_cb(u8x8, U8X8_MSG_CAD_SEND_CMD, cmd, NULL);
 }
 
@@ -107,6 +108,7 @@ uint8_t u8x8_cad_SendMultipleArg(u8x8_t *u8x8, uint8_t cnt, uint8_t arg)
 
 uint8_t u8x8_cad_SendData(u8x8_t *u8x8, uint8_t cnt, uint8_t *data)
 {
+  u8x8_stats_add(u8x8, cad_data_bytes, cnt);
   return u8x8->cad_cb(u8x8, U8X8_MSG_CAD_SEND_DATA, cnt, data);
 }
 
@@ -120,6 +122,67 @@ uint8_t u8x8_cad_EndTransfer(u8x8_t *u8x8)
   return u8x8->cad_cb(u8x8, U8X8_MSG_CAD_END_TRANSFER, 0, NULL);
 }
 
+/*
+  send a run of commands and args, use U8X8_MSG_CAD_SEND_RUN if supported
+  by the cad procedure, otherwise send byte by byte
+*/
+uint8_t u8x8_cad_SendRun(u8x8_t *u8x8, uint8_t cnt, u8x8_cad_run_t *run)
+{
+  uint8_t i;
+  if ( cnt == 0 )
+    return 1;
+#ifdef U8X8_WITH_STATS
+  for( i = 0; i < cnt; i++ )
+    if ( u8x8_cad_IsRunCmd(run, i) )
+      u8x8_stats_add(u8x8, cad_cmds, 1);
+#endif
+  run->handled = 0;
+  u8x8->cad_cb(u8x8, U8X8_MSG_CAD_SEND_RUN, cnt, run);
+  if ( run->handled != 0 )
+    return 1;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( u8x8_cad_IsRunCmd(run, i) )
+      u8x8->cad_cb(u8x8, U8X8_MSG_CAD_SEND_CMD, run->data[i], NULL);
+    else
+      u8x8->cad_cb(u8x8, U8X8_MSG_CAD_SEND_ARG, run->data[i], NULL);
+  }
+  return 1;
+}
+
+/* return the number of bytes, starting at pos, which are all commands or all args */
+static uint8_t u8x8_cad_get_run_segment_len(u8x8_cad_run_t *run, uint8_t cnt, uint8_t pos)
+{
+  uint8_t is_cmd = u8x8_cad_IsRunCmd(run, pos);
+  uint8_t len = 1;
+  pos++;
+  while( pos < cnt && u8x8_cad_IsRunCmd(run, pos) == is_cmd )
+  {
+    pos++;
+    len++;
+  }
+  return len;
+}
+
+/* U8X8_MSG_CAD_SEND_RUN for the cad procedures, which only differ in the dc level */
+static uint8_t u8x8_cad_send_run_dc(u8x8_t *u8x8, uint8_t cnt, u8x8_cad_run_t *run, uint8_t cmd_dc, uint8_t arg_dc)
+{
+  uint8_t pos = 0;
+  uint8_t len;
+  while( pos < cnt )
+  {
+    if ( cmd_dc == arg_dc )
+      len = cnt - pos;
+    else
+      len = u8x8_cad_get_run_segment_len(run, cnt, pos);
+    u8x8_byte_SetDC(u8x8, u8x8_cad_IsRunCmd(run, pos) ? cmd_dc : arg_dc);
+    u8x8_byte_SendBytes(u8x8, len, run->data + pos);
+    pos += len;
+  }
+  run->handled = 1;
+  return 1;
+}
+
 void u8x8_cad_vsendf(u8x8_t * u8x8, const char *fmt, va_list va)
 {
   uint8_t d;
@@ -154,12 +217,19 @@ void u8x8_SendF(u8x8_t * u8x8, const char *fmt, ...)
   25			CS off
   254 milli	delay by milliseconds
   255		end of sequence
+
+  Consecutive commands and args are collected and sent with one 
+  U8X8_MSG_CAD_SEND_RUN message.
 */
 
 void u8x8_cad_SendSequence(u8x8_t *u8x8, uint8_t const *data)
 {
   uint8_t cmd;
   uint8_t v;
+  uint8_t cnt;
+  uint8_t buf[U8X8_CAD_RUN_MAX];
+  uint8_t mask[U8X8_CAD_RUN_MASK_SIZE(U8X8_CAD_RUN_MAX)];
+  u8x8_cad_run_t run;
 
   for(;;)
   {
@@ -169,9 +239,26 @@ void u8x8_cad_SendSequence(u8x8_t *u8x8, uint8_t const *data)
     {
       case U8X8_MSG_CAD_SEND_CMD:
       case U8X8_MSG_CAD_SEND_ARG:
-	  v = *data;
-	  u8x8->cad_cb(u8x8, cmd, v, NULL);
-	  data++;
+	  for( v = 0; v < U8X8_CAD_RUN_MASK_SIZE(U8X8_CAD_RUN_MAX); v++ )
+	    mask[v] = 0;
+	  cnt = 0;
+	  for(;;)
+	  {
+	    if ( cmd == U8X8_MSG_CAD_SEND_CMD )
+	      mask[cnt>>3] |= 1<<(cnt&7);
+	    buf[cnt] = *data;
+	    data++;
+	    cnt++;
+	    if ( cnt >= U8X8_CAD_RUN_MAX )
+	      break;
+	    cmd = *data;
+	    if ( cmd != U8X8_MSG_CAD_SEND_CMD && cmd != U8X8_MSG_CAD_SEND_ARG )
+	      break;
+	    data++;
+	  }
+	  run.data = buf;
+	  run.cmd_mask = mask;
+	  u8x8_cad_SendRun(u8x8, cnt, &run);
 	  break;
       case U8X8_MSG_CAD_SEND_DATA:
 	  v = *data;
@@ -193,7 +280,6 @@ void u8x8_cad_SendSequence(u8x8_t *u8x8, uint8_t const *data)
   }
 }
 
-
 uint8_t u8x8_cad_empty(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   switch(msg)
@@ -233,6 +319,8 @@ uint8_t u8x8_cad_110(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
       u8x8_byte_SetDC(u8x8, 1);
       u8x8_byte_SendByte(u8x8, arg_int);
       break;
+    case U8X8_MSG_CAD_SEND_RUN:
+      return u8x8_cad_send_run_dc(u8x8, arg_int, (u8x8_cad_run_t *)arg_ptr, 1, 1);
     case U8X8_MSG_CAD_SEND_DATA:
       u8x8_byte_SetDC(u8x8, 0);
       //u8x8_byte_SendBytes(u8x8, arg_int, arg_ptr);
@@ -312,6 +400,8 @@ uint8_t u8x8_cad_100(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
       u8x8_byte_SetDC(u8x8, 0);
       u8x8_byte_SendByte(u8x8, arg_int);
       break;
+    case U8X8_MSG_CAD_SEND_RUN:
+      return u8x8_cad_send_run_dc(u8x8, arg_int, (u8x8_cad_run_t *)arg_ptr, 1, 0);
     case U8X8_MSG_CAD_SEND_DATA:
       u8x8_byte_SetDC(u8x8, 0);
       //u8x8_byte_SendBytes(u8x8, arg_int, arg_ptr);
@@ -344,6 +434,8 @@ uint8_t u8x8_cad_001(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
       u8x8_byte_SetDC(u8x8, 0);
       u8x8_byte_SendByte(u8x8, arg_int);
       break;
+    case U8X8_MSG_CAD_SEND_RUN:
+      return u8x8_cad_send_run_dc(u8x8, arg_int, (u8x8_cad_run_t *)arg_ptr, 0, 0);
     case U8X8_MSG_CAD_SEND_DATA:
       u8x8_byte_SetDC(u8x8, 1);
       //u8x8_byte_SendBytes(u8x8, arg_int, arg_ptr);
@@ -376,6 +468,8 @@ uint8_t u8x8_cad_011(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
       u8x8_byte_SetDC(u8x8, 1);
       u8x8_byte_SendByte(u8x8, arg_int);
       break;
+    case U8X8_MSG_CAD_SEND_RUN:
+      return u8x8_cad_send_run_dc(u8x8, arg_int, (u8x8_cad_run_t *)arg_ptr, 0, 1);
     case U8X8_MSG_CAD_SEND_DATA:
       u8x8_byte_SetDC(u8x8, 1);
       //u8x8_byte_SendBytes(u8x8, arg_int, arg_ptr);
@@ -479,7 +573,28 @@ static void u8x8_i2c_data_transfer(u8x8_t *u8x8, uint8_t arg_int, void *arg_ptr)
     u8x8_byte_EndTransfer(u8x8);
 }
 
+/* send cnt bytes with the same control byte, split into transfers of 24 bytes (see below) */
+static void u8x8_i2c_run_transfer(u8x8_t *u8x8, uint8_t control, uint8_t cnt, uint8_t *p)
+{
+  uint8_t len;
+  while( cnt > 0 )
+  {
+    len = cnt;
+    if ( len > 24 )
+      len = 24;
+    u8x8_byte_StartTransfer(u8x8);
+    u8x8_byte_SendByte(u8x8, control);
+    u8x8->byte_cb(u8x8, U8X8_MSG_CAD_SEND_DATA, len, p);
+    u8x8_byte_EndTransfer(u8x8);
+    cnt -= len;
+    p += len;
+  }
+}
+
 /* classic version: will put a start/stop condition around each command and arg */
+/* U8X8_MSG_CAD_SEND_RUN is not supported: Many controllers use this procedure */
+/* and none of them has been checked with several commands in one transfer. */
+/* Use u8x8_cad_ssd13xx_fast_i2c for a controller, which accepts this. */
 uint8_t u8x8_cad_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t *p;
@@ -533,7 +648,6 @@ uint8_t u8x8_cad_ssd13xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
 /* fast version with reduced data start/stops, issue 735 */
 uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  static uint8_t in_transfer = 0;
   uint8_t *p;
   switch(msg)
   {
@@ -541,13 +655,13 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       /* improved version, takeover from ld7032 */
       /* assumes, that the args of a command is not longer than 31 bytes */
       /* speed improvement is about 4% compared to the classic version */
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	 u8x8_byte_EndTransfer(u8x8); 
       
       u8x8_byte_StartTransfer(u8x8);
       u8x8_byte_SendByte(u8x8, 0x000);	/* cmd byte for ssd13xx controller */
       u8x8_byte_SendByte(u8x8, arg_int);
-      in_transfer = 1;
+      u8x8->cad_state |= U8X8_CAD_IN_TRANSFER;
       /* lightning version: can replace the improved version from above */
       /* the drawback of the lightning version is this: The complete init sequence */
       /* must fit into the 32 byte Arduino Wire buffer, which might not always be the case */
@@ -563,8 +677,16 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
     case U8X8_MSG_CAD_SEND_ARG:
       u8x8_byte_SendByte(u8x8, arg_int);
       break;      
+    case U8X8_MSG_CAD_SEND_RUN:
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
+	u8x8_byte_EndTransfer(u8x8); 
+      /* commands and args are both sent with control byte 0x00 */
+      u8x8_i2c_run_transfer(u8x8, 0x000, arg_int, ((u8x8_cad_run_t *)arg_ptr)->data);
+      ((u8x8_cad_run_t *)arg_ptr)->handled = 1;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
+      break;
     case U8X8_MSG_CAD_SEND_DATA:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8); 
       
     
@@ -583,7 +705,7 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 	p+=24;
       }
       u8x8_i2c_data_transfer(u8x8, arg_int, p);
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     case U8X8_MSG_CAD_INIT:
       /* apply default i2c adr if required so that the start transfer msg can use this */
@@ -591,12 +713,12 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 	u8x8->i2c_address = 0x078;
       return u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
     case U8X8_MSG_CAD_START_TRANSFER:
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     case U8X8_MSG_CAD_END_TRANSFER:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8); 
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     default:
       return 0;
@@ -611,6 +733,7 @@ uint8_t u8x8_cad_ssd13xx_fast_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 uint8_t u8x8_cad_st75256_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t *p;
+  uint8_t pos, len;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
@@ -625,6 +748,17 @@ uint8_t u8x8_cad_st75256_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       u8x8_byte_SendByte(u8x8, arg_int);
       u8x8_byte_EndTransfer(u8x8);
       break;
+    case U8X8_MSG_CAD_SEND_RUN:
+      /* one transfer for each group of commands (0x00) or args (0x40) */
+      pos = 0;
+      while( pos < arg_int )
+      {
+	len = u8x8_cad_get_run_segment_len((u8x8_cad_run_t *)arg_ptr, arg_int, pos);
+	u8x8_i2c_run_transfer(u8x8, u8x8_cad_IsRunCmd((u8x8_cad_run_t *)arg_ptr, pos) ? 0x000 : 0x040, len, ((u8x8_cad_run_t *)arg_ptr)->data + pos);
+	pos += len;
+      }
+      ((u8x8_cad_run_t *)arg_ptr)->handled = 1;
+      break;
     case U8X8_MSG_CAD_SEND_DATA:
       /* see ssd13xx driver */
       p = arg_ptr;
@@ -656,16 +790,15 @@ uint8_t u8x8_cad_st75256_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
 /* Workaround is to remove the while loop (or increase the value in the condition) */
 uint8_t u8x8_cad_ld7032_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  static uint8_t in_transfer = 0;
   uint8_t *p;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8); 
       u8x8_byte_StartTransfer(u8x8);
       u8x8_byte_SendByte(u8x8, arg_int);
-      in_transfer = 1;
+      u8x8->cad_state |= U8X8_CAD_IN_TRANSFER;
       break;
     case U8X8_MSG_CAD_SEND_ARG:
       u8x8_byte_SendByte(u8x8, arg_int);
@@ -698,10 +831,10 @@ uint8_t u8x8_cad_ld7032_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8->i2c_address = 0x060;
       return u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
     case U8X8_MSG_CAD_START_TRANSFER:
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     case U8X8_MSG_CAD_END_TRANSFER:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8); 
       break;
     default:
@@ -715,16 +848,14 @@ uint8_t u8x8_cad_ld7032_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 /* DC bit is encoded into the adr byte, structure is CAD001 */
 uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  static uint8_t in_transfer = 0;	
-  static uint8_t is_data = 0;
   uint8_t *p;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
     case U8X8_MSG_CAD_SEND_ARG:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
       {
-	if ( is_data != 0 )
+	if ( (u8x8->cad_state & U8X8_CAD_IS_DATA) != 0 )
 	{
 	  /* transfer mode is active, but data transfer */
 	  u8x8_byte_EndTransfer(u8x8); 
@@ -740,13 +871,13 @@ uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8_byte_StartTransfer(u8x8);
       }
       u8x8_byte_SendByte(u8x8, arg_int);
-      in_transfer = 1;
+      u8x8->cad_state |= U8X8_CAD_IN_TRANSFER;
       // is_data = 0;  // 20 Jun 2021: I assume that this is missing here
       break;
     case U8X8_MSG_CAD_SEND_DATA:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
       {
-	if ( is_data == 0 )
+	if ( (u8x8->cad_state & U8X8_CAD_IS_DATA) == 0 )
 	{
 	  /* transfer mode is active, but data transfer */
 	  u8x8_byte_EndTransfer(u8x8); 
@@ -761,7 +892,7 @@ uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8_SetI2CAddress( u8x8, (u8x8_GetI2CAddress(u8x8)&0x0fc)|2 );
 	u8x8_byte_StartTransfer(u8x8);
       }
-      in_transfer = 1;
+      u8x8->cad_state |= U8X8_CAD_IN_TRANSFER;
       // is_data = 1;  // 20 Jun 2021: I assume that this is missing here
       
       p = arg_ptr;
@@ -782,13 +913,13 @@ uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8->i2c_address = 0x070;
       return u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
     case U8X8_MSG_CAD_START_TRANSFER:
-      in_transfer = 0;    
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;    
       /* actual start is delayed, because we do not whether this is data or cmd transfer */
       break;
     case U8X8_MSG_CAD_END_TRANSFER:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8);
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     default:
       return 0;
@@ -801,15 +932,13 @@ uint8_t u8x8_cad_uc16xx_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 /* same as  u8x8_cad_uc16xx_i2c but CAD structure is CAD011 */
 uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  static uint8_t in_transfer = 0;	
-  static uint8_t is_data = 0;
   uint8_t *p;
   switch(msg)
   {
     case U8X8_MSG_CAD_SEND_CMD:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
       {
-	if ( is_data != 0 )
+	if ( (u8x8->cad_state & U8X8_CAD_IS_DATA) != 0 )
 	{
 	  /* transfer mode is active, but data transfer */
 	  u8x8_byte_EndTransfer(u8x8); 
@@ -825,13 +954,12 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8_byte_StartTransfer(u8x8);
       }
       u8x8_byte_SendByte(u8x8, arg_int);
-      in_transfer = 1;
-      is_data = 0;
+      u8x8->cad_state = U8X8_CAD_IN_TRANSFER;
       break;
     case U8X8_MSG_CAD_SEND_ARG:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
       {
-	if ( is_data == 0 )
+	if ( (u8x8->cad_state & U8X8_CAD_IS_DATA) == 0 )
 	{
 	  /* transfer mode is active, but data transfer */
 	  u8x8_byte_EndTransfer(u8x8); 
@@ -847,13 +975,12 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8_byte_StartTransfer(u8x8);
       }
       u8x8_byte_SendByte(u8x8, arg_int);
-      in_transfer = 1;
-      is_data = 1;
+      u8x8->cad_state = U8X8_CAD_IN_TRANSFER | U8X8_CAD_IS_DATA;
       break;
     case U8X8_MSG_CAD_SEND_DATA:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
       {
-	if ( is_data == 0 )
+	if ( (u8x8->cad_state & U8X8_CAD_IS_DATA) == 0 )
 	{
 	  /* transfer mode is active, but data transfer */
 	  u8x8_byte_EndTransfer(u8x8); 
@@ -868,8 +995,7 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8_SetI2CAddress( u8x8, (u8x8_GetI2CAddress(u8x8)&0x0fc)|2 );
 	u8x8_byte_StartTransfer(u8x8);
       }
-      in_transfer = 1;
-      is_data = 1;
+      u8x8->cad_state = U8X8_CAD_IN_TRANSFER | U8X8_CAD_IS_DATA;
       
       p = arg_ptr;
       while( arg_int > 24 )
@@ -889,13 +1015,13 @@ uint8_t u8x8_cad_uc1638_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 	u8x8->i2c_address = 0x078;  /* see also https://github.com/olikraus/u8g2/issues/371 for a discussion on this value */
       return u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
     case U8X8_MSG_CAD_START_TRANSFER:
-      in_transfer = 0;    
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;    
       /* actual start is delayed, because we do not whether this is data or cmd transfer */
       break;
     case U8X8_MSG_CAD_END_TRANSFER:
-      if ( in_transfer != 0 )
+      if ( (u8x8->cad_state & U8X8_CAD_IN_TRANSFER) != 0 )
 	u8x8_byte_EndTransfer(u8x8);
-      in_transfer = 0;
+      u8x8->cad_state &= ~U8X8_CAD_IN_TRANSFER;
       break;
     default:
       return 0;
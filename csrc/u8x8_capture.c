@@ -214,6 +214,9 @@ static void u8x8_capture_DrawTiles(u8x8_capture_t *capture, uint8_t tx, uint8_t
 
 uint8_t u8x8_d_capture(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
+  /* do not forward DRAW_FRAME, so that all rows will arrive as DRAW_TILE */
+  if ( msg == U8X8_MSG_DISPLAY_DRAW_FRAME )
+    return 0;
   if (  msg ==  U8X8_MSG_DISPLAY_DRAW_TILE )
   {
     uint8_t x, y, c;
@@ -35,6 +35,10 @@
   Use DC2 bitmap command of the A2 Micro panel termal printer
   double stroke
   
+  Blank tile rows are not printed. Instead the paper is moved forward 
+  with "ESC J n" before the next printed tile row or with u8x8_RefreshDisplay()
+  (called by u8g2_SendBuffer(), u8g2_NextPage() and u8g2_DrawCanvas()).
+  
   
 */
 
@@ -49,6 +53,25 @@
 /* best quality only with 1 */
 #define NO_OF_LINES_TO_SEND_WITHOUT_DELAY 1
 
+/* number of pixel lines, which are not yet moved forward */
+static uint16_t u8x8_a2printer_pending_feed = 0;
+
+static void u8x8_a2printer_feed(u8x8_t *u8x8)
+{
+  uint8_t n;
+  while( u8x8_a2printer_pending_feed > 0 )
+  {
+    n = 248;
+    if ( u8x8_a2printer_pending_feed < 248 )
+      n = u8x8_a2printer_pending_feed;
+    u8x8_cad_SendCmd(u8x8, 27);      /* ESC */
+    u8x8_cad_SendCmd(u8x8, 'J' );      /* print and feed n dots */
+    u8x8_cad_SendCmd(u8x8, n);
+    u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_MILLI, (n/8)*LINE_MIN_DELAY_MS, NULL);	
+    u8x8_a2printer_pending_feed -= n;
+  }
+}
+
 /* calculates the delay, based on the number of black pixel */
 /* actually only "none-zero" bytes are calculated which is, of course not so accurate, but should be good enough */
 uint16_t get_delay_in_milliseconds(uint8_t cnt, uint8_t *data)
@@ -66,6 +89,7 @@ uint8_t u8x8_d_a2printer_common(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t a
   uint8_t c, i, j;
   uint8_t *ptr;
   uint16_t delay_in_milliseconds;
+  uint16_t n;
   switch(msg)
   {
     /* U8X8_MSG_DISPLAY_SETUP_MEMORY is handled by the calling function */
@@ -75,14 +99,33 @@ uint8_t u8x8_d_a2printer_common(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t a
     */
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_a2printer_pending_feed = 0;
       // no setup required
       // u8x8_cad_SendSequence(u8x8, u8x8_d_a2printer_init_seq);
       break;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
       // no powersave 
       break;
+    case U8X8_MSG_DISPLAY_REFRESH:
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_a2printer_feed(u8x8);
+      u8x8_cad_EndTransfer(u8x8);
+      break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
+      c = u8x8->display_info->tile_width;
+      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;	/* data ptr to the tiles */
+      /* blank tile row: just move the paper forward later */
+      n = c*8;
+      while( n > 0 && ptr[n-1] == 0 )
+	n--;
+      if ( n == 0 )
+      {
+	u8x8_a2printer_pending_feed += 8;
+	break;
+      }
+      
       u8x8_cad_StartTransfer(u8x8);
+      u8x8_a2printer_feed(u8x8);
       
       u8x8_cad_SendCmd(u8x8, 27);      /* ESC */
       u8x8_cad_SendCmd(u8x8, 55 );      /* parameter command */
@@ -380,6 +380,7 @@ uint8_t u8x8_d_il3820_296x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
     case U8X8_MSG_DISPLAY_INIT:
 
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_296x128_init_seq);    
 
       u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_296x128_powersave0_seq);
@@ -397,10 +398,12 @@ uint8_t u8x8_d_il3820_296x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
 	u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_296x128_powersave1_seq);
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_il3820_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_il3820_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_to_display_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, NULL) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_to_display_seq);
       break;
     default:
       return 0;
@@ -518,6 +521,7 @@ uint8_t u8x8_d_il3820_v2_296x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, voi
     case U8X8_MSG_DISPLAY_INIT:
 
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
     
       u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_v2_296x128_init_seq);    
 
@@ -537,10 +541,12 @@ uint8_t u8x8_d_il3820_v2_296x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, voi
 	u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_296x128_powersave1_seq);
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_il3820_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_il3820_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_v2_to_display_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, NULL) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_il3820_v2_to_display_seq);
       break;
     default:
       return 0;
@@ -34,6 +34,19 @@
 
   The LS013B7DH02 is a simple display and controller
   --> no support for contrast adjustment, flip and power down.
+  
+  Line update (Feb 2023)
+    - Optional: With memory from u8x8_SetDisplayMemory(), the content of each 
+      line is stored and only changed lines are transfered. The required size is
+      U8X8_LS013B7DH03_MEM_SIZE(pixel_width, pixel_height): One valid bit
+      per line, followed by the content of all lines (12030 bytes for 400x240).
+      All lines are transfered if there is no memory or the memory is too small.
+    - All changed lines of a tile row (U8X8_MSG_DISPLAY_DRAW_TILE) or a 
+      frame (U8X8_MSG_DISPLAY_DRAW_FRAME) are sent with one update command.
+    - Nothing is sent if no line has been changed.
+    - VCOM (M1) is toggled with U8X8_MSG_DISPLAY_TOGGLE_VCOM (u8x8_ToggleVCOM),
+      which sends only two bytes. This is not required if EXTMODE is high.
+      The VCOM state is stored in u8x8->display_flags.
 */
 
 #include "u8x8.h"
@@ -43,6 +56,105 @@
 #define LS013B7DH03_CMD_UPDATE     (0x01)
 #define LS013B7DH03_CMD_ALL_CLEAR  (0x04)
 #define LS013B7DH03_VAL_TRAILER    (0x00)
+#define LS013B7DH03_VAL_VCOM       (0x02)	/* also used as bit in u8x8->display_flags */
+
+/* returns the line memory or NULL if not available */
+static uint8_t *u8x8_ls013b7dh03_get_mem(u8x8_t *u8x8)
+{
+  const u8x8_display_info_t *info = u8x8->display_info;
+  if ( u8x8->display_mem_size < U8X8_LS013B7DH03_MEM_SIZE(info->pixel_width, info->pixel_height) )
+    return NULL;
+  return (uint8_t *)u8x8->display_mem;
+}
+
+/* the content of all lines is unknown */
+static void u8x8_ls013b7dh03_clear_mem(u8x8_t *u8x8)
+{
+  uint8_t *mem = u8x8_ls013b7dh03_get_mem(u8x8);
+  uint8_t i, cnt;
+  if ( mem == NULL )
+    return;
+  cnt = (u8x8->display_info->pixel_height+7)/8;
+  for( i = 0; i < cnt; i++ )
+    mem[i] = 0;
+}
+
+/* 
+  line starts with 0, returns 0 if the line content is already on the display 
+  c: number of bytes of the line, starting at the left edge
+*/
+static uint8_t u8x8_ls013b7dh03_is_changed(u8x8_t *u8x8, uint8_t *mem, uint8_t line, uint8_t *ptr, uint8_t c)
+{
+  const u8x8_display_info_t *info = u8x8->display_info;
+  uint8_t *valid;
+  uint8_t *shadow;
+  uint8_t mask, i, is_same;
+  
+  if ( mem == NULL || line >= info->pixel_height )
+    return 1;
+  valid = mem + (line >> 3);
+  mask = 1 << (line & 7);
+  if ( c != info->tile_width )
+  {
+    /* only a part of the line is known */
+    *valid &= ~mask;
+    return 1;
+  }
+  shadow = mem + (info->pixel_height+7)/8 + (uint16_t)line*c;
+  is_same = (*valid & mask) ? 1 : 0;
+  for( i = 0; i < c; i++ )
+  {
+    if ( shadow[i] != ptr[i] )
+    {
+      is_same = 0;
+      shadow[i] = ptr[i];
+    }
+  }
+  if ( is_same )
+    return 0;
+  *valid |= mask;
+  return 1;
+}
+
+/* 
+  send all changed lines of "rows" tile rows with one update command 
+  c: number of bytes per line
+*/
+static void u8x8_ls013b7dh03_send_lines(u8x8_t *u8x8, uint8_t y, uint8_t rows, uint8_t c, uint8_t *ptr)
+{
+  uint8_t *mem = u8x8_ls013b7dh03_get_mem(u8x8);
+  uint16_t i, cnt;
+  uint8_t is_started = 0;
+  
+  y *= 8;
+  cnt = rows*8;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( u8x8_ls013b7dh03_is_changed(u8x8, mem, y, ptr, c) )
+    {
+      if ( is_started == 0 )
+      {
+	/* send data mode byte */
+	u8x8_cad_StartTransfer(u8x8);
+	u8x8_cad_SendCmd(u8x8, SWAP8(LS013B7DH03_CMD_UPDATE | (u8x8->display_flags & LS013B7DH03_VAL_VCOM)) );
+	is_started = 1;
+      }
+      /* line address starts with 1 */
+      u8x8_cad_SendCmd(u8x8, SWAP8(y + 1) );
+      u8x8_cad_SendData(u8x8, c, ptr);
+      u8x8_cad_SendCmd(u8x8, LS013B7DH03_VAL_TRAILER);
+    }
+    ptr += c;
+    y++;
+  }
+  
+  if ( is_started )
+  {
+    /* finish with a trailing byte */
+    u8x8_cad_SendCmd(u8x8, LS013B7DH03_VAL_TRAILER);
+    u8x8_cad_EndTransfer(u8x8);
+  }
+}
 
 static const u8x8_display_info_t u8x8_ls013b7dh03_128x128_display_info =
 {
@@ -67,10 +179,8 @@ static const u8x8_display_info_t u8x8_ls013b7dh03_128x128_display_info =
   /* pixel_height = */ 128
 };
 
-uint8_t u8x8_d_ls013b7dh03_128x128(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t arg_int, void *arg_ptr)
+uint8_t u8x8_d_ls013b7dh03_128x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  uint8_t y, c, i;
-  uint8_t *ptr;
   switch(msg)
   {
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
@@ -84,6 +194,8 @@ uint8_t u8x8_d_ls013b7dh03_128x128(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_
       u8x8_cad_SendCmd(u8x8, SWAP8(LS013B7DH03_CMD_ALL_CLEAR) );
       u8x8_cad_SendCmd(u8x8, LS013B7DH03_VAL_TRAILER);
       u8x8_cad_EndTransfer(u8x8);
+      u8x8->display_flags = 0;
+      u8x8_ls013b7dh03_clear_mem(u8x8);
 
       break;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
@@ -91,29 +203,22 @@ uint8_t u8x8_d_ls013b7dh03_128x128(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
       /* each tile is 8 lines, with the data starting at the left edge */
-      y = ((((u8x8_tile_t *)arg_ptr)->y_pos) * 8) + 1;
-
-      c = ((u8x8_tile_t *)arg_ptr)->cnt;
-      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
-
-      /* send data mode byte */
+      u8x8_ls013b7dh03_send_lines(u8x8, ((u8x8_tile_t *)arg_ptr)->y_pos, 1, 
+	((u8x8_tile_t *)arg_ptr)->cnt, ((u8x8_tile_t *)arg_ptr)->tile_ptr);
+      break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      /* arg_int tile rows, all lines follow each other */
+      u8x8_ls013b7dh03_send_lines(u8x8, ((u8x8_tile_t *)arg_ptr)->y_pos, arg_int, 
+	((u8x8_tile_t *)arg_ptr)->cnt, ((u8x8_tile_t *)arg_ptr)->tile_ptr);
+      ((u8x8_tile_t *)arg_ptr)->cnt = 0;
+      break;
+    case U8X8_MSG_DISPLAY_TOGGLE_VCOM:
+      /* display mode: M0 = 0, M1 = VCOM */
+      u8x8->display_flags ^= LS013B7DH03_VAL_VCOM;
       u8x8_cad_StartTransfer(u8x8);
-      u8x8_cad_SendCmd(u8x8, SWAP8(LS013B7DH03_CMD_UPDATE) );
-
-      /* send 8 lines of 16 bytes (=128 pixels) */
-      for( i = 0; i < 8; i++ )
-      {
-        u8x8_cad_SendCmd(u8x8, SWAP8(y + i) );
-        u8x8_cad_SendData(u8x8, c, ptr);
-        u8x8_cad_SendCmd(u8x8, LS013B7DH03_VAL_TRAILER);
-
-        ptr += c;
-      }
-
-      /* finish with a trailing byte */
+      u8x8_cad_SendCmd(u8x8, SWAP8(u8x8->display_flags & LS013B7DH03_VAL_VCOM) );
       u8x8_cad_SendCmd(u8x8, LS013B7DH03_VAL_TRAILER);
       u8x8_cad_EndTransfer(u8x8);
-
       break;
     default:
       return 0;
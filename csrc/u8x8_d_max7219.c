@@ -36,6 +36,24 @@
 
 #include "u8x8.h"
 
+/*
+  Change-only update
+    Optional: With memory from u8x8_SetDisplayMemory(), the driver keeps a 
+    copy of the last transfered rows. The required size is 
+    U8X8_MAX7219_MEM_SIZE(modules): One byte with the number of valid 
+    modules, followed by 8 bytes per module.
+    A row is skipped if it is unchanged for all modules. Otherwise the row is 
+    shifted through the chain, but unchanged modules receive the no-op 
+    command (0x00). Without this memory, all rows are transfered.
+*/
+
+/* the copy is not valid after init */
+static void u8x8_max7219_clear_mem(u8x8_t *u8x8)
+{
+  if ( u8x8->display_mem_size > 0 )
+    ((uint8_t *)u8x8->display_mem)[0] = 0;
+}
+
 
 
 static const uint8_t u8x8_d_max7219_init_seq[] = {
@@ -147,6 +165,49 @@ static uint8_t u8x8_d_max7219_generic(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int
 
       c = ((u8x8_tile_t *)arg_ptr)->cnt;	/* number of tiles */
       ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;	/* data ptr to the tiles */
+      if ( u8x8->display_mem_size >= U8X8_MAX7219_MEM_SIZE(c) && ((u8x8_tile_t *)arg_ptr)->y_pos == 0 )
+      {
+	uint8_t *mem = (uint8_t *)u8x8->display_mem;
+	uint8_t *shadow = mem+1;
+	uint8_t is_valid = (mem[0] == c);
+	for( i = 0; i < 8; i++ )
+	{
+	  if ( is_valid )
+	  {
+	    for( j = 0; j < c; j++ )
+	      if ( shadow[j] != ptr[j] )
+		break;
+	    if ( j == c )
+	    {
+	      /* no change in this row */
+	      ptr += c;
+	      shadow += c;
+	      continue;
+	    }
+	  }
+	  u8x8_cad_StartTransfer(u8x8);
+	  for( j = 0; j < c; j++ )
+	  {
+	    if ( is_valid && *shadow == *ptr )
+	    {
+	      u8x8_cad_SendCmd(u8x8, 0);	/* no-op, module keeps its row */
+	      u8x8_cad_SendArg(u8x8, 0);
+	    }
+	    else
+	    {
+	      u8x8_cad_SendCmd(u8x8, i+1);	/* commands 1..8 select the byte */
+	      u8x8_cad_SendArg(u8x8, *ptr );
+	      *shadow = *ptr;
+	    }
+	    ptr++;
+	    shadow++;
+	  }
+	  u8x8_cad_EndTransfer(u8x8);
+	}
+	mem[0] = c;
+	break;
+      }
+      u8x8_max7219_clear_mem(u8x8);
       for( i = 0; i < 8; i++ )
       {
 	u8x8_cad_StartTransfer(u8x8);
@@ -201,6 +262,7 @@ uint8_t u8x8_d_max7219_32x8(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       return 1;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_max7219_clear_mem(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_max7219_init_seq);    
       return 1;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
@@ -256,6 +318,7 @@ uint8_t u8x8_d_max7219_16x16(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       return 1;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_max7219_clear_mem(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_max7219_init_seq);    
       return 1;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
@@ -303,6 +366,7 @@ uint8_t u8x8_d_max7219_8x8(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg
       return 1;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_max7219_clear_mem(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_max7219_init_seq);    
       return 1;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
@@ -444,6 +508,7 @@ uint8_t u8x8_d_max7219_64x8(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       return 1;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_max7219_clear_mem(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_max7219_8_init_seq);    
       return 1;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
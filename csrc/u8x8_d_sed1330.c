@@ -39,10 +39,106 @@
     SED1335
     S1D13700
 
+  Text layer (u8x8_SetTextLayer)
+    The text RAM starts at the next 1K boundary after the graphics RAM.
+    It becomes the first layer and the graphics moves to the second layer 
+    (both layers are combined with OR). The CG RAM (SAG) uses the next 
+    2K block, codes 0x80..0x9f are located at SAG + 0x400.
+    For 240x128: text 0x1000, SAG 0x1800.
+    The state of the text layer is stored in u8x8->display_flags.
 
 */
 #include "u8x8.h"
 
+#define U8X8_SED1330_TEXT_LAYER 1		/* display_flags: graphics and text */
+
+/* text home address: next 1K boundary after the graphics RAM */
+static uint16_t u8x8_sed1330_get_text_home(u8x8_t *u8x8)
+{
+  uint16_t adr = u8x8->display_info->tile_width;
+  adr *= u8x8->display_info->tile_height;
+  adr *= 8;
+  return (adr + 0x3ff) & 0xfc00;
+}
+
+static void u8x8_sed1330_set_adr(u8x8_t *u8x8, uint16_t adr)
+{
+  u8x8_cad_SendCmd(u8x8, 0x046 );	/* CSRW command*/
+  u8x8_cad_SendArg(u8x8, adr&255);		/* CSRW low adr byte */
+  u8x8_cad_SendArg(u8x8, adr>>8);		/* CSRW high adr byte */
+  u8x8_cad_SendCmd(u8x8, 0x042 );	/* MWRITE */
+}
+
+/* write cnt codes into the text RAM (after MWRITE), ptr = NULL writes space chars */
+static void u8x8_sed1330_send_codes(u8x8_t *u8x8, uint16_t cnt, const uint8_t *ptr)
+{
+  uint8_t buf[16];
+  uint8_t i, b;
+  while( cnt > 0 )
+  {
+    for( i = 0; i < sizeof(buf) && i < cnt; i++ )
+    {
+      b = ' ';
+      if ( ptr != NULL && ptr[i] >= 0x020 && ptr[i] < 0x0a0 )
+	b = ptr[i];
+      buf[i] = b;
+    }
+    u8x8_cad_SendData(u8x8, i, buf);
+    cnt -= i;
+    if ( ptr != NULL )
+      ptr += i;
+  }
+}
+
+static void u8x8_sed1330_set_text_layer(u8x8_t *u8x8, uint8_t is_enable)
+{
+  uint16_t text_adr, graphics_adr, cnt;
+  uint8_t sl = u8x8->display_info->pixel_height - 1;
+  
+  if ( is_enable )
+    u8x8->display_flags |= U8X8_SED1330_TEXT_LAYER;
+  else
+    u8x8->display_flags &= ~U8X8_SED1330_TEXT_LAYER;
+  text_adr = u8x8_sed1330_get_text_home(u8x8);
+  graphics_adr = 0;
+  if ( is_enable == 0 )
+  {
+    /* graphics in layer 1, the text RAM is not visible */
+    graphics_adr = text_adr;
+    text_adr = 0;
+  }
+  u8x8_cad_StartTransfer(u8x8);
+  u8x8_cad_SendCmd(u8x8, 0x044 );	/* SCROLL */
+  u8x8_cad_SendArg(u8x8, text_adr&255);	/* SAD1: text or graphics */
+  u8x8_cad_SendArg(u8x8, text_adr>>8);
+  u8x8_cad_SendArg(u8x8, sl);
+  u8x8_cad_SendArg(u8x8, graphics_adr&255);	/* SAD2: graphics */
+  u8x8_cad_SendArg(u8x8, graphics_adr>>8);
+  u8x8_cad_SendArg(u8x8, sl);
+  u8x8_cad_SendArg(u8x8, 0);
+  u8x8_cad_SendArg(u8x8, 0);
+  u8x8_cad_SendArg(u8x8, 0);
+  u8x8_cad_SendArg(u8x8, 0);
+  if ( is_enable )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x05c );	/* CGRAM ADR */
+    u8x8_cad_SendArg(u8x8, 0);
+    u8x8_cad_SendArg(u8x8, ((text_adr>>11)+1)<<3);	/* SAG: next 2K block */
+    u8x8_sed1330_set_adr(u8x8, text_adr);
+    cnt = u8x8->display_info->tile_width;
+    cnt *= u8x8->display_info->tile_height;
+    u8x8_sed1330_send_codes(u8x8, cnt, NULL);
+    u8x8_cad_SendCmd(u8x8, 0x05b );	/* OVLAY */
+    u8x8_cad_SendArg(u8x8, 0x008);	/* layer 1 text, OR */
+  }
+  else
+  {
+    u8x8_cad_SendCmd(u8x8, 0x05b );	/* OVLAY */
+    u8x8_cad_SendArg(u8x8, 0x00c);	/* all graphics, OR */
+  }
+  u8x8_cad_EndTransfer(u8x8);
+}
+
 
 
 static const uint8_t u8x8_d_sed1330_powersave0_seq[] = {
@@ -81,10 +177,44 @@ uint8_t u8x8_d_sed1330_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
     */
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
       if ( arg_int == 0 )
+      {
 	u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_powersave0_seq);
+	if ( u8x8->display_flags & U8X8_SED1330_TEXT_LAYER )
+	{
+	  u8x8_cad_StartTransfer(u8x8);
+	  u8x8_cad_SendCmd(u8x8, 0x059 );	/* display on */
+	  u8x8_cad_SendArg(u8x8, 0x014);	/* layer 1 (text) and layer 2 (graphics) on */
+	  u8x8_cad_EndTransfer(u8x8);
+	}
+      }
       else
 	u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_powersave1_seq);
       break;
+    case U8X8_MSG_DISPLAY_SET_TEXT_LAYER:
+      u8x8_sed1330_set_text_layer(u8x8, arg_int);
+      break;
+    case U8X8_MSG_DISPLAY_DRAW_TEXT:
+      y = ((u8x8_tile_t *)arg_ptr)->y_pos;
+      y *= u8x8->display_info->tile_width;
+      y += ((u8x8_tile_t *)arg_ptr)->x_pos;
+      y += u8x8_sed1330_get_text_home(u8x8);
+      c = ((u8x8_tile_t *)arg_ptr)->cnt;
+      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_sed1330_set_adr(u8x8, y);
+      u8x8_sed1330_send_codes(u8x8, c, ptr);
+      u8x8_cad_EndTransfer(u8x8);
+      ((u8x8_tile_t *)arg_ptr)->cnt = 0;	/* handled */
+      break;
+    case U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH:
+      y = u8x8_sed1330_get_text_home(u8x8);
+      y = ((y>>11)+1)<<11;		/* SAG */
+      y += (uint16_t)arg_int*8;
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_sed1330_set_adr(u8x8, y);
+      u8x8_cad_SendData(u8x8, 8, (uint8_t *)arg_ptr);
+      u8x8_cad_EndTransfer(u8x8);
+      break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
       y = (((u8x8_tile_t *)arg_ptr)->y_pos);
       y*=8;
@@ -109,7 +239,7 @@ uint8_t u8x8_d_sed1330_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
 
       /* sometimes the display switches off... so just sent a display on command */
       u8x8_cad_SendCmd(u8x8, 0x059 );	/* display on */
-      u8x8_cad_SendArg(u8x8, 0x004);	/* arg for display on */
+      u8x8_cad_SendArg(u8x8, (u8x8->display_flags & U8X8_SED1330_TEXT_LAYER) ? 0x014 : 0x004);	/* arg for display on */
 
       u8x8_cad_EndTransfer(u8x8);
       //u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, 200, NULL);	/* extra dely required */
@@ -238,6 +368,7 @@ uint8_t u8x8_d_sed1330_240x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off */
       u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_240x128_init_seq);
       break;
     default:
@@ -256,6 +387,7 @@ uint8_t u8x8_d_ra8835_nhd_240x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off */
       u8x8_cad_SendSequence(u8x8, u8x8_d_rh8835_nhd_240128_init_seq);
       break;
     default:
@@ -342,6 +474,7 @@ uint8_t u8x8_d_ra8835_320x240(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off */
       u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_320x240_init_seq);
       break;
     default:
@@ -429,6 +562,7 @@ uint8_t u8x8_d_sed1330_256x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off */
       u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_256x128_init_seq);
       break;
     default:
@@ -523,6 +657,7 @@ uint8_t u8x8_d_sed1330_320x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off */
       u8x8_cad_SendSequence(u8x8, u8x8_d_sed1330_320x200_init_seq);
       break;
     default:
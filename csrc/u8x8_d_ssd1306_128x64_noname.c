@@ -257,6 +257,13 @@ static uint8_t u8x8_d_ssd1306_sh1106_generic(u8x8_t *u8x8, uint8_t msg, uint8_t
   uint8_t *ptr;
   switch(msg)
   {
+    case U8X8_MSG_DISPLAY_SET_START_LINE:
+      u8x8->start_line = arg_int & 63;
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_cad_SendCmd(u8x8, 0x040 | u8x8->start_line );
+      u8x8_cad_EndTransfer(u8x8);
+      *(uint8_t *)arg_ptr = 1;	/* supported */
+      break;
     /* handled by the calling function
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
@@ -300,7 +307,7 @@ static uint8_t u8x8_d_ssd1306_sh1106_generic(u8x8_t *u8x8, uint8_t msg, uint8_t
       x *= 8;
       x += u8x8->x_offset;
     
-      u8x8_cad_SendCmd(u8x8, 0x040 );	/* set line offset to 0 */
+      u8x8_cad_SendCmd(u8x8, 0x040 | u8x8->start_line );	/* set line offset, usually 0 */
     
       u8x8_cad_SendCmd(u8x8, 0x010 | (x>>4) );
       u8x8_cad_SendArg(u8x8, 0x000 | ((x&15)));					/* probably wrong, should be SendCmd */
@@ -332,6 +339,87 @@ static uint8_t u8x8_d_ssd1306_sh1106_generic(u8x8_t *u8x8, uint8_t msg, uint8_t
 }
 
 
+/*
+  U8X8_MSG_DISPLAY_DRAW_FRAME for SSD1306 compatible controllers (not SH1106):
+  Set the column (0x21) and page (0x22) window once, then send all rows in 
+  horizontal addressing mode.
+  addr_mode: addressing mode of the init sequence, restored after the frame.
+  For horizontal mode (0), the window is reset to the full controller RAM
+  (128x64, independent of the panel size), because U8X8_MSG_DISPLAY_DRAW_TILE 
+  does not change the window. This costs 6 bytes, so a frame with less than 
+  8 rows will not be cheaper (this is the reason, why 128x32 panels do not 
+  use this procedure).
+  tile_cmd_cnt: number of command bytes of U8X8_MSG_DISPLAY_DRAW_TILE for one row
+  The frame is only used if it requires less command bytes than
+  U8X8_MSG_DISPLAY_DRAW_TILE, usually this is the case for a full 
+  buffer (u8g2 _f), but not for one or two pages (u8g2 _1, _2).
+  Returns 0 and does not change tile->cnt if the rows should be sent with
+  U8X8_MSG_DISPLAY_DRAW_TILE.
+*/
+uint8_t u8x8_d_helper_ssd1306_draw_frame(u8x8_t *u8x8, uint8_t rows, u8x8_tile_t *tile, uint8_t addr_mode, uint8_t tile_cmd_cnt)
+{
+  uint8_t x, w, y, r, is_restore_window, cmd_cnt;
+  uint8_t *ptr;
+  
+  x = tile->x_pos;
+  x *= 8;
+  x += u8x8->x_offset;
+  w = tile->cnt;
+  w *= 8;
+  y = tile->y_pos;
+  ptr = tile->tile_ptr;
+  
+  /* DRAW_TILE expects the full window in horizontal mode */
+  is_restore_window = 0;
+  if ( addr_mode == 0 && (x != 0 || w != 128 || y != 0 || rows != 8) )
+    is_restore_window = 1;
+  
+  /* start line 1, column and page window 6, mode and restore 4, restore window 6 */
+  cmd_cnt = 7;
+  if ( addr_mode != 0 )
+    cmd_cnt += 4;
+  if ( is_restore_window )
+    cmd_cnt += 6;
+  if ( cmd_cnt >= rows*tile_cmd_cnt )
+    return 0;		/* DRAW_TILE is cheaper */
+  
+  u8x8_cad_StartTransfer(u8x8);
+  u8x8_cad_SendCmd(u8x8, 0x040 | u8x8->start_line );	/* set line offset, see U8X8_MSG_DISPLAY_SET_START_LINE */
+  if ( addr_mode != 0 )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x020 );
+    u8x8_cad_SendArg(u8x8, 0x000 );	/* horizontal addressing mode */
+  }
+  u8x8_cad_SendCmd(u8x8, 0x021 );	/* column window */
+  u8x8_cad_SendArg(u8x8, x );
+  u8x8_cad_SendArg(u8x8, x+w-1 );
+  u8x8_cad_SendCmd(u8x8, 0x022 );	/* page window */
+  u8x8_cad_SendArg(u8x8, y );
+  u8x8_cad_SendArg(u8x8, y+rows-1 );
+  for( r = 0; r < rows; r++ )
+  {
+    u8x8_cad_SendData(u8x8, w, ptr); 	/* note: SendData can not handle more than 255 bytes */
+    ptr += w;
+  }
+  if ( addr_mode != 0 )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x020 );
+    u8x8_cad_SendArg(u8x8, addr_mode );
+  }
+  else if ( is_restore_window )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x021 );
+    u8x8_cad_SendArg(u8x8, 0 );
+    u8x8_cad_SendArg(u8x8, 127 );
+    u8x8_cad_SendCmd(u8x8, 0x022 );
+    u8x8_cad_SendArg(u8x8, 0 );
+    u8x8_cad_SendArg(u8x8, 7 );
+  }
+  u8x8_cad_EndTransfer(u8x8);
+  tile->cnt = 0;	/* tell u8x8_DrawTileRows() that the rows are sent */
+  return 1;
+}
+
 static const u8x8_display_info_t u8x8_ssd1306_128x64_noname_display_info =
 {
   /* chip_enable_level = */ 0,
@@ -368,6 +456,9 @@ uint8_t u8x8_d_ssd1306_128x64_noname(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1306_128x64_noname_init_seq);    
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 0, 4);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
@@ -397,6 +488,9 @@ uint8_t u8x8_d_ssd1312_128x64_noname(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1312_128x64_noname_init_seq);    /* update 27 mar 2022 */
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 0, 4);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
@@ -421,6 +515,9 @@ uint8_t u8x8_d_ssd1306_128x64_vcomh0(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1306_128x64_vcomh0_init_seq);    
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 0, 4);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
@@ -442,6 +539,9 @@ uint8_t u8x8_d_ssd1306_128x64_alt0(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, v
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1306_128x64_alt0_init_seq);    
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 0, 4);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1306_128x64_noname_display_info);
       break;
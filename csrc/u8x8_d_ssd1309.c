@@ -216,6 +216,9 @@ uint8_t u8x8_d_ssd1309_128x64_noname2(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1309_128x64_noname_init_seq);    
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 2, 3);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1309_128x64_noname2_display_info);
       break;
@@ -278,6 +281,9 @@ uint8_t u8x8_d_ssd1309_128x64_noname0(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1309_128x64_noname_init_seq);    
       break;
+    case U8X8_MSG_DISPLAY_DRAW_FRAME:
+      u8x8_d_helper_ssd1306_draw_frame(u8x8, arg_int, (u8x8_tile_t *)arg_ptr, 2, 3);
+      break;
     case U8X8_MSG_DISPLAY_SETUP_MEMORY:
       u8x8_d_helper_display_setup_memory(u8x8, &u8x8_ssd1309_128x64_noname0_display_info);
       break;
@@ -81,76 +81,10 @@ static uint8_t u8x8_write_byte_to_16gr_device(u8x8_t *u8x8, uint8_t b)
 */
 
 
-/*
-  input:
-    one tile (8 Bytes)
-  output:
-    Tile for SSD1325 (32 Bytes)
-*/
-
-static uint8_t u8x8_ssd1322_to32_dest_buf[32];
-
-static uint8_t *u8x8_ssd1322_8to32(U8X8_UNUSED u8x8_t *u8x8, uint8_t *ptr)
-{
-  uint8_t v;
-  uint8_t a,b;
-  uint8_t i, j;
-  uint8_t *dest;
-  
-  for( j = 0; j < 4; j++ )
-  {
-    dest = u8x8_ssd1322_to32_dest_buf;
-    dest += j;
-    a =*ptr;
-    ptr++;
-    b = *ptr;
-    ptr++;
-    for( i = 0; i < 8; i++ )
-    {
-      v = 0;
-      if ( a&1 ) v |= 0xf0;
-      if ( b&1 ) v |= 0x0f;
-      *dest = v;
-      dest+=4;
-      a >>= 1;
-      b >>= 1;
-    }
-  }
-  
-  return u8x8_ssd1322_to32_dest_buf;
-}
-
-static uint8_t *u8x8_ssd1322_4to32(U8X8_UNUSED u8x8_t *u8x8, uint8_t *ptr)
-{
-  uint8_t v;
-  uint8_t a;
-  uint8_t i, j;
-  uint8_t *dest;
-  
-  for( j = 0; j < 4; j++ )
-  {
-    dest = u8x8_ssd1322_to32_dest_buf;
-    dest += j;
-    a =*ptr;
-    ptr++;
-    for( i = 0; i < 8; i++ )
-    {
-      v = 0;
-      if ( a&1 ) v = 0xff;
-      *dest = v;
-      dest+=4;
-      a >>= 1;
-    }
-  }
-  
-  return u8x8_ssd1322_to32_dest_buf;
-}
-
-
 uint8_t u8x8_d_ssd1322_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t x; 
-  uint8_t y, c;
+  uint8_t y, c, n;
   uint8_t *ptr;
   switch(msg)
   {
@@ -198,17 +132,21 @@ uint8_t u8x8_d_ssd1322_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *
 
 	do
 	{
+	  /* expand and send as many tiles as possible with one column window */
+	  n = u8x8_d_helper_gray4_max_tiles(u8x8, 4);
+	  if ( n > c )
+	    n = c;
 	  u8x8_cad_SendCmd(u8x8, 0x015 );	/* set column address */
 	  u8x8_cad_SendArg(u8x8, x );	/* start */
-	  u8x8_cad_SendArg(u8x8, x+1 );	/* end */
+	  u8x8_cad_SendArg(u8x8, x+n*2-1 );	/* end */
 
 	  u8x8_cad_SendCmd(u8x8, 0x05c );	/* write to ram */
 	  
-	  u8x8_cad_SendData(u8x8, 32, u8x8_ssd1322_8to32(u8x8, ptr));
+	  u8x8_d_helper_gray4_send_tiles(u8x8, ptr, n*4, 0);
 	  
-	  ptr += 8;
-	  x += 2;
-	  c--;
+	  ptr += n*8;
+	  x += n*2;
+	  c -= n;
 	} while( c > 0 );
 	
 	//x += 2;
@@ -439,7 +377,7 @@ uint8_t u8x8_d_ssd1322_240x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
 uint8_t u8x8_d_ssd1322_common2(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
   uint8_t x; 
-  uint8_t y, c;
+  uint8_t y, c, n;
   uint8_t *ptr;
   switch(msg)
   {
@@ -488,23 +426,18 @@ uint8_t u8x8_d_ssd1322_common2(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
 
 	do
 	{
+	  /* one tile uses 4 column addresses (16 pixel), each pixel is doubled */
+	  n = u8x8_d_helper_gray4_max_tiles(u8x8, 8);
+	  if ( n > c )
+	    n = c;
 	  u8x8_cad_SendCmd(u8x8, 0x015 );	/* set column address */
 	  u8x8_cad_SendArg(u8x8, x );	/* start */
-	  u8x8_cad_SendArg(u8x8, x+1 );	/* end */
-	  u8x8_cad_SendCmd(u8x8, 0x05c );	/* write to ram */	  
-	  u8x8_cad_SendData(u8x8, 32, u8x8_ssd1322_4to32(u8x8, ptr));	  
-	  ptr += 4;
-	  x += 2;
-	  
-	  u8x8_cad_SendCmd(u8x8, 0x015 );	/* set column address */
-	  u8x8_cad_SendArg(u8x8, x );	/* start */
-	  u8x8_cad_SendArg(u8x8, x+1 );	/* end */
+	  u8x8_cad_SendArg(u8x8, x+n*4-1 );	/* end */
 	  u8x8_cad_SendCmd(u8x8, 0x05c );	/* write to ram */	  
-	  u8x8_cad_SendData(u8x8, 32, u8x8_ssd1322_4to32(u8x8, ptr));	  
-	  ptr += 4;
-	  x += 2;
-	  
-	  c--;
+	  u8x8_d_helper_gray4_send_tiles(u8x8, ptr, n*8, 1);
+	  ptr += n*8;
+	  x += n*4;
+	  c -= n;
 	} while( c > 0 );
 	
 	//x += 2;
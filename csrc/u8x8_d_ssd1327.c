@@ -85,51 +85,9 @@ static const uint8_t u8x8_d_ssd1327_winstar_96x64_flip1_seq[] = {
   U8X8_END()             			/* end of sequence */
 };
 
-/*
-  input:
-    one tile (8 Bytes)
-  output:
-    Tile for ssd1327 (32 Bytes)
-*/
-
-static uint8_t u8x8_ssd1327_8to32_dest_buf[32];
-
-static uint8_t *u8x8_ssd1327_8to32(U8X8_UNUSED u8x8_t *u8x8, uint8_t *ptr)
-{
-  uint8_t v;
-  uint8_t a,b;
-  uint8_t i, j;
-  uint8_t *dest;
-  
-  for( j = 0; j < 4; j++ )
-  {
-    dest = u8x8_ssd1327_8to32_dest_buf;
-    dest += j;
-    a =*ptr;
-    ptr++;
-    b = *ptr;
-    ptr++;
-    for( i = 0; i < 8; i++ )
-    {
-      v = 0;
-      if ( a&1 ) v |= 0xf0;
-      if ( b&1 ) v |= 0x0f;
-      *dest = v;
-      dest+=4;
-      a >>= 1;
-      b >>= 1;
-    }
-  }
-  
-  return u8x8_ssd1327_8to32_dest_buf;
-}
-
-
-
-
 static uint8_t u8x8_d_ssd1327_96x96_generic(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  uint8_t x, y, c;
+  uint8_t x, y, c, n;
   uint8_t *ptr;
   switch(msg)
   {
@@ -179,15 +137,19 @@ static uint8_t u8x8_d_ssd1327_96x96_generic(u8x8_t *u8x8, uint8_t msg, uint8_t a
 
 	do
 	{
+	  /* expand and send as many tiles as possible with one column window */
+	  n = u8x8_d_helper_gray4_max_tiles(u8x8, 4);
+	  if ( n > c )
+	    n = c;
 	  u8x8_cad_SendCmd(u8x8, 0x015 );	/* set column address */
 	  u8x8_cad_SendArg(u8x8, x );	/* start */
-	  u8x8_cad_SendArg(u8x8, x+3 );	/* end */
+	  u8x8_cad_SendArg(u8x8, x+n*4-1 );	/* end */
 
 	  
-	  u8x8_cad_SendData(u8x8, 32, u8x8_ssd1327_8to32(u8x8, ptr));
-	  ptr += 8;
-	  x += 4;
-	  c--;
+	  u8x8_d_helper_gray4_send_tiles(u8x8, ptr, n*4, 0);
+	  ptr += n*8;
+	  x += n*4;
+	  c -= n;
 	} while( c > 0 );
 	
 	//x += 4;
@@ -367,6 +367,7 @@ uint8_t u8x8_d_ssd1607_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_init_seq);    
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_powersave0_seq);
       u8x8_d_ssd1607_200x200_first_init(u8x8);
@@ -380,10 +381,12 @@ uint8_t u8x8_d_ssd1607_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
     case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_to_display_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, NULL) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_to_display_seq);
       break;
     default:
       return 0;
@@ -484,6 +487,7 @@ uint8_t u8x8_d_ssd1607_v2_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_init_seq);    
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_powersave0_seq);
       u8x8_d_ssd1607_200x200_first_init(u8x8);
@@ -497,10 +501,12 @@ uint8_t u8x8_d_ssd1607_v2_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
     case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_v2_to_display_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, NULL) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_v2_to_display_seq);
       break;
     default:
       return 0;
@@ -582,6 +588,7 @@ uint8_t u8x8_d_ssd1607_gd_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_init_seq);    
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_powersave0_seq);
       u8x8_d_ssd1607_200x200_first_init(u8x8);
@@ -595,10 +602,12 @@ uint8_t u8x8_d_ssd1607_gd_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
     case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_gd_to_display_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, NULL) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_gd_to_display_seq);
       break;
     default:
       return 0;
@@ -610,7 +619,8 @@ uint8_t u8x8_d_ssd1607_gd_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
 
 /*=================================================*/
 
-static const uint8_t u8x8_d_ssd1607_ws_to_display_seq[] = {
+/* the refresh sequence does not write the LUT, it is also restored after a partial refresh */
+static const uint8_t u8x8_d_ssd1607_ws_lut_seq[] = {
   U8X8_START_TRANSFER(),             	/* enable chip, delay is part of the transfer start */
 
 
@@ -624,6 +634,13 @@ static const uint8_t u8x8_d_ssd1607_ws_to_display_seq[] = {
   U8X8_A(0x13), U8X8_A(0x14), U8X8_A(0x44), U8X8_A(0x12), U8X8_A(0x00), 
   U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00),
 
+  U8X8_END_TRANSFER(),             	/* disable chip */
+  U8X8_END()             			/* end of sequence */
+};
+
+static const uint8_t u8x8_d_ssd1607_ws_to_display_seq[] = {
+  U8X8_START_TRANSFER(),             	/* enable chip, delay is part of the transfer start */
+
   U8X8_CA(0x22, 0xc4),	/* display update seq. option: clk -> CP -> LUT -> initial display -> pattern display */
   U8X8_C(0x20),	/* execute sequence */
   
@@ -691,10 +708,12 @@ uint8_t u8x8_d_ssd1607_ws_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8_d_helper_epaper_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_200x200_init_seq);    
       u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_200x200_powersave0_seq);
       u8x8_d_ssd1607_200x200_first_init(u8x8);
-      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_to_display_seq);; // to setup LUT
+      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_lut_seq); // to setup LUT
+      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_to_display_seq);
       break;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
       if ( arg_int == 0 )
@@ -705,10 +724,12 @@ uint8_t u8x8_d_ssd1607_ws_200x200(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, vo
     case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
-      u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
+      if ( u8x8_d_helper_epaper_draw_tile(u8x8, arg_int, (u8x8_tile_t *)arg_ptr) )
+	u8x8_d_ssd1607_draw_tile(u8x8, arg_int, arg_ptr);
       break;
     case U8X8_MSG_DISPLAY_REFRESH:
-      u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_to_refresh_seq);
+      if ( u8x8_d_helper_epaper_refresh(u8x8, u8x8_d_ssd1607_ws_lut_seq) )
+	u8x8_cad_SendSequence(u8x8, u8x8_d_ssd1607_ws_to_refresh_seq);
       break;
     default:
       return 0;
@@ -35,10 +35,113 @@
   The ST7920 controller does not support hardware graphics flip.
   Contrast adjustment is done by an external resistor --> no support for contrast adjustment
   
+  Change-only update (Feb 2023)
+    Optional: With memory from u8x8_SetDisplayMemory() (U8X8_ST7920_MEM_SIZE bytes),
+    the driver keeps a copy of the graphics RAM (32 lines with 16 words of 16 pixel).
+    Only changed words are sent, the address is set at the first changed word 
+    of a run. Unchanged words between two changed words are sent, if this is 
+    cheaper than a new address (one word = two data bytes, new address = two commands).
+    Without this memory, all data is sent.
   
 */
 #include "u8x8.h"
 
+/* one line of the copy: two bytes with one valid bit per word, 32 bytes data */
+#define U8X8_ST7920_MEM_LINE 34
+
+/* returns the copy of the graphics RAM or NULL if not available */
+static uint8_t *u8x8_st7920_get_mem(u8x8_t *u8x8)
+{
+  if ( u8x8->display_mem_size < U8X8_ST7920_MEM_SIZE )
+    return NULL;
+  return (uint8_t *)u8x8->display_mem;
+}
+
+/* The following byte is sent to allow the ST7920 to sync up with the data */
+/* it solves some issues with garbage data */
+/* this is done only once per tile row and only if there is something to send */
+static void u8x8_st7920_sync(u8x8_t *u8x8, uint8_t *is_sync)
+{
+  if ( *is_sync == 0 )
+  {
+    u8x8_cad_SendCmd(u8x8, 0x03e );	/* enable extended mode */
+    u8x8_cad_SendCmd(u8x8, 0x03e );	/* enable extended mode, issue 487 */
+    *is_sync = 1;
+  }
+}
+
+/* returns 0 if word w of the line is already in the graphics RAM */
+static uint8_t u8x8_st7920_is_changed(uint8_t *line, uint8_t w, uint8_t *ptr)
+{
+  if ( (line[w>>3] & (1<<(w&7))) == 0 )
+    return 1;
+  if ( line[2+w*2] != ptr[0] || line[2+w*2+1] != ptr[1] )
+    return 1;
+  return 0;
+}
+
+/*
+  send one line of "c" bytes, starting at word x
+  without memory or with an odd number of bytes, the complete line is sent
+*/
+static void u8x8_st7920_send_line(u8x8_t *u8x8, uint8_t *mem, uint8_t *is_sync, uint8_t x, uint8_t y, uint8_t c, uint8_t *ptr)
+{
+  uint8_t w, cnt, start, end, pos;
+  uint8_t *line;
+  
+  if ( mem != NULL && y < 32 )
+  {
+    line = mem + (uint16_t)y*U8X8_ST7920_MEM_LINE;
+    cnt = c / 2;	/* number of words */
+    if ( (c & 1) == 0 && x + cnt <= 16 )
+    {
+      pos = 0;
+      while( pos < cnt )
+      {
+	/* find the next changed word */
+	if ( u8x8_st7920_is_changed(line, x+pos, ptr+pos*2) == 0 )
+	{
+	  pos++;
+	  continue;
+	}
+	
+	/* find the end of the run, include one unchanged word between two changed words */
+	start = pos;
+	end = pos+1;
+	for( w = pos+1; w < cnt; w++ )
+	{
+	  if ( u8x8_st7920_is_changed(line, x+w, ptr+w*2) )
+	    end = w+1;
+	  else if ( w > end )
+	    break;
+	}
+	
+	u8x8_st7920_sync(u8x8, is_sync);
+	u8x8_cad_SendCmd(u8x8, 0x080 | y );      /* y pos  */
+	u8x8_cad_SendCmd(u8x8, 0x080 | (x+start) );      /* set x pos */
+	u8x8_cad_SendData(u8x8, (end-start)*2, ptr+start*2);
+	
+	for( w = x+start; w < x+end; w++ )
+	{
+	  line[2+w*2] = ptr[(w-x)*2];
+	  line[2+w*2+1] = ptr[(w-x)*2+1];
+	  line[w>>3] |= 1<<(w&7);
+	}
+	pos = end;
+      }
+      return;
+    }
+    /* content of this line is not known any more */
+    line[0] = 0;
+    line[1] = 0;
+  }
+  u8x8_st7920_sync(u8x8, is_sync);
+  u8x8_cad_SendCmd(u8x8, 0x080 | y );      /* y pos  */
+  u8x8_cad_SendCmd(u8x8, 0x080 | x );      /* set x pos */
+  u8x8_cad_SendData(u8x8, c, ptr);	/* note: SendData can not handle more than 255 bytes, send one line of data */
+}
+
+
 
 
 static const uint8_t u8x8_d_st7920_init_seq[] = {
@@ -81,8 +184,8 @@ static const uint8_t u8x8_d_st7920_powersave1_seq[] = {
 
 uint8_t u8x8_d_st7920_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  uint8_t x, y, c, i;
-  uint8_t *ptr;
+  uint8_t x, y, c, i, is_sync;
+  uint8_t *ptr, *mem;
   switch(msg)
   {
     /* U8X8_MSG_DISPLAY_SETUP_MEMORY is handled by the calling function */
@@ -93,6 +196,13 @@ uint8_t u8x8_d_st7920_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
       u8x8_cad_SendSequence(u8x8, u8x8_d_st7920_init_seq);
+      mem = u8x8_st7920_get_mem(u8x8);
+      if ( mem != NULL )
+	for( i = 0; i < 32; i++ )
+	{
+	  mem[i*U8X8_ST7920_MEM_LINE] = 0;	/* clear the valid bits */
+	  mem[i*U8X8_ST7920_MEM_LINE+1] = 0;
+	}
       break;
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
       if ( arg_int == 0 )
@@ -126,19 +236,13 @@ uint8_t u8x8_d_st7920_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       */
       c = ((u8x8_tile_t *)arg_ptr)->cnt;	/* number of tiles */
       ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;	/* data ptr to the tiles */
-      /* The following byte is sent to allow the ST7920 to sync up with the data */
-      /* it solves some issues with garbage data */
-      u8x8_cad_SendCmd(u8x8, 0x03e );	/* enable extended mode */
-      u8x8_cad_SendCmd(u8x8, 0x03e );	/* enable extended mode, issue 487 */
+      mem = u8x8_st7920_get_mem(u8x8);
+      is_sync = 0;	/* send 0x03e before the first line */
       for( i = 0; i < 8; i++ )
       {
 	//u8x8_cad_SendCmd(u8x8, 0x03e );	/* enable extended mode */
-	u8x8_cad_SendCmd(u8x8, 0x080 | (y+i) );      /* y pos  */
-	u8x8_cad_SendCmd(u8x8, 0x080 | x );      /* set x pos */
-	c = ((u8x8_tile_t *)arg_ptr)->cnt;	/* number of tiles */
-
 	//u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, 200, NULL);	/* extra dely required */
-	u8x8_cad_SendData(u8x8, c, ptr);	/* note: SendData can not handle more than 255 bytes, send one line of data */
+	u8x8_st7920_send_line(u8x8, mem, &is_sync, x, y+i, c, ptr);
 	ptr += c;
 	//u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, 200, NULL);	/* extra dely required */
       }
@@ -35,10 +35,94 @@
   The t6963 controller does not support hardware graphics flip.
   Contrast adjustment is done by an external resistor --> no support for contrast adjustment
   
+  Text layer (u8x8_SetTextLayer)
+    The text RAM starts at the next 1K boundary after the graphics RAM, 
+    the CG RAM uses the next 2K block (offset register). Character codes 
+    0x80..0x9f are taken from the CG RAM at CG base + 0x400. 
+    For 240x128: text 0x1000, CG RAM 0x1800, requires 8K RAM.
+    The state of the text layer is stored in u8x8->display_flags.
   
 */
 #include "u8x8.h"
 
+#define U8X8_T6963_TEXT_LAYER 1		/* display_flags: graphics and text */
+#define U8X8_T6963_DISPLAY_ON 2		/* display_flags: power save is off */
+
+/* text home address: next 1K boundary after the graphics RAM */
+static uint16_t u8x8_t6963_get_text_home(u8x8_t *u8x8)
+{
+  uint16_t adr = u8x8->display_info->tile_width;
+  adr *= u8x8->display_info->tile_height;
+  adr *= 8;
+  return (adr + 0x3ff) & 0xfc00;
+}
+
+static void u8x8_t6963_set_adr(u8x8_t *u8x8, uint16_t adr)
+{
+  u8x8_cad_SendArg(u8x8, adr&255);
+  u8x8_cad_SendArg(u8x8, adr>>8);
+  u8x8_cad_SendCmd(u8x8, 0x024 );	/* set adr */
+}
+
+/* write cnt codes into the text RAM (auto write mode), code 0 is the space char */
+static void u8x8_t6963_send_codes(u8x8_t *u8x8, uint16_t cnt, const uint8_t *ptr)
+{
+  uint8_t buf[16];
+  uint8_t i, b;
+  while( cnt > 0 )
+  {
+    for( i = 0; i < sizeof(buf) && i < cnt; i++ )
+    {
+      /* the internal character generator starts with the space char at code 0 */
+      b = 0;
+      if ( ptr != NULL )
+      {
+	b = ptr[i];
+	if ( b < 0x020 )
+	  b = 0;
+	else if ( b < 0x080 )
+	  b -= 0x020;
+      }
+      buf[i] = b;
+    }
+    u8x8_cad_SendData(u8x8, i, buf);
+    cnt -= i;
+    if ( ptr != NULL )
+      ptr += i;
+  }
+}
+
+static void u8x8_t6963_set_text_layer(u8x8_t *u8x8, uint8_t is_enable)
+{
+  uint16_t adr, cnt;
+  if ( is_enable )
+    u8x8->display_flags |= U8X8_T6963_TEXT_LAYER;
+  else
+    u8x8->display_flags &= ~U8X8_T6963_TEXT_LAYER;
+  u8x8_cad_StartTransfer(u8x8);
+  if ( is_enable )
+  {
+    adr = u8x8_t6963_get_text_home(u8x8);
+    u8x8_cad_SendArg(u8x8, adr&255);
+    u8x8_cad_SendArg(u8x8, adr>>8);
+    u8x8_cad_SendCmd(u8x8, 0x040 );	/* set text home */
+    u8x8_cad_SendArg(u8x8, (adr>>11)+1);	/* CG RAM in the next 2K block */
+    u8x8_cad_SendArg(u8x8, 0);
+    u8x8_cad_SendCmd(u8x8, 0x022 );	/* set offset */
+    
+    /* clear text RAM, code 0 is the space char */
+    u8x8_t6963_set_adr(u8x8, adr);
+    u8x8_cad_SendCmd(u8x8, 0x0b0 );	/* auto write start */
+    cnt = u8x8->display_info->tile_width;
+    cnt *= u8x8->display_info->tile_height;
+    u8x8_t6963_send_codes(u8x8, cnt, NULL);
+    u8x8_cad_SendCmd(u8x8, 0x0b2 );	/* auto write reset */
+  }
+  if ( u8x8->display_flags & U8X8_T6963_DISPLAY_ON )
+    u8x8_cad_SendCmd(u8x8, is_enable ? 0x09c : 0x098 );	/* graphics on, text on/off */
+  u8x8_cad_EndTransfer(u8x8);
+}
+
 
 
 static const uint8_t u8x8_d_t6963_powersave0_seq[] = {
@@ -72,9 +156,51 @@ uint8_t u8x8_d_t6963_common(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
     */
     case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
       if ( arg_int == 0 )
-	u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_powersave0_seq);
+      {
+	u8x8->display_flags |= U8X8_T6963_DISPLAY_ON;
+	if ( u8x8->display_flags & U8X8_T6963_TEXT_LAYER )
+	{
+	  u8x8_cad_StartTransfer(u8x8);
+	  u8x8_cad_SendCmd(u8x8, 0x09c );	/* graphics on, text on */
+	  u8x8_cad_EndTransfer(u8x8);
+	}
+	else
+	  u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_powersave0_seq);
+      }
       else
+      {
+	u8x8->display_flags &= ~U8X8_T6963_DISPLAY_ON;
 	u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_powersave1_seq);
+      }
+      break;
+    case U8X8_MSG_DISPLAY_SET_TEXT_LAYER:
+      u8x8_t6963_set_text_layer(u8x8, arg_int);
+      break;
+    case U8X8_MSG_DISPLAY_DRAW_TEXT:
+      y = ((u8x8_tile_t *)arg_ptr)->y_pos;
+      y *= u8x8->display_info->tile_width;
+      y += ((u8x8_tile_t *)arg_ptr)->x_pos;
+      y += u8x8_t6963_get_text_home(u8x8);
+      c = ((u8x8_tile_t *)arg_ptr)->cnt;
+      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_t6963_set_adr(u8x8, y);
+      u8x8_cad_SendCmd(u8x8, 0x0b0 );	/* auto write start */
+      u8x8_t6963_send_codes(u8x8, c, ptr);
+      u8x8_cad_SendCmd(u8x8, 0x0b2 );	/* auto write reset */
+      u8x8_cad_EndTransfer(u8x8);
+      ((u8x8_tile_t *)arg_ptr)->cnt = 0;	/* handled */
+      break;
+    case U8X8_MSG_DISPLAY_LOAD_TEXT_GLYPH:
+      y = u8x8_t6963_get_text_home(u8x8);
+      y = ((y>>11)+1)<<11;		/* start of the CG RAM */
+      y += (uint16_t)arg_int*8;
+      u8x8_cad_StartTransfer(u8x8);
+      u8x8_t6963_set_adr(u8x8, y);
+      u8x8_cad_SendCmd(u8x8, 0x0b0 );	/* auto write start */
+      u8x8_cad_SendData(u8x8, 8, (uint8_t *)arg_ptr);
+      u8x8_cad_SendCmd(u8x8, 0x0b2 );	/* auto write reset */
+      u8x8_cad_EndTransfer(u8x8);
       break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
       y = (((u8x8_tile_t *)arg_ptr)->y_pos);
@@ -195,6 +321,7 @@ uint8_t u8x8_d_t6963_240x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_240x128_init_seq);
       break;
     default:
@@ -280,6 +407,7 @@ uint8_t u8x8_d_t6963_240x64(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_240x64_init_seq);
       break;
     default:
@@ -366,6 +494,7 @@ uint8_t u8x8_d_t6963_256x64(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_256x64_init_seq);
       break;
     default:
@@ -449,6 +578,7 @@ uint8_t u8x8_d_t6963_128x64(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_128x64_init_seq);
       break;
     default:
@@ -531,6 +661,7 @@ uint8_t u8x8_d_t6963_160x80(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_160x80_init_seq);
       break;
     default:
@@ -550,6 +681,7 @@ uint8_t u8x8_d_t6963_128x64_alt(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_160x80_init_seq);
       break;
     default:
@@ -633,6 +765,7 @@ uint8_t u8x8_d_t6963_128x128(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *a
       break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8x8);
+      u8x8->display_flags = 0;	/* text layer off, power save on */
       u8x8_cad_SendSequence(u8x8, u8x8_d_t6963_128x128_init_seq);
       break;
     default:
@@ -74,6 +74,9 @@ void u8x8_d_helper_display_init(u8x8_t *u8x8)
       u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_MILLI, u8x8->display_info->reset_pulse_width_ms);
       u8x8_gpio_SetReset(u8x8, 1);
       u8x8_gpio_Delay(u8x8, U8X8_MSG_DELAY_MILLI, u8x8->display_info->post_reset_wait_ms);
+      
+      /* 4) the init sequence will set the display start line to 0 */
+      u8x8->start_line = 0;
 }    
 
 /*==========================================*/
@@ -86,9 +89,40 @@ uint8_t u8x8_DrawTile(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *
   tile.y_pos = y;
   tile.cnt = cnt;
   tile.tile_ptr = tile_ptr;
+  u8x8_stats_add(u8x8, draw_tile_calls, 1);
+  u8x8_stats_add(u8x8, tiles_sent, cnt);
   return u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, (void *)&tile);
 }
 
+/* 
+  draw "rows" rows with "cnt" tiles each, use U8X8_MSG_DISPLAY_DRAW_FRAME if 
+  supported by the display, otherwise one U8X8_MSG_DISPLAY_DRAW_TILE per row
+*/
+void u8x8_DrawTileRows(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t rows, uint8_t *tile_ptr)
+{
+  u8x8_tile_t tile;
+  uint16_t offset;
+  tile.x_pos = x;
+  tile.y_pos = y;
+  tile.cnt = cnt;
+  tile.tile_ptr = tile_ptr;
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_FRAME, rows, (void *)&tile);
+  if ( tile.cnt == 0 )
+  {
+    u8x8_stats_add(u8x8, tiles_sent, (uint32_t)cnt*rows);
+    return;
+  }
+  offset = cnt;
+  offset *= 8;
+  while( rows > 0 )
+  {
+    u8x8_DrawTile(u8x8, x, y, cnt, tile_ptr);
+    tile_ptr += offset;
+    y++;
+    rows--;
+  }
+}
+
 /* should be implemented as macro */
 void u8x8_SetupMemory(u8x8_t *u8x8)
 {
@@ -158,6 +192,58 @@ void u8x8_RefreshDisplay(u8x8_t *u8x8)
   u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_REFRESH, 0, NULL);  
 }
 
+/*
+  Some display procedures can use additional memory, for example to remember
+  the content of the display RAM. The memory is provided by the application,
+  so that each display has its own state. The required size is
+  described in the display procedure. If "size" is too small, the display
+  procedure ignores the memory. Call this before u8x8_InitDisplay() (begin()),
+  the memory must be valid as long as the display is used. mem = NULL
+  removes the memory. The memory is cleared here.
+*/
+void u8x8_SetDisplayMemory(u8x8_t *u8x8, void *mem, uint16_t size)
+{
+  uint16_t i;
+  if ( mem == NULL )
+    size = 0;
+  for( i = 0; i < size; i++ )
+    ((uint8_t *)mem)[i] = 0;
+  u8x8->display_mem = mem;
+  u8x8->display_mem_size = size;
+}
+
+void u8x8_ToggleVCOM(u8x8_t *u8x8)
+{
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_TOGGLE_VCOM, 0, NULL);  
+}
+
+void u8x8_SetTextLayer(u8x8_t *u8x8, uint8_t is_enable)
+{
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_SET_TEXT_LAYER, is_enable, NULL);  
+}
+
+/* returns 1 if the display supports the start line command */
+uint8_t u8x8_SetDisplayStartLine(u8x8_t *u8x8, uint8_t line)
+{
+  uint8_t is_supported = 0;
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_SET_START_LINE, line, (void *)&is_supported);  
+  return is_supported;
+}
+
+/* returns 1 if the codes have been written to the text RAM of the display */
+uint8_t u8x8_DrawTextLayer(u8x8_t *u8x8, uint8_t x, uint8_t y, uint8_t cnt, uint8_t *codes)
+{
+  u8x8_tile_t tile;
+  if ( cnt == 0 )
+    return 1;
+  tile.x_pos = x;
+  tile.y_pos = y;
+  tile.cnt = cnt;
+  tile.tile_ptr = codes;
+  u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TEXT, 0, (void *)&tile);
+  return tile.cnt == 0;
+}
+
 void u8x8_ClearDisplayWithTile(u8x8_t *u8x8, const uint8_t *buf)
 {
   u8x8_tile_t tile;
@@ -171,6 +257,8 @@ void u8x8_ClearDisplayWithTile(u8x8_t *u8x8, const uint8_t *buf)
   tile.y_pos = 0;
   do
   {
+    u8x8_stats_add(u8x8, draw_tile_calls, 1);
+    u8x8_stats_add(u8x8, tiles_sent, u8x8->display_info->tile_width);
     u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, u8x8->display_info->tile_width, (void *)&tile);
     tile.y_pos++;
   } while( tile.y_pos < h );
@@ -198,6 +286,8 @@ void u8x8_ClearLine(u8x8_t *u8x8, uint8_t line)
     tile.y_pos = line;
     tile.cnt = 1;
     tile.tile_ptr = (uint8_t *)buf;		/* tile_ptr should be const, but isn't */
+    u8x8_stats_add(u8x8, draw_tile_calls, 1);
+    u8x8_stats_add(u8x8, tiles_sent, u8x8->display_info->tile_width);
     u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, u8x8->display_info->tile_width, (void *)&tile);
   }  
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+/*
+
+  u8x8_epaper.c
+  
+  partial refresh manager for the SSD1607 and IL3820 e-paper controller
+
+  Universal 8bit Graphics Library (https://github.com/olikraus/u8g2/)
+
+  Copyright (c) 2023, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+  The manager is disabled by default. It is enabled with
+    // must be valid as long as the display is used
+    static uint8_t mem[U8X8_EPAPER_MEM_SIZE(200, 200)];
+    u8x8_SetEPaperPartialRefresh(u8x8, mem, sizeof(mem), partial_limit, area_percent)
+  
+  If enabled:
+    - The content of each complete tile row is stored in the memory. Tile rows 
+      which did not change are not transfered to the display RAM.
+    - The refresh message will do nothing if no tile row has been changed.
+    - Otherwise the partial update LUT is used, unless
+	- "partial_limit" partial refreshes have been done since the last full refresh or
+	- at least "area_percent" of the tile rows have been changed.
+      In both cases a full refresh is done to remove ghosting.
+
+  The controller has two RAM areas, which are toggled with each refresh. 
+  A tile row, which was changed before the last refresh, must be written 
+  again after the refresh (bit 1 of the state), so that both RAM areas have 
+  the same content. This requires, that the complete buffer is sent 
+  (u8g2_SendBuffer or the page loop) before each refresh. 
+  
+  The state and the tile rows are stored in the display memory 
+  (u8x8_SetDisplayMemory), so each display has its own state. The memory 
+  starts with u8x8_epaper_t, followed by the tile rows (tile_width*8 bytes 
+  each).
+
+*/
+
+#include "u8x8.h"
+
+#define U8X8_EPAPER_CHANGED 1		/* tile row has been changed since the last refresh */
+#define U8X8_EPAPER_REWRITE 2		/* tile row must be written again after the refresh */
+#define U8X8_EPAPER_VALID 4		/* tile row content in the memory is valid */
+
+
+/* partial update LUT for SSD1607 and IL3820 (Waveshare) */
+static const uint8_t u8x8_d_epaper_partial_lut_seq[] = {
+  U8X8_START_TRANSFER(),             	/* enable chip, delay is part of the transfer start */
+  U8X8_C(0x32),	/* write LUT register*/
+  U8X8_A(0x10), U8X8_A(0x18), U8X8_A(0x18), U8X8_A(0x08), U8X8_A(0x18),
+  U8X8_A(0x18), U8X8_A(0x08), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), 
+  U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), 
+  U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), 
+  /* Timing part of the LUT, 20 Phases with 4 bit each: 10 bytes */
+  U8X8_A(0x13), U8X8_A(0x14), U8X8_A(0x44), U8X8_A(0x12), U8X8_A(0x00), 
+  U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00), U8X8_A(0x00),
+  U8X8_END_TRANSFER(),             	/* disable chip */
+  U8X8_END()             			/* end of sequence */
+};
+
+static const uint8_t u8x8_d_epaper_partial_refresh_seq[] = {
+  U8X8_START_TRANSFER(),             	/* enable chip, delay is part of the transfer start */
+  U8X8_CA(0x22, 0x04),	/* display update seq. option: pattern display, assumes clk and charge pump are enabled  */
+  U8X8_C(0x20),	/* execute sequence */
+  U8X8_DLY(250),	/* the partial LUT has 20 frames instead of about 60 frames */
+  U8X8_DLY(250),
+  U8X8_END_TRANSFER(),             	/* disable chip */
+  U8X8_END()             			/* end of sequence */
+};
+
+/* returns the state of this display or NULL if there is no state */
+static u8x8_epaper_t *u8x8_epaper_get(u8x8_t *u8x8)
+{
+  const u8x8_display_info_t *info = u8x8->display_info;
+  if ( info == NULL || u8x8->display_mem_size < U8X8_EPAPER_MEM_SIZE(info->pixel_width, info->pixel_height) )
+    return NULL;
+  return (u8x8_epaper_t *)u8x8->display_mem;
+}
+
+/* nothing is known about the RAM content */
+static void u8x8_epaper_clear_state(u8x8_epaper_t *epaper)
+{
+  uint8_t i;
+  for( i = 0; i < U8X8_EPAPER_MAX_ROWS; i++ )
+    epaper->state[i] = U8X8_EPAPER_CHANGED | U8X8_EPAPER_REWRITE;
+  epaper->partial_cnt = 0;
+  epaper->is_partial_lut = 0;
+}
+
+/*
+  mem: State of the manager and content of the tile rows for this display, must be valid 
+    as long as the display is used, size must be U8X8_EPAPER_MEM_SIZE(pixel_width, pixel_height)
+    NULL disables the manager (same as partial_limit = 0 with the current state)
+  partial_limit: Number of partial refreshes before a full refresh is forced, 0 disables the manager
+  area_percent: Do a full refresh if this percentage of tile rows has been changed
+  Must be called after the setup procedure, the manager is not enabled if size is too small.
+*/
+void u8x8_SetEPaperPartialRefresh(u8x8_t *u8x8, void *mem, uint16_t size, uint8_t partial_limit, uint8_t area_percent)
+{
+  u8x8_epaper_t *epaper;
+  if ( mem != NULL && (mem != u8x8->display_mem || size != u8x8->display_mem_size) )
+    u8x8_SetDisplayMemory(u8x8, mem, size);
+  epaper = u8x8_epaper_get(u8x8);
+  if ( epaper == NULL )
+    return;
+  if ( mem == NULL )
+  {
+    /* keep the state, the next full refresh must restore the full LUT */
+    epaper->partial_limit = 0;
+    return;
+  }
+  if ( epaper->partial_limit == 0 )
+  {
+    /* new or disabled before, might be called after the init: start with a full refresh, which also restores the full LUT */
+    u8x8_epaper_clear_state(epaper);
+    epaper->partial_cnt = 255;
+    epaper->is_partial_lut = 1;
+  }
+  epaper->partial_limit = partial_limit;
+  epaper->area_percent = area_percent;
+}
+
+/* called from DISPLAY_INIT: nothing is known about the RAM content */
+void u8x8_d_helper_epaper_init(u8x8_t *u8x8)
+{
+  u8x8_epaper_t *epaper = u8x8_epaper_get(u8x8);
+  if ( epaper != NULL )
+    u8x8_epaper_clear_state(epaper);
+}
+
+/*
+  called from DISPLAY_DRAW_TILE
+  returns 0 if the tiles can be skipped, because they are already in the RAM
+*/
+uint8_t u8x8_d_helper_epaper_draw_tile(u8x8_t *u8x8, uint8_t arg_int, u8x8_tile_t *tile)
+{
+  u8x8_epaper_t *epaper = u8x8_epaper_get(u8x8);
+  uint8_t y = tile->y_pos;
+  uint8_t state, is_same;
+  uint16_t i, len;
+  uint8_t *row;
+  
+  if ( epaper == NULL || epaper->partial_limit == 0 )
+    return 1;
+  if ( y >= U8X8_EPAPER_MAX_ROWS )
+    return 1;
+  
+  state = epaper->state[y];
+  if ( tile->x_pos != 0 || tile->cnt != u8x8->display_info->tile_width || arg_int != 1 )
+  {
+    /* part of a tile row (u8x8 API): always changed */
+    epaper->state[y] = U8X8_EPAPER_CHANGED;
+    return 1;
+  }
+  
+  /* compare with the stored tile row and update it */
+  len = (uint16_t)tile->cnt*8;
+  row = (uint8_t *)(epaper+1) + y*len;
+  is_same = (state & U8X8_EPAPER_VALID) ? 1 : 0;
+  for( i = 0; i < len; i++ )
+  {
+    if ( row[i] != tile->tile_ptr[i] )
+    {
+      row[i] = tile->tile_ptr[i];
+      is_same = 0;
+    }
+  }
+  if ( is_same == 0 )
+    state |= U8X8_EPAPER_CHANGED;
+  else if ( (state & U8X8_EPAPER_REWRITE) == 0 )
+    return 0;		/* same content in both RAM areas */
+  
+  epaper->state[y] = (state & ~U8X8_EPAPER_REWRITE) | U8X8_EPAPER_VALID;
+  return 1;
+}
+
+/*
+  called from DISPLAY_REFRESH
+  full_lut_seq: Sequence, which writes the full update LUT of the display.
+    NULL, if the full refresh sequence of the display procedure already 
+    writes the LUT register (0x32).
+  returns 1 if the display procedure must do the (full) refresh
+  returns 0 if the refresh has been done or is not required
+*/
+uint8_t u8x8_d_helper_epaper_refresh(u8x8_t *u8x8, const uint8_t *full_lut_seq)
+{
+  u8x8_epaper_t *epaper = u8x8_epaper_get(u8x8);
+  uint8_t i, rows, changed;
+  
+  if ( epaper == NULL )
+    return 1;
+  if ( epaper->partial_limit == 0 )
+  {
+    /* manager has been disabled after a partial refresh */
+    if ( epaper->is_partial_lut != 0 && full_lut_seq != NULL )
+      u8x8_cad_SendSequence(u8x8, full_lut_seq);
+    epaper->is_partial_lut = 0;
+    return 1;
+  }
+  
+  rows = u8x8->display_info->tile_height;
+  if ( rows > U8X8_EPAPER_MAX_ROWS )
+    rows = U8X8_EPAPER_MAX_ROWS;
+  
+  changed = 0;
+  for( i = 0; i < rows; i++ )
+  {
+    if ( epaper->state[i] & U8X8_EPAPER_CHANGED )
+    {
+      changed++;
+      /* the other RAM area still has the old content */
+      epaper->state[i] = (epaper->state[i] & ~U8X8_EPAPER_CHANGED) | U8X8_EPAPER_REWRITE;
+    }
+  }
+  
+  if ( changed == 0 )
+    return 0;
+  
+  if ( epaper->partial_cnt >= epaper->partial_limit || 
+	(uint16_t)changed*100 >= (uint16_t)rows*epaper->area_percent )
+  {
+    /* restore the full update LUT, if the partial LUT has been loaded before */
+    if ( epaper->is_partial_lut != 0 && full_lut_seq != NULL )
+      u8x8_cad_SendSequence(u8x8, full_lut_seq);
+    epaper->partial_cnt = 0;
+    epaper->is_partial_lut = 0;
+    return 1;
+  }
+  
+  if ( epaper->is_partial_lut == 0 )
+  {
+    u8x8_cad_SendSequence(u8x8, u8x8_d_epaper_partial_lut_seq);
+    epaper->is_partial_lut = 1;
+  }
+  u8x8_cad_SendSequence(u8x8, u8x8_d_epaper_partial_refresh_seq);
+  epaper->partial_cnt++;
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+
+  u8x8_gray4.c
+  
+  1 bit to 4 bit gray scale conversion for the SSD1322, SSD1327 and SSD1362
+
+  Universal 8bit Graphics Library (https://github.com/olikraus/u8g2/)
+
+  Copyright (c) 2023, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+  These controller expect one tile row as a column window with 8 rows,
+  each row has 4 bits per pixel. The u8x8 tiles are vertical bytes, so 
+  each tile is transposed first (8 bytes --> 8 pixel rows). Then each 
+  pixel row is expanded with a lookup table into the row buffer.
+  Finally the complete buffer is sent as one data block for a column 
+  window which covers all tiles.
+
+  The row buffer is the memory from u8x8_SetDisplayMemory(), if it is larger 
+  than U8X8_GRAY4_BUF_SIZE (u8x8.h). U8X8_GRAY4_MEM_SIZE() bytes are 
+  required for a complete tile row. Otherwise a small static buffer 
+  (U8X8_GRAY4_BUF_SIZE bytes) is used, which is shared by all displays.
+  The caller must not use more than u8x8_d_helper_gray4_max_tiles() tiles.
+
+*/
+
+#include "u8x8.h"
+
+static uint8_t u8x8_gray4_buf[U8X8_GRAY4_BUF_SIZE];
+
+/* returns the row buffer and its size */
+static uint8_t *u8x8_gray4_get_buf(u8x8_t *u8x8, uint16_t *size)
+{
+  if ( u8x8->display_mem_size > U8X8_GRAY4_BUF_SIZE )
+  {
+    *size = u8x8->display_mem_size;
+    return (uint8_t *)u8x8->display_mem;
+  }
+  *size = U8X8_GRAY4_BUF_SIZE;
+  return u8x8_gray4_buf;
+}
+
+/* 
+  max number of tiles for u8x8_d_helper_gray4_send_tiles(), bytes_per_tile is 4 or 8 (is_narrow) 
+  the result is limited, so that the width argument fits into 8 bit
+*/
+uint8_t u8x8_d_helper_gray4_max_tiles(u8x8_t *u8x8, uint8_t bytes_per_tile)
+{
+  uint16_t size;
+  uint16_t n;
+  u8x8_gray4_get_buf(u8x8, &size);
+  n = size/8/bytes_per_tile;
+  if ( n > 255/bytes_per_tile )
+    n = 255/bytes_per_tile;
+  return n;
+}
+
+/* two pixel per byte, lower bit (left pixel) goes to the upper nibble */
+static const uint8_t u8x8_gray4_wide_lut[16][2] = 
+{
+  { 0x00, 0x00 }, { 0xf0, 0x00 }, { 0x0f, 0x00 }, { 0xff, 0x00 },
+  { 0x00, 0xf0 }, { 0xf0, 0xf0 }, { 0x0f, 0xf0 }, { 0xff, 0xf0 },
+  { 0x00, 0x0f }, { 0xf0, 0x0f }, { 0x0f, 0x0f }, { 0xff, 0x0f },
+  { 0x00, 0xff }, { 0xf0, 0xff }, { 0x0f, 0xff }, { 0xff, 0xff }
+};
+
+/*
+  transpose one tile: bit r of ptr[k] will be bit k of dest[r]
+*/
+static void u8x8_gray4_transpose(uint8_t *dest, const uint8_t *ptr)
+{
+  uint32_t x, y, t;
+  
+  x = ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+  y = ptr[4] | ((uint32_t)ptr[5] << 8) | ((uint32_t)ptr[6] << 16) | ((uint32_t)ptr[7] << 24);
+  
+  /* swap 1x1 blocks */
+  t = (x ^ (x >> 7)) & 0x00AA00AAUL;  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AAUL;  y = y ^ t ^ (t << 7);
+  /* swap 2x2 blocks */
+  t = (x ^ (x >> 14)) & 0x0000CCCCUL;  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCCUL;  y = y ^ t ^ (t << 14);
+  /* swap 4x4 blocks */
+  t = (x & 0x0F0F0F0FUL) | ((y & 0x0F0F0F0FUL) << 4);
+  y = ((x >> 4) & 0x0F0F0F0FUL) | (y & 0xF0F0F0F0UL);
+  x = t;
+  
+  dest[0] = x; dest[1] = x >> 8; dest[2] = x >> 16; dest[3] = x >> 24;
+  dest[4] = y; dest[5] = y >> 8; dest[6] = y >> 16; dest[7] = y >> 24;
+}
+
+/*
+  Expand the tiles at "ptr" (8 bytes each) and send them as 8 rows with "width" bytes.
+  The caller must set the column/row window and must issue the write to ram 
+  command, if required by the controller.
+  is_narrow == 0: Each tile has 4 bytes per row (two pixel per byte)
+  is_narrow != 0: Each tile has 8 bytes per row (one pixel per byte, only every 
+    second pixel is used, 128x64 NHD OLED)
+  For cnt tiles, "width" is usually cnt*4 (or cnt*8), but can be smaller to clip 
+  the last tile. cnt must not exceed u8x8_d_helper_gray4_max_tiles(u8x8, 4) (or 8).
+*/
+void u8x8_d_helper_gray4_send_tiles(u8x8_t *u8x8, uint8_t *ptr, uint8_t width, uint8_t is_narrow)
+{
+  uint8_t rows[8];
+  uint8_t out[8];
+  uint8_t bytes_per_tile = is_narrow ? 8 : 4;
+  uint8_t pos, r, i, n, v;
+  uint16_t len;
+  uint8_t *buf;
+  uint8_t *dest;
+  
+  buf = u8x8_gray4_get_buf(u8x8, &len);
+  for( pos = 0; pos < width; pos += bytes_per_tile )
+  {
+    u8x8_gray4_transpose(rows, ptr);
+    ptr += 8;
+    n = width - pos;
+    if ( n > bytes_per_tile )
+      n = bytes_per_tile;
+    dest = buf + pos;
+    for( r = 0; r < 8; r++ )
+    {
+      v = rows[r];
+      if ( is_narrow )
+      {
+	for( i = 0; i < 8; i++ )
+	{
+	  out[i] = (v & 1) ? 0xff : 0x00;
+	  v >>= 1;
+	}
+      }
+      else
+      {
+	out[0] = u8x8_gray4_wide_lut[v & 15][0];
+	out[1] = u8x8_gray4_wide_lut[v & 15][1];
+	out[2] = u8x8_gray4_wide_lut[v >> 4][0];
+	out[3] = u8x8_gray4_wide_lut[v >> 4][1];
+      }
+      for( i = 0; i < n; i++ )
+	dest[i] = out[i];
+      dest += width;
+    }
+  }
+  
+  /* send the row buffer, u8x8_cad_SendData accepts up to 255 bytes */
+  dest = buf;
+  len = (uint16_t)width * 8;
+  while( len > 0 )
+  {
+    n = 255;
+    if ( len < 255 )
+      n = len;
+    u8x8_cad_SendData(u8x8, n, dest);
+    dest += n;
+    len -= n;
+  }
+}
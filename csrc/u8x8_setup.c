@@ -105,6 +105,11 @@ void u8x8_SetupDefaults(u8x8_t *u8x8)
     u8x8->bus_clock = 0;		/* issue 769 */
     u8x8->i2c_address = 255;
     u8x8->debounce_default_pin_state = 255;	/* assume all low active buttons */
+    u8x8->display_mem = NULL;
+    u8x8->display_mem_size = 0;
+    u8x8->display_flags = 0;
+    u8x8->start_line = 0;
+    u8x8->cad_state = 0;
   
 #ifdef U8X8_USE_PINS 
   {
@@ -113,6 +118,9 @@ void u8x8_SetupDefaults(u8x8_t *u8x8)
       u8x8->pins[i] = U8X8_PIN_NONE;
   }
 #endif
+#ifdef U8X8_WITH_STATS
+  u8x8_ResetStats(u8x8);
+#endif
 }
 
 
@@ -145,3 +153,24 @@ void u8x8_Setup(u8x8_t *u8x8, u8x8_msg_cb display_cb, u8x8_msg_cb cad_cb, u8x8_m
   u8x8_SetupMemory(u8x8);
 }
 
+
+#ifdef U8X8_WITH_STATS
+/*
+  Description:
+    Copy the statistic counters of u8x8 to "stats". The counters continue 
+    to count, use u8x8_ResetStats() to start a new measurement (e.g. for
+    each screen).
+*/
+void u8x8_GetStats(u8x8_t *u8x8, u8x8_stats_t *stats)
+{
+  *stats = u8x8->stats;
+}
+
+void u8x8_ResetStats(u8x8_t *u8x8)
+{
+  u8x8->stats.draw_tile_calls = 0;
+  u8x8->stats.tiles_sent = 0;
+  u8x8->stats.cad_cmds = 0;
+  u8x8->stats.cad_data_bytes = 0;
+}
+#endif /* U8X8_WITH_STATS */
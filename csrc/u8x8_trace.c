@@ -0,0 +1,230 @@
+/*
+
+  u8x8_trace.c
+  
+  record the traffic of the byte procedure
+  
+  Universal 8bit Graphics Library (https://github.com/olikraus/u8g2/)
+
+  Copyright (c) 2023, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+  u8x8_ConnectTrace() inserts u8x8_byte_trace() in front of the byte procedure
+  and u8x8_d_trace() in front of the display procedure. All messages are 
+  written as records into the trace buffer. If the buffer is full, the flush 
+  procedure is called (for example to write the buffer into a file). Without 
+  flush procedure, further records are dropped.
+  Only one u8x8 object can be traced at a time: u8x8_ConnectTrace() returns 0 
+  while another object is connected.
+  
+  Trace format (all values little endian):
+    header: 'U' '8' 'T' 'R' version(=2) 0 0 0
+    records:
+      type (1 byte)	U8X8_MSG_BYTE_xxx, U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_xxx 
+			or U8X8_TRACE_FRAME
+      time (4 bytes)	result of get_time()
+      arg (1 byte)	arg_int of the message
+      payload		U8X8_MSG_BYTE_SEND: arg bytes
+				U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE: x_pos, y_pos, cnt (3 bytes)
+				U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME: x_pos, y_pos, cnt (3 bytes)
+  
+  The numbers of byte and display messages overlap (e.g. U8X8_MSG_BYTE_INIT 
+  and U8X8_MSG_DISPLAY_DRAW_TEXT), so display records have U8X8_TRACE_DISPLAY 
+  in the type. Display messages generate two records: The message itself when 
+  the display procedure is called and U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|msg 
+  after the display procedure has finished. For U8X8_MSG_DISPLAY_DRAW_FRAME, arg of the U8X8_TRACE_DONE 
+  record is 0 if the display did not handle the message.
+
+*/
+
+#include "u8x8.h"
+
+/* only one trace at a time, see also u8x8_capture.c */
+static u8x8_trace_t *u8x8_trace_current = NULL;
+
+static void u8x8_trace_put_u8(u8x8_trace_t *trace, uint8_t b)
+{
+  trace->buf[trace->pos] = b;
+  trace->pos++;
+}
+
+/* make room for cnt bytes, return 0 if not possible */
+static uint8_t u8x8_trace_reserve(u8x8_trace_t *trace, uint16_t cnt)
+{
+  if ( trace->pos + cnt <= trace->size )
+    return 1;
+  u8x8_trace_Flush(trace);
+  if ( trace->pos + cnt <= trace->size )
+    return 1;
+  trace->dropped += cnt;
+  return 0;
+}
+
+static void u8x8_trace_record(u8x8_trace_t *trace, uint8_t type, uint8_t arg, uint8_t cnt, const uint8_t *payload)
+{
+  uint32_t t = 0;
+  if ( u8x8_trace_reserve(trace, U8X8_TRACE_RECORD_SIZE + cnt) == 0 )
+    return;
+  if ( trace->get_time != NULL )
+    t = trace->get_time();
+  u8x8_trace_put_u8(trace, type);
+  u8x8_trace_put_u8(trace, t & 255);
+  u8x8_trace_put_u8(trace, (t >> 8) & 255);
+  u8x8_trace_put_u8(trace, (t >> 16) & 255);
+  u8x8_trace_put_u8(trace, (t >> 24) & 255);
+  u8x8_trace_put_u8(trace, arg);
+  while( cnt > 0 )
+  {
+    u8x8_trace_put_u8(trace, *payload);
+    payload++;
+    cnt--;
+  }
+}
+
+/* 
+  buf must have at least U8X8_TRACE_HEADER_SIZE+U8X8_TRACE_RECORD_SIZE+1 bytes, 
+  get_time and flush might be NULL
+*/
+void u8x8_trace_Init(u8x8_trace_t *trace, uint8_t *buf, uint16_t size, uint32_t (*get_time)(void), void (*flush)(const uint8_t *data, uint16_t cnt))
+{
+  trace->byte_cb = NULL;
+  trace->display_cb = NULL;
+  trace->get_time = get_time;
+  trace->flush = flush;
+  trace->buf = buf;
+  trace->size = size;
+  trace->pos = 0;
+  trace->dropped = 0;
+  u8x8_trace_put_u8(trace, 'U');
+  u8x8_trace_put_u8(trace, '8');
+  u8x8_trace_put_u8(trace, 'T');
+  u8x8_trace_put_u8(trace, 'R');
+  u8x8_trace_put_u8(trace, U8X8_TRACE_VERSION);
+  u8x8_trace_put_u8(trace, 0);
+  u8x8_trace_put_u8(trace, 0);
+  u8x8_trace_put_u8(trace, 0);
+}
+
+/* pass the current buffer content to the flush procedure */
+void u8x8_trace_Flush(u8x8_trace_t *trace)
+{
+  if ( trace->flush == NULL || trace->pos == 0 )
+    return;
+  trace->flush(trace->buf, trace->pos);
+  trace->pos = 0;
+}
+
+/* mark the end of a frame, optional, u8x8trace will guess the frames otherwise */
+void u8x8_trace_MarkFrame(u8x8_trace_t *trace)
+{
+  u8x8_trace_record(trace, U8X8_TRACE_FRAME, 0, 0, NULL);
+}
+
+uint8_t u8x8_byte_trace(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_trace_t *trace = u8x8_trace_current;
+  uint8_t *data;
+  uint8_t cnt;
+  uint8_t max;
+  
+  if ( msg == U8X8_MSG_BYTE_SEND )
+  {
+    /* split the payload, if the trace buffer is very small */
+    max = 255;
+    if ( trace->size - U8X8_TRACE_RECORD_SIZE < max )
+      max = trace->size - U8X8_TRACE_RECORD_SIZE;
+    data = (uint8_t *)arg_ptr;
+    cnt = arg_int;
+    while( cnt > max )
+    {
+      u8x8_trace_record(trace, msg, max, max, data);
+      data += max;
+      cnt -= max;
+    }
+    u8x8_trace_record(trace, msg, cnt, cnt, data);
+  }
+  else
+  {
+    u8x8_trace_record(trace, msg, arg_int, 0, NULL);
+  }
+  return trace->byte_cb(u8x8, msg, arg_int, arg_ptr);
+}
+
+uint8_t u8x8_d_trace(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_trace_t *trace = u8x8_trace_current;
+  uint8_t tile[3];
+  uint8_t result;
+  
+  if ( msg == U8X8_MSG_DISPLAY_DRAW_TILE || msg == U8X8_MSG_DISPLAY_DRAW_FRAME )
+  {
+    tile[0] = ((u8x8_tile_t *)arg_ptr)->x_pos;
+    tile[1] = ((u8x8_tile_t *)arg_ptr)->y_pos;
+    tile[2] = ((u8x8_tile_t *)arg_ptr)->cnt;
+    u8x8_trace_record(trace, U8X8_TRACE_DISPLAY|msg, arg_int, 3, tile);
+  }
+  else
+  {
+    u8x8_trace_record(trace, U8X8_TRACE_DISPLAY|msg, arg_int, 0, NULL);
+  }
+  result = trace->display_cb(u8x8, msg, arg_int, arg_ptr);
+  if ( msg == U8X8_MSG_DISPLAY_DRAW_FRAME && ((u8x8_tile_t *)arg_ptr)->cnt != 0 )
+    arg_int = 0;	/* not handled, rows are sent with U8X8_MSG_DISPLAY_DRAW_TILE */
+  u8x8_trace_record(trace, U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|msg, arg_int, 0, NULL);
+  return result;
+}
+
+/* 
+  call this after u8x8_Setup() or u8g2_Setup_xxx() 
+  returns 0 if the trace is already used by another u8x8 object
+*/
+uint8_t u8x8_ConnectTrace(u8x8_t *u8x8, u8x8_trace_t *trace)
+{
+  if ( u8x8->byte_cb == u8x8_byte_trace )
+    return 1;	/* do nothing, trace already installed */
+  if ( u8x8_trace_current != NULL )
+    return 0;	/* the other object would use the procedures of this object */
+  trace->byte_cb = u8x8->byte_cb;
+  trace->display_cb = u8x8->display_cb;
+  u8x8_trace_current = trace;
+  u8x8->byte_cb = u8x8_byte_trace;
+  u8x8->display_cb = u8x8_d_trace;
+  return 1;
+}
+
+/* restore the original procedures and flush the remaining records */
+void u8x8_DisconnectTrace(u8x8_t *u8x8)
+{
+  u8x8_trace_t *trace = u8x8_trace_current;
+  if ( u8x8->byte_cb != u8x8_byte_trace )
+    return;
+  u8x8->byte_cb = trace->byte_cb;
+  u8x8->display_cb = trace->display_cb;
+  u8x8_trace_Flush(trace);
+  u8x8_trace_current = NULL;
+}
@@ -0,0 +1,79 @@
+/*
+ * Run four displays on two hardware I2C buses from one thread. The frames
+ * are transferred by one worker thread for each bus (see u8g2worker.c), so
+ * drawing does not wait for the bus and a slow display does not block the
+ * other displays.
+ */
+
+#include "u8g2port.h"
+
+#define DISPLAY_CNT 4
+#define FRAME_CNT 600
+
+// I2C bus and address of each display, the SSD1306 supports 0x3c and 0x3d
+struct display {
+	uint8_t bus;
+	uint8_t address;
+};
+
+typedef struct display display_t;
+
+static const display_t displays[DISPLAY_CNT] = {
+	{ 0, 0x3c * 2 }, { 0, 0x3d * 2 },
+	{ 1, 0x3c * 2 }, { 1, 0x3d * 2 } };
+
+int main(void) {
+	u8g2_t u8g2[DISPLAY_CNT];
+	worker_stats_t stats;
+	unsigned long long next;
+	uint8_t w, h;
+	int i, j;
+
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		// Change setup function call as needed to support your display
+		u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2[i], U8G2_R0,
+				u8x8_byte_arm_linux_hw_i2c, u8x8_arm_linux_gpio_and_delay);
+		init_i2c_hw(&u8g2[i], displays[i].bus);
+		u8g2_SetI2CAddress(&u8g2[i], displays[i].address);
+		u8g2_InitDisplay(&u8g2[i]);
+		u8g2_SetPowerSave(&u8g2[i], 0);
+		// From now on, frames are sent with submit_frame()
+		if (init_display_worker(&u8g2[i]) == 0) {
+			fprintf(stderr, "Display %d: init_display_worker() failed\n", i);
+			return 1;
+		}
+	}
+
+	// Move a box on each display with 50 frames per second
+	next = get_time_ns();
+	for (j = 0; j < FRAME_CNT; ++j) {
+		for (i = 0; i < DISPLAY_CNT; ++i) {
+			w = u8g2_GetDisplayWidth(&u8g2[i]);
+			h = u8g2_GetDisplayHeight(&u8g2[i]);
+			u8g2_ClearBuffer(&u8g2[i]);
+			u8g2_DrawFrame(&u8g2[i], 0, 0, w, h);
+			u8g2_DrawBox(&u8g2[i], (j + i * 8) % (w - 8), (j / 2 + i * 4) % (h - 8), 8, 8);
+			submit_frame(&u8g2[i]);
+		}
+		next += 20000000ULL;
+		delay_until_ns(next, DELAY_SPIN_THRESHOLD_NS);
+	}
+
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		flush_frames(&u8g2[i]);
+		get_worker_stats(&u8g2[i], &stats);
+		printf("Display %d: %lu frames sent, %lu frames skipped, %lu tile rows\n",
+				i, stats.frames_sent, stats.frames_skipped, stats.rows_sent);
+	}
+	// Stop the bus workers before the displays are used directly again
+	done_workers();
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		u8g2_SetPowerSave(&u8g2[i], 1);
+		done_user_data(&u8g2[i]);
+	}
+	// Close and deallocate i2c_t
+	done_i2c();
+	printf("Done\n");
+
+	return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * Self test of the bus workers without hardware: Two SSD1306 displays with
+ * the I2C cad procedure are connected to a recording byte procedure on two
+ * different buses. The frames are sent once from the main thread (one
+ * display after the other) and then in parallel by the two bus workers
+ * (see u8g2worker.c). The bytes of each bus must be identical in both runs.
+ *
+ * Each frame changes every tile row, so the worker sends all rows like the
+ * main thread.
+ */
+
+#include "u8g2port.h"
+#include <string.h>
+#include <sched.h>
+
+#define DISPLAY_CNT 2
+#define FRAME_CNT 500
+#define LOG_SIZE (FRAME_CNT * 2048)
+
+// Recorded bytes of one bus
+struct bus_log {
+	u8x8_t *u8x8;
+	uint8_t *data;
+	size_t pos;
+};
+
+typedef struct bus_log bus_log_t;
+
+static bus_log_t logs[DISPLAY_CNT];
+
+static void log_byte(bus_log_t *log, uint8_t b) {
+	if (log->pos < LOG_SIZE) {
+		log->data[log->pos] = b;
+	}
+	log->pos++;
+}
+
+/*
+ * Record the transfers of the display, the message number marks start and
+ * end of each transfer. The thread yields after each message, so transfers
+ * on the two buses overlap as often as possible.
+ */
+static uint8_t u8x8_byte_record(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
+		void *arg_ptr) {
+	bus_log_t *log = NULL;
+	uint8_t *data = (uint8_t*) arg_ptr;
+	int i;
+
+	for (i = 0; i < DISPLAY_CNT; i++) {
+		if (logs[i].u8x8 == u8x8) {
+			log = &logs[i];
+		}
+	}
+	if (log == NULL) {
+		return 0;
+	}
+	switch (msg) {
+	case U8X8_MSG_BYTE_SEND:
+		log_byte(log, msg);
+		log_byte(log, arg_int);
+		while (arg_int > 0) {
+			log_byte(log, *data++);
+			arg_int--;
+		}
+		break;
+	case U8X8_MSG_BYTE_START_TRANSFER:
+	case U8X8_MSG_BYTE_END_TRANSFER:
+		log_byte(log, msg);
+		break;
+	default:
+		return 1;
+	}
+	sched_yield();
+	return 1;
+}
+
+static uint8_t u8x8_gpio_and_delay_none(u8x8_t *u8x8, uint8_t msg,
+		uint8_t arg_int, void *arg_ptr) {
+	(void) u8x8;
+	(void) msg;
+	(void) arg_int;
+	(void) arg_ptr;
+	return 1;
+}
+
+/*
+ * Fill the frame with a pattern, which is different in every tile row for
+ * consecutive frames.
+ */
+static void draw_frame(u8g2_t *u8g2, int display, int frame) {
+	uint8_t *buf = u8g2_GetBufferPtr(u8g2);
+	size_t size = (size_t) u8g2_GetBufferTileWidth(u8g2)
+			* u8g2_GetBufferTileHeight(u8g2) * 8;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		buf[i] = (uint8_t) (frame * 7 + display * 13 + i);
+	}
+}
+
+/*
+ * Send all frames of one display from the calling thread, like the worker:
+ * one tile row at a time and a refresh at the end of each frame.
+ */
+static void send_frames_direct(u8g2_t *u8g2, int display) {
+	u8x8_t *u8x8 = u8g2_GetU8x8(u8g2);
+	uint8_t tile_width = u8x8->display_info->tile_width;
+	uint8_t tile_height = u8x8->display_info->tile_height;
+	uint8_t *buf = u8g2_GetBufferPtr(u8g2);
+	uint8_t row;
+	int j;
+
+	for (j = 0; j < FRAME_CNT; ++j) {
+		draw_frame(u8g2, display, j);
+		for (row = 0; row < tile_height; row++) {
+			u8x8_DrawTileRows(u8x8, 0, row, tile_width, 1,
+					buf + (size_t) row * tile_width * 8);
+		}
+		u8x8_RefreshDisplay(u8x8);
+	}
+}
+
+int main(void) {
+	u8g2_t u8g2[DISPLAY_CNT];
+	uint8_t *expected[DISPLAY_CNT];
+	size_t expected_size[DISPLAY_CNT];
+	user_data_t *user_data;
+	int i, j, errors = 0;
+
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		u8g2_Setup_ssd1306_i2c_128x64_noname_f(&u8g2[i], U8G2_R0,
+				u8x8_byte_record, u8x8_gpio_and_delay_none);
+		user_data = init_user_data(&u8g2[i]);
+		user_data->gpio_chip = 0;
+		// Different clock pin, so each display gets its own bus worker
+		u8x8_SetPin(u8g2_GetU8x8(&u8g2[i]), U8X8_PIN_I2C_CLOCK, i);
+		logs[i].u8x8 = u8g2_GetU8x8(&u8g2[i]);
+		logs[i].data = (uint8_t*) malloc(LOG_SIZE);
+		expected[i] = (uint8_t*) malloc(LOG_SIZE);
+		if (logs[i].data == NULL || expected[i] == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+	}
+
+	// Reference: all frames from the main thread, one display after the other
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		logs[i].pos = 0;
+		send_frames_direct(&u8g2[i], i);
+		memcpy(expected[i], logs[i].data, LOG_SIZE);
+		expected_size[i] = logs[i].pos;
+		logs[i].pos = 0;
+	}
+
+	// Same frames with one worker thread for each bus
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		if (init_display_worker(&u8g2[i]) == 0) {
+			fprintf(stderr, "Display %d: init_display_worker() failed\n", i);
+			return 1;
+		}
+	}
+	for (j = 0; j < FRAME_CNT; ++j) {
+		for (i = 0; i < DISPLAY_CNT; ++i) {
+			draw_frame(&u8g2[i], i, j);
+			submit_frame(&u8g2[i]);
+		}
+		// No frame must be skipped, but both buses are busy at the same time
+		for (i = 0; i < DISPLAY_CNT; ++i) {
+			flush_frames(&u8g2[i]);
+		}
+	}
+	done_workers();
+
+	for (i = 0; i < DISPLAY_CNT; ++i) {
+		if (expected_size[i] > LOG_SIZE) {
+			fprintf(stderr, "Display %d: LOG_SIZE too small\n", i);
+			errors++;
+		} else if (logs[i].pos != expected_size[i]
+				|| memcmp(logs[i].data, expected[i], expected_size[i]) != 0) {
+			printf("Display %d: %zu bytes, expected %zu bytes: FAILED\n", i,
+					logs[i].pos, expected_size[i]);
+			errors++;
+		} else {
+			printf("Display %d: %zu bytes: OK\n", i, logs[i].pos);
+		}
+		free(logs[i].data);
+		free(expected[i]);
+		done_user_data(&u8g2[i]);
+	}
+	return errors != 0;
+}
@@ -7,6 +7,13 @@
  */
 
 #include "u8g2port.h"
+#include <string.h>
+#if PERIPHERY_GPIO_CDEV_SUPPORT
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#endif
 
 // c-periphery I2C handles
 static i2c_t *i2c_handles[MAX_I2C_HANDLES] = { NULL };
@@ -44,6 +51,53 @@ void sleep_ns(unsigned long nanoseconds) {
 	nanosleep(&ts, NULL);
 }
 
+/*
+ * Time in nanoseconds, not affected by NTP adjustments.
+ */
+unsigned long long get_time_ns(void) {
+	return linux_delay_get_time_ns();
+}
+
+/*
+ * Wait until get_time_ns() reaches target. The scheduler latency of
+ * nanosleep() is too large for short delays, so the last spin_threshold
+ * nanoseconds are a busy wait.
+ */
+void delay_until_ns(unsigned long long target, unsigned long spin_threshold) {
+	linux_delay_until_ns(target, spin_threshold);
+}
+
+/*
+ * Delays are not executed immediately. Instead they are added up until
+ * the next GPIO or bus access (see flush_delay()).
+ */
+void add_delay(u8x8_t *u8x8, unsigned long long nanoseconds) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	linux_delay_add(&user_data->delay_state, nanoseconds);
+}
+
+/*
+ * Execute the pending delay and update the histogram.
+ */
+void flush_delay(u8x8_t *u8x8) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	linux_delay_flush(&user_data->delay_state);
+}
+
+void reset_delay_histogram(u8x8_t *u8x8) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	linux_delay_reset_histogram(&user_data->delay_state);
+}
+
+/*
+ * Print count, average requested and average actual delay for each
+ * histogram entry.
+ */
+void print_delay_histogram(u8x8_t *u8x8, FILE *fp) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	linux_delay_print_histogram(&user_data->delay_state, fp);
+}
+
 /*
  * Allocate user_data_struct, set common values and set user_ptr.
  */
@@ -57,6 +111,9 @@ user_data_t* init_user_data(u8g2_t *u8g2) {
 	for (int i = 0; i < U8X8_PIN_CNT; ++i) {
 		user_data->pins[i] = NULL;
 	}
+	user_data->line_fd = -1;
+	user_data->worker = NULL;
+	linux_delay_init(&user_data->delay_state);
 	u8g2_SetUserPtr(u8g2, user_data);
 	return user_data;
 }
@@ -135,6 +192,12 @@ void done_user_data(u8g2_t *u8g2) {
 				gpio_free(user_data->pins[i]);
 			}
 		}
+#if PERIPHERY_GPIO_CDEV_SUPPORT
+		// Close clock and data line handle
+		if (user_data->line_fd >= 0) {
+			close(user_data->line_fd);
+		}
+#endif
 		// Free internal buffer
 		free(user_data->int_buf);
 		// Free user data struct
@@ -150,6 +213,11 @@ void done_user_data(u8g2_t *u8g2) {
 void init_pin(u8x8_t *u8x8, uint8_t pin) {
 	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
 	char filename[16];
+	// Clock and data pins might be already requested by init_lines()
+	if (user_data->line_fd >= 0 && (pin == user_data->line_pin[0]
+			|| pin == user_data->line_pin[1])) {
+		return;
+	}
 	if (u8x8->pins[pin] != U8X8_PIN_NONE && user_data -> pins[pin] == NULL) {
 		snprintf(filename, sizeof(filename), "/dev/gpiochip%d",	user_data ->gpio_chip);
 		user_data -> pins[pin] = gpio_new();
@@ -182,11 +250,180 @@ void init_pin(u8x8_t *u8x8, uint8_t pin) {
  */
 void write_pin(u8x8_t *u8x8, uint8_t pin, uint8_t value) {
 	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	if (user_data->line_fd >= 0) {
+		// Clock and data pins are part of the line handle
+		if (pin == user_data->line_pin[0]) {
+			write_lines(u8x8, value, user_data->line_value[1]);
+			return;
+		}
+		if (pin == user_data->line_pin[1]) {
+			write_lines(u8x8, user_data->line_value[0], value);
+			return;
+		}
+	}
 	if (u8x8->pins[pin] != U8X8_PIN_NONE) {
 		gpio_write(user_data->pins[pin], value);
 	}
 }
 
+#if PERIPHERY_GPIO_CDEV_SUPPORT
+/*
+ * Request the clock and data pin of the software SPI or I2C as one line
+ * handle, so that both lines can be written with one ioctl. If this fails,
+ * the pins are opened one by one with init_pin().
+ */
+void init_lines(u8x8_t *u8x8, uint8_t clock, uint8_t data) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	struct gpiohandle_request req;
+	char filename[20];
+	int fd;
+
+	if (user_data->line_fd >= 0 || u8x8->pins[clock] == U8X8_PIN_NONE
+			|| u8x8->pins[data] == U8X8_PIN_NONE) {
+		return;
+	}
+	snprintf(filename, sizeof(filename), "/dev/gpiochip%d", user_data->gpio_chip);
+	fd = open(filename, O_RDWR);
+	if (fd < 0) {
+		return;
+	}
+	memset(&req, 0, sizeof(req));
+	req.lineoffsets[0] = u8x8->pins[clock];
+	req.lineoffsets[1] = u8x8->pins[data];
+	req.flags = GPIOHANDLE_REQUEST_OUTPUT;
+	req.default_values[0] = 1;
+	req.default_values[1] = 1;
+	strncpy(req.consumer_label, "u8g2", sizeof(req.consumer_label) - 1);
+	req.lines = 2;
+	if (ioctl(fd, GPIO_GET_LINEHANDLE_IOCTL, &req) < 0) {
+		fprintf(stderr, "init_lines(): pins %d/%d, line handle not available\n",
+				u8x8->pins[clock], u8x8->pins[data]);
+		close(fd);
+		return;
+	}
+	close(fd);
+	user_data->line_fd = req.fd;
+	user_data->line_pin[0] = clock;
+	user_data->line_pin[1] = data;
+	user_data->line_value[0] = 1;
+	user_data->line_value[1] = 1;
+}
+
+/*
+ * Write clock and data line with one ioctl.
+ */
+void write_lines(u8x8_t *u8x8, uint8_t clock_value, uint8_t data_value) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	struct gpiohandle_data values;
+
+	memset(&values, 0, sizeof(values));
+	values.values[0] = clock_value != 0;
+	values.values[1] = data_value != 0;
+	ioctl(user_data->line_fd, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &values);
+	user_data->line_value[0] = values.values[0];
+	user_data->line_value[1] = values.values[1];
+}
+
+/*
+ * U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER: The data bit is written together with
+ * the leading clock edge, so each bit requires two ioctl calls.
+ */
+void shift_out_spi(u8x8_t *u8x8, u8x8_shift_out_t *shift_out) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	uint8_t takeover_edge = u8x8_GetSPIClockPhase(u8x8);
+	uint8_t not_takeover_edge = 1 - takeover_edge;
+	uint16_t b;
+	uint16_t mask;
+
+	if (user_data->line_fd < 0
+			|| user_data->line_pin[0] != U8X8_PIN_SPI_CLOCK) {
+		return;
+	}
+	while (shift_out->cnt > 0) {
+		b = *shift_out->data;
+		if (shift_out->bits > 8 && shift_out->dc != 0) {
+			b |= 256;
+		}
+		for (mask = 1 << (shift_out->bits - 1); mask != 0; mask >>= 1) {
+			write_lines(u8x8, not_takeover_edge, (b & mask) != 0);
+			if (user_data->delay != 0) {
+				linux_delay_wait_until_ns(&user_data->delay_state,
+						get_time_ns() + user_data->delay);
+			}
+			write_lines(u8x8, takeover_edge, (b & mask) != 0);
+			if (user_data->delay != 0) {
+				linux_delay_wait_until_ns(&user_data->delay_state,
+						get_time_ns() + user_data->delay);
+			}
+		}
+		shift_out->data++;
+		shift_out->cnt--;
+	}
+}
+
+/*
+ * U8X8_MSG_GPIO_I2C_SHIFT_OUT_BUFFER: SDA is changed only while SCL is low,
+ * so each bit requires three ioctl calls.
+ */
+void shift_out_i2c(u8x8_t *u8x8, u8x8_shift_out_t *shift_out) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	uint16_t b;
+	uint8_t i, sda;
+
+	if (user_data->line_fd < 0
+			|| user_data->line_pin[0] != U8X8_PIN_I2C_CLOCK) {
+		return;
+	}
+	while (shift_out->cnt > 0) {
+		// eight data bits and the released SDA line for the ACK bit
+		b = (*shift_out->data << 1) | 1;
+		for (i = 0; i < 9; i++) {
+			sda = (b & 256) != 0;
+			b <<= 1;
+			write_lines(u8x8, 0, sda);
+			if (user_data->delay != 0) {
+				linux_delay_wait_until_ns(&user_data->delay_state,
+						get_time_ns() + user_data->delay);
+			}
+			write_lines(u8x8, 1, sda);
+			if (user_data->delay != 0) {
+				linux_delay_wait_until_ns(&user_data->delay_state,
+						get_time_ns() + user_data->delay);
+			}
+			write_lines(u8x8, 0, sda);
+		}
+		shift_out->data++;
+		shift_out->cnt--;
+	}
+}
+#else
+void init_lines(u8x8_t *u8x8, uint8_t clock, uint8_t data) {
+	(void) u8x8;
+	(void) clock;
+	(void) data;
+}
+
+void write_lines(u8x8_t *u8x8, uint8_t clock_value, uint8_t data_value) {
+	(void) u8x8;
+	(void) clock_value;
+	(void) data_value;
+}
+
+/*
+ * Without GPIO character device support, the byte procedures fall back to
+ * the bit by bit transfer.
+ */
+void shift_out_spi(u8x8_t *u8x8, u8x8_shift_out_t *shift_out) {
+	(void) u8x8;
+	(void) shift_out;
+}
+
+void shift_out_i2c(u8x8_t *u8x8, u8x8_shift_out_t *shift_out) {
+	(void) u8x8;
+	(void) shift_out;
+}
+#endif
+
 /*
  * Initialize I2C bus.
  */
@@ -266,45 +503,49 @@ void done_spi() {
  */
 uint8_t u8x8_arm_linux_gpio_and_delay(u8x8_t *u8x8, uint8_t msg,
 		uint8_t arg_int, void *arg_ptr) {
-	user_data_t *user_data;
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+
+	// Delays are collected and executed before the next GPIO access
+	if (msg < U8X8_MSG_DELAY_MILLI || msg > U8X8_MSG_DELAY_I2C) {
+		flush_delay(u8x8);
+	}
 
-	(void) arg_ptr; /* suppress unused parameter warning */
 	switch (msg) {
 	case U8X8_MSG_DELAY_NANO:
 		// delay arg_int * 1 nano second or 0 for none
-		user_data = u8x8_GetUserPtr(u8x8);
-		if (user_data->delay != 0) {
-			sleep_ns(user_data->delay);
-		}
+		add_delay(u8x8, user_data->delay);
 		break;
 
 	case U8X8_MSG_DELAY_100NANO:
 		// delay arg_int * 100 nano seconds
-		sleep_ns(arg_int * 100);
+		add_delay(u8x8, arg_int * 100ULL);
 		break;
 
 	case U8X8_MSG_DELAY_10MICRO:
 		// delay arg_int * 10 micro seconds
-		sleep_us(arg_int * 10);
+		add_delay(u8x8, arg_int * 10000ULL);
 		break;
 
 	case U8X8_MSG_DELAY_MILLI:
-		// delay arg_int * 1 milli second
-		sleep_ms(arg_int);
+		// delay arg_int * 1 milli second, not deferred: this is usually the
+		// last delay of a sequence (e.g. reset or power up wait)
+		add_delay(u8x8, arg_int * 1000000ULL);
+		flush_delay(u8x8);
 		break;
 
 	case U8X8_MSG_DELAY_I2C:
 		// arg_int is the I2C speed in 100KHz, e.g. 4 = 400 KHz, but we ignore
 		// that and use user_data->delay
-		user_data = u8x8_GetUserPtr(u8x8);
-		if (user_data->delay != 0) {
-			sleep_ns(user_data->delay);
-		}
+		add_delay(u8x8, user_data->delay);
 		break;
 
 	case U8X8_MSG_GPIO_AND_DELAY_INIT:
 		// Function which implements a delay, arg_int contains the amount of ms
 
+		// Clock and data of software SPI or I2C as one line handle
+		init_lines(u8x8, U8X8_PIN_SPI_CLOCK, U8X8_PIN_SPI_DATA);
+		init_lines(u8x8, U8X8_PIN_I2C_CLOCK, U8X8_PIN_I2C_DATA);
+
 		// SPI Pins
 		init_pin(u8x8, U8X8_PIN_SPI_CLOCK);
 		init_pin(u8x8, U8X8_PIN_SPI_DATA);
@@ -359,6 +600,16 @@ uint8_t u8x8_arm_linux_gpio_and_delay(u8x8_t *u8x8, uint8_t msg,
 		write_pin(u8x8, U8X8_PIN_E, arg_int);
 		break;
 
+	case U8X8_MSG_GPIO_SPI_SHIFT_OUT_BUFFER:
+		// Send the buffer with the clock and data line handle
+		shift_out_spi(u8x8, (u8x8_shift_out_t*) arg_ptr);
+		break;
+
+	case U8X8_MSG_GPIO_I2C_SHIFT_OUT_BUFFER:
+		// Send the buffer with the clock and data line handle
+		shift_out_i2c(u8x8, (u8x8_shift_out_t*) arg_ptr);
+		break;
+
 	case U8X8_MSG_GPIO_I2C_CLOCK:
 		// arg_int=0: Output low at I2C clock pin
 		// arg_int=1: Input dir with pullup high for I2C clock pin
@@ -411,6 +662,9 @@ uint8_t u8x8_byte_arm_linux_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
 	uint8_t *data;
 	struct i2c_msg msgs[1];
 
+	// Pending delays (e.g. after reset) must be done before the transfer
+	flush_delay(u8x8);
+
 	switch (msg) {
 	case U8X8_MSG_BYTE_SEND:
 		user_data = u8x8_GetUserPtr(u8x8);
@@ -454,6 +708,9 @@ uint8_t u8x8_byte_arm_linux_hw_spi(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
 	user_data_t *user_data;
 	uint8_t *data;
 
+	// Pending delays (e.g. after reset) must be done before the transfer
+	flush_delay(u8x8);
+
 	switch (msg) {
 	case U8X8_MSG_BYTE_SEND:
 		user_data = u8x8_GetUserPtr(u8x8);
@@ -12,10 +12,33 @@ extern "C" {
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "linux_delay.h"
 
 #define MAX_I2C_HANDLES 8
 #define MAX_SPI_HANDLES 256
 
+// Delays below this value are done with a busy wait instead of nanosleep()
+#define DELAY_SPIN_THRESHOLD_NS LINUX_DELAY_SPIN_THRESHOLD_NS
+// Number of bus worker threads and displays for each bus worker
+#define MAX_BUS_WORKERS 8
+#define MAX_WORKER_DISPLAYS 16
+
+/*
+ * Frame statistics of a display, which is transferred by a bus worker.
+ */
+struct worker_stats_struct {
+	// Calls to submit_frame()
+	unsigned long frames_submitted;
+	// Frames, which have been transferred
+	unsigned long frames_sent;
+	// Frames, which have been replaced by a newer frame before the transfer
+	unsigned long frames_skipped;
+	// Tile rows, which have been sent (unchanged rows are not sent)
+	unsigned long rows_sent;
+};
+
+typedef struct worker_stats_struct worker_stats_t;
+
 /*
  * User data passed in user_ptr of u8x8_struct.
  */
@@ -38,6 +61,16 @@ struct user_data_struct {
 	uint32_t max_speed;
 	// Internal buffer
 	uint8_t *int_buf;
+	// GPIO line handle for the software SPI/I2C clock and data pins, -1 if not used
+	int line_fd;
+	// Pin index (U8X8_PIN_xxx) of the lines in line_fd, clock first
+	uint8_t line_pin[2];
+	// Current output values of the lines in line_fd
+	uint8_t line_value[2];
+	// Combined delays and delay histogram (sys/linux-common/linux_delay.c)
+	linux_delay_t delay_state;
+	// Bus worker frame exchange (u8g2worker.c), NULL if not used
+	struct display_worker_struct *worker;
 };
 
 typedef struct user_data_struct user_data_t;
@@ -45,6 +78,12 @@ typedef struct user_data_struct user_data_t;
 void sleep_ms(unsigned long milliseconds);
 void sleep_us(unsigned long microseconds);
 void sleep_ns(unsigned long nanoseconds);
+unsigned long long get_time_ns(void);
+void delay_until_ns(unsigned long long target, unsigned long spin_threshold);
+void add_delay(u8x8_t *u8x8, unsigned long long nanoseconds);
+void flush_delay(u8x8_t *u8x8);
+void reset_delay_histogram(u8x8_t *u8x8);
+void print_delay_histogram(u8x8_t *u8x8, FILE *fp);
 user_data_t *init_user_data(u8g2_t *u8g2);
 void init_i2c_hw(u8g2_t *u8g2, uint8_t bus);
 void init_i2c_sw(u8g2_t *u8g2, uint8_t gpio_chip, uint8_t scl, uint8_t sda,
@@ -58,10 +97,19 @@ void init_spi_sw(u8g2_t *u8g2, uint8_t gpio_chip, uint8_t dc, uint8_t res,
 void done_user_data(u8g2_t *u8g2);
 void init_pin(u8x8_t *u8x8, uint8_t pin);
 void write_pin(u8x8_t *u8x8, uint8_t pin, uint8_t value);
+void init_lines(u8x8_t *u8x8, uint8_t clock, uint8_t data);
+void write_lines(u8x8_t *u8x8, uint8_t clock_value, uint8_t data_value);
+void shift_out_spi(u8x8_t *u8x8, u8x8_shift_out_t *shift_out);
+void shift_out_i2c(u8x8_t *u8x8, u8x8_shift_out_t *shift_out);
 void init_i2c(u8x8_t *u8x8);
 void done_i2c();
 void init_spi(u8x8_t *u8x8);
 void done_spi();
+int init_display_worker(u8g2_t *u8g2);
+int submit_frame(u8g2_t *u8g2);
+void flush_frames(u8g2_t *u8g2);
+void get_worker_stats(u8g2_t *u8g2, worker_stats_t *stats);
+void done_workers();
 uint8_t u8x8_arm_linux_gpio_and_delay(u8x8_t *u8x8, uint8_t msg,
 		uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_byte_arm_linux_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int,
@@ -0,0 +1,378 @@
+/*
+ * Display worker: One thread for each I2C or SPI bus transfers the frames of
+ * all displays connected to this bus.
+ *
+ * The application draws into the u8g2 buffer as usual, but calls
+ * submit_frame() instead of u8g2_SendBuffer(). The buffer is copied into a
+ * single producer / single consumer frame exchange of the display, so the
+ * application can continue with the next frame immediately.
+ *
+ * The exchange has three frame slots: The slot written by the application,
+ * the slot transferred by the worker and the pending slot. submit_frame()
+ * swaps the written slot with the pending slot, the worker swaps the pending
+ * slot with its own slot, if the pending slot contains a new frame. Both
+ * swaps are one atomic exchange, so neither side ever waits for the other.
+ * A frame, which is replaced before the worker has taken it, is skipped:
+ * The worker always sends the newest frame.
+ *
+ * Transfers of the displays on the same bus are interleaved tile row by
+ * tile row, so a large display does not block the other displays on the same bus.
+ * Tile rows, which are identical to the last transferred frame, are not sent.
+ *
+ * Restrictions:
+ * - Only full buffer (_f) setups are supported.
+ * - Initialize the display and set power save before init_display_worker().
+ *   After this, the u8x8 communication functions of the display must not be
+ *   used by the application, until done_workers() has been called.
+ * - Each display must be submitted from one thread only.
+ */
+
+#include "u8g2port.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <string.h>
+#include <errno.h>
+
+struct display_worker_struct;
+typedef struct display_worker_struct display_worker_t;
+
+/*
+ * One worker thread for each bus.
+ */
+struct bus_worker_struct {
+	// Bus key, see get_bus_key()
+	unsigned key;
+	pthread_t thread;
+	// Posted by submit_frame()
+	sem_t wakeup;
+	// Set by done_workers()
+	int is_stop;
+	// Displays on this bus, display_cnt is incremented after the entry is set
+	display_worker_t *displays[MAX_WORKER_DISPLAYS];
+	unsigned display_cnt;
+};
+
+typedef struct bus_worker_struct bus_worker_t;
+
+/*
+ * Frame exchange and transfer state of one display.
+ */
+struct display_worker_struct {
+	u8g2_t *u8g2;
+	bus_worker_t *bus;
+	// Size of one frame (tile_width*tile_height*8)
+	size_t frame_size;
+	// Frame slots and their frame number
+	uint8_t *slots[3];
+	unsigned long slot_seq[3];
+	// Slot index of the application (back) and the worker (front)
+	unsigned back;
+	unsigned front;
+	// Slot index of the pending frame, WORKER_PENDING_NEW is set until the
+	// worker has taken the frame
+	unsigned pending;
+	// Last submitted frame number, written by the application
+	unsigned long seq;
+	// Last transferred frame number, written by the worker
+	unsigned long done_seq;
+	// Content of the display RAM
+	uint8_t *last;
+	// 0 until the first frame has been sent
+	int is_last_valid;
+	// Frame, which is transferred at the moment, NULL if none
+	uint8_t *curr;
+	// Next tile row of curr
+	uint8_t curr_row;
+	// Number of tile rows sent for the current frame
+	uint8_t curr_sent;
+	worker_stats_t stats;
+};
+
+#define WORKER_PENDING_NEW 4
+
+static pthread_mutex_t workers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bus_worker_t *bus_workers[MAX_BUS_WORKERS] = { NULL };
+
+/*
+ * Displays with the same key share the same bus: The I2C bus number, the SPI
+ * controller (all chip selects) or the clock pin of software I2C and SPI.
+ */
+static unsigned get_bus_key(u8x8_t *u8x8) {
+	user_data_t *user_data = u8x8_GetUserPtr(u8x8);
+	uint8_t pin;
+
+	if (u8x8->byte_cb == u8x8_byte_arm_linux_hw_i2c) {
+		return 0x10000 | user_data->bus;
+	}
+	if (u8x8->byte_cb == u8x8_byte_arm_linux_hw_spi) {
+		return 0x20000 | (user_data->bus >> 4);
+	}
+	pin = u8x8->pins[U8X8_PIN_I2C_CLOCK];
+	if (pin == U8X8_PIN_NONE) {
+		pin = u8x8->pins[U8X8_PIN_SPI_CLOCK];
+	}
+	return 0x30000 | (user_data->gpio_chip << 8) | pin;
+}
+
+/*
+ * Send the next changed tile row of the current frame. Returns 0 if the
+ * frame is complete.
+ */
+static int send_next_row(display_worker_t *d) {
+	u8x8_t *u8x8 = u8g2_GetU8x8(d->u8g2);
+	uint8_t tile_width = u8x8->display_info->tile_width;
+	uint8_t tile_height = u8x8->display_info->tile_height;
+	size_t row_size = (size_t) tile_width * 8;
+	size_t offset;
+
+	while (d->curr_row < tile_height) {
+		offset = d->curr_row * row_size;
+		if (!d->is_last_valid
+				|| memcmp(d->curr + offset, d->last + offset, row_size) != 0) {
+			u8x8_DrawTileRows(u8x8, 0, d->curr_row, tile_width, 1,
+					d->curr + offset);
+			memcpy(d->last + offset, d->curr + offset, row_size);
+			d->curr_row++;
+			d->curr_sent++;
+			d->stats.rows_sent++;
+			return 1;
+		}
+		d->curr_row++;
+	}
+	return 0;
+}
+
+/*
+ * Worker thread: Take the newest frame of each idle display and send one
+ * tile row of each display in turn.
+ */
+static void* bus_worker_thread(void *arg) {
+	bus_worker_t *bus = (bus_worker_t*) arg;
+	display_worker_t *d;
+	unsigned i, cnt, pending;
+	int is_busy;
+
+	for (;;) {
+		is_busy = 0;
+		cnt = __atomic_load_n(&bus->display_cnt, __ATOMIC_ACQUIRE);
+		for (i = 0; i < cnt; i++) {
+			d = bus->displays[i];
+			if (d->curr == NULL) {
+				if ((__atomic_load_n(&d->pending, __ATOMIC_RELAXED)
+						& WORKER_PENDING_NEW) == 0) {
+					continue;
+				}
+				pending = __atomic_exchange_n(&d->pending, d->front,
+						__ATOMIC_ACQ_REL);
+				d->front = pending & ~WORKER_PENDING_NEW;
+				d->stats.frames_skipped += d->slot_seq[d->front]
+						- d->done_seq - 1;
+				d->curr = d->slots[d->front];
+				d->curr_row = 0;
+				d->curr_sent = 0;
+			}
+			if (send_next_row(d) == 0) {
+				if (d->curr_sent != 0) {
+					u8x8_RefreshDisplay(u8g2_GetU8x8(d->u8g2));
+				}
+				d->curr = NULL;
+				d->is_last_valid = 1;
+				d->stats.frames_sent++;
+				__atomic_store_n(&d->done_seq, d->slot_seq[d->front],
+						__ATOMIC_RELEASE);
+			}
+			is_busy = 1;
+		}
+		if (!is_busy) {
+			if (__atomic_load_n(&bus->is_stop, __ATOMIC_ACQUIRE)) {
+				break;
+			}
+			while (sem_wait(&bus->wakeup) != 0 && errno == EINTR)
+				;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Find or start the worker of a bus. Called with workers_mutex locked.
+ */
+static bus_worker_t* get_bus_worker(unsigned key) {
+	bus_worker_t *bus;
+	int i;
+
+	for (i = 0; i < MAX_BUS_WORKERS && bus_workers[i] != NULL; i++) {
+		if (bus_workers[i]->key == key) {
+			return bus_workers[i];
+		}
+	}
+	if (i == MAX_BUS_WORKERS) {
+		fprintf(stderr, "get_bus_worker(): more than %d buses\n",
+				MAX_BUS_WORKERS);
+		return NULL;
+	}
+	bus = (bus_worker_t*) calloc(1, sizeof(bus_worker_t));
+	if (bus == NULL) {
+		return NULL;
+	}
+	bus->key = key;
+	sem_init(&bus->wakeup, 0, 0);
+	if (pthread_create(&bus->thread, NULL, bus_worker_thread, bus) != 0) {
+		fprintf(stderr, "get_bus_worker(): pthread_create failed\n");
+		sem_destroy(&bus->wakeup);
+		free(bus);
+		return NULL;
+	}
+	bus_workers[i] = bus;
+	return bus;
+}
+
+static void free_display_worker(display_worker_t *d) {
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		free(d->slots[i]);
+	}
+	free(d->last);
+	free(d);
+}
+
+/*
+ * Transfer the frames of this display with the worker of its bus. The
+ * display must be initialized, init_i2c_hw() etc. must have been called
+ * before. Returns 0 on error.
+ */
+int init_display_worker(u8g2_t *u8g2) {
+	user_data_t *user_data = u8g2_GetUserPtr(u8g2);
+	u8x8_t *u8x8 = u8g2_GetU8x8(u8g2);
+	display_worker_t *d;
+	bus_worker_t *bus;
+	int i;
+
+	if (user_data == NULL || user_data->worker != NULL) {
+		return 0;
+	}
+	if (u8g2->tile_buf_height < u8x8->display_info->tile_height) {
+		fprintf(stderr, "init_display_worker(): full buffer required\n");
+		return 0;
+	}
+	d = (display_worker_t*) calloc(1, sizeof(display_worker_t));
+	if (d == NULL) {
+		return 0;
+	}
+	d->u8g2 = u8g2;
+	d->frame_size = (size_t) u8x8->display_info->tile_width
+			* u8x8->display_info->tile_height * 8;
+	d->back = 0;
+	d->front = 1;
+	d->pending = 2;
+	for (i = 0; i < 3; i++) {
+		d->slots[i] = (uint8_t*) malloc(d->frame_size);
+		if (d->slots[i] == NULL) {
+			free_display_worker(d);
+			return 0;
+		}
+	}
+	d->last = (uint8_t*) malloc(d->frame_size);
+	if (d->last == NULL) {
+		free_display_worker(d);
+		return 0;
+	}
+
+	pthread_mutex_lock(&workers_mutex);
+	bus = get_bus_worker(get_bus_key(u8x8));
+	if (bus == NULL || bus->display_cnt >= MAX_WORKER_DISPLAYS) {
+		pthread_mutex_unlock(&workers_mutex);
+		fprintf(stderr, "init_display_worker(): no worker available\n");
+		free_display_worker(d);
+		return 0;
+	}
+	d->bus = bus;
+	bus->displays[bus->display_cnt] = d;
+	__atomic_store_n(&bus->display_cnt, bus->display_cnt + 1,
+			__ATOMIC_RELEASE);
+	pthread_mutex_unlock(&workers_mutex);
+	user_data->worker = d;
+	return 1;
+}
+
+/*
+ * Copy the u8g2 buffer into the frame exchange of the display and wake up
+ * the worker. A frame, which has not yet been taken by the worker, is
+ * replaced. Returns 0 if there is no worker for the display.
+ */
+int submit_frame(u8g2_t *u8g2) {
+	user_data_t *user_data = u8g2_GetUserPtr(u8g2);
+	display_worker_t *d;
+	unsigned prev;
+
+	if (user_data == NULL || user_data->worker == NULL) {
+		return 0;
+	}
+	d = user_data->worker;
+	memcpy(d->slots[d->back], u8g2->tile_buf_ptr, d->frame_size);
+	d->slot_seq[d->back] = ++d->seq;
+	prev = __atomic_exchange_n(&d->pending, d->back | WORKER_PENDING_NEW,
+			__ATOMIC_ACQ_REL);
+	d->back = prev & ~WORKER_PENDING_NEW;
+	d->stats.frames_submitted++;
+	sem_post(&d->bus->wakeup);
+	return 1;
+}
+
+/*
+ * Wait until the last submitted frame of the display has been transferred.
+ */
+void flush_frames(u8g2_t *u8g2) {
+	user_data_t *user_data = u8g2_GetUserPtr(u8g2);
+	display_worker_t *d;
+
+	if (user_data == NULL || user_data->worker == NULL) {
+		return;
+	}
+	d = user_data->worker;
+	while (__atomic_load_n(&d->done_seq, __ATOMIC_ACQUIRE) != d->seq) {
+		sleep_us(100);
+	}
+}
+
+/*
+ * Copy the statistics of the display. The worker updates the statistics
+ * without locking, so the values might be slightly outdated.
+ */
+void get_worker_stats(u8g2_t *u8g2, worker_stats_t *stats) {
+	user_data_t *user_data = u8g2_GetUserPtr(u8g2);
+
+	memset(stats, 0, sizeof(worker_stats_t));
+	if (user_data != NULL && user_data->worker != NULL) {
+		*stats = user_data->worker->stats;
+	}
+}
+
+/*
+ * Send all pending frames, stop all worker threads and free the frame slots.
+ * Call this before done_user_data().
+ */
+void done_workers() {
+	bus_worker_t *bus;
+	display_worker_t *d;
+	unsigned j;
+	int i;
+
+	pthread_mutex_lock(&workers_mutex);
+	for (i = 0; i < MAX_BUS_WORKERS && bus_workers[i] != NULL; i++) {
+		bus = bus_workers[i];
+		__atomic_store_n(&bus->is_stop, 1, __ATOMIC_RELEASE);
+		sem_post(&bus->wakeup);
+		pthread_join(bus->thread, NULL);
+		sem_destroy(&bus->wakeup);
+		for (j = 0; j < bus->display_cnt; j++) {
+			d = bus->displays[j];
+			((user_data_t*) u8g2_GetUserPtr(d->u8g2))->worker = NULL;
+			free_display_worker(d);
+		}
+		free(bus);
+		bus_workers[i] = NULL;
+	}
+	pthread_mutex_unlock(&workers_mutex);
+}
@@ -0,0 +1,401 @@
+/*
+
+  primitive_bench
+
+  Measure the draw time of the u8g2 graphics primitives. The primitives are
+  drawn into the buffer of a 128x64 SSD1306 setup with the empty byte
+  procedure, so nothing is transferred. Each primitive is measured for
+  several sizes, all draw colors, rotations and buffer modes.
+
+  For the page buffer modes (_1, _2) one operation is the primitive drawn
+  into all pages of the display, like it happens in the picture loop.
+  The "page_loop" entry measures the picture loop itself (clear buffer and
+  send buffer to the display procedure) without any primitive.
+
+  The number of repetitions only depends on the size of the primitive, so
+  two runs execute exactly the same operations. ns_per_op is the best of
+  several runs. pixels_per_op is the number of pixels, which are set by
+  one operation with draw color 1 in full buffer mode.
+
+  usage: primitive_bench [-j] [-q] [-p <primitive>]
+    -j	JSON output (default: CSV)
+    -q	quick: one run for each entry instead of five
+    -p	only measure primitives which start with <primitive>
+
+*/
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SIZE_CNT 3
+#define RUN_CNT 5
+
+/* one primitive of the benchmark, size is 0..SIZE_CNT-1 */
+struct primitive_struct
+{
+  const char *name;
+  void (*draw)(u8g2_t *u8g2, uint8_t size);
+  uint8_t is_size;	/* 0: size is not used */
+  uint8_t is_color;	/* 0: draw color is not used */
+};
+
+typedef void (*setup_cb)(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
+
+struct buffer_struct
+{
+  const char *name;
+  setup_cb setup;
+};
+
+struct buffer_struct buffer_list[] =
+{
+  { "1", u8g2_Setup_ssd1306_128x64_noname_1 },
+  { "2", u8g2_Setup_ssd1306_128x64_noname_2 },
+  { "f", u8g2_Setup_ssd1306_128x64_noname_f },
+};
+
+struct rotation_struct
+{
+  const char *name;
+  const u8g2_cb_t *cb;
+};
+
+struct rotation_struct rotation_list[] =
+{
+  { "r0", U8G2_R0 },
+  { "r1", U8G2_R1 },
+  { "r2", U8G2_R2 },
+  { "r3", U8G2_R3 },
+  { "mirror", U8G2_MIRROR },
+};
+
+static const char *size_name[SIZE_CNT] = { "small", "medium", "large" };
+
+/* fonts for glyphs and strings, one for each size */
+static const uint8_t *font_list[SIZE_CNT] =
+{
+  u8g2_font_5x7_tr,
+  u8g2_font_helvB08_tr,
+  u8g2_font_logisoso24_tr,
+};
+
+/* 32x32 XBM, smaller sizes use the same data */
+static uint8_t xbm_bits[32*32/8];
+
+u8g2_t u8g2;
+
+/*========================================================*/
+/* primitives */
+
+/* length or diameter for each size, large covers the display */
+static u8g2_uint_t get_len(u8g2_t *u8g2, uint8_t size)
+{
+  if ( size == 0 )
+    return 8;
+  if ( size == 1 )
+    return 32;
+  return u8g2_GetDisplayWidth(u8g2) < u8g2_GetDisplayHeight(u8g2) ? u8g2_GetDisplayWidth(u8g2) : u8g2_GetDisplayHeight(u8g2);
+}
+
+static void draw_hline(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t len = size == 2 ? u8g2_GetDisplayWidth(u8g2) : get_len(u8g2, size);
+  u8g2_DrawHLine(u8g2, 0, 5, len);
+}
+
+static void draw_vline(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t len = size == 2 ? u8g2_GetDisplayHeight(u8g2) : get_len(u8g2, size);
+  u8g2_DrawVLine(u8g2, 5, 0, len);
+}
+
+static void draw_box(u8g2_t *u8g2, uint8_t size)
+{
+  if ( size == 2 )
+    u8g2_DrawBox(u8g2, 0, 0, u8g2_GetDisplayWidth(u8g2), u8g2_GetDisplayHeight(u8g2));
+  else
+    u8g2_DrawBox(u8g2, 3, 3, get_len(u8g2, size), get_len(u8g2, size));
+}
+
+static void draw_frame(u8g2_t *u8g2, uint8_t size)
+{
+  if ( size == 2 )
+    u8g2_DrawFrame(u8g2, 0, 0, u8g2_GetDisplayWidth(u8g2), u8g2_GetDisplayHeight(u8g2));
+  else
+    u8g2_DrawFrame(u8g2, 3, 3, get_len(u8g2, size), get_len(u8g2, size));
+}
+
+static void draw_rbox(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t len = get_len(u8g2, size);
+  u8g2_DrawRBox(u8g2, 0, 0, len, len, len/4);
+}
+
+static void draw_circle(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t r = (get_len(u8g2, size)-1)/2;
+  u8g2_DrawCircle(u8g2, r, r, r, U8G2_DRAW_ALL);
+}
+
+static void draw_disc(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t r = (get_len(u8g2, size)-1)/2;
+  u8g2_DrawDisc(u8g2, r, r, r, U8G2_DRAW_ALL);
+}
+
+static void draw_ellipse(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t r = (get_len(u8g2, size)-1)/2;
+  u8g2_DrawEllipse(u8g2, r*2, r, r*2, r, U8G2_DRAW_ALL);
+}
+
+static void draw_filled_ellipse(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t r = (get_len(u8g2, size)-1)/2;
+  u8g2_DrawFilledEllipse(u8g2, r*2, r, r*2, r, U8G2_DRAW_ALL);
+}
+
+static void draw_line(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t len = get_len(u8g2, size);
+  u8g2_DrawLine(u8g2, 0, len-1, len*2-1, 0);
+}
+
+static void draw_triangle(u8g2_t *u8g2, uint8_t size)
+{
+  int16_t len = get_len(u8g2, size);
+  u8g2_DrawTriangle(u8g2, 0, len-1, len/2, 0, len*2-1, len-1);
+}
+
+static void draw_polygon(u8g2_t *u8g2, uint8_t size)
+{
+  int16_t len = get_len(u8g2, size);
+  u8g2_ClearPolygonXY();
+  u8g2_AddPolygonXY(u8g2, len/2, 0);
+  u8g2_AddPolygonXY(u8g2, len-1, len/3);
+  u8g2_AddPolygonXY(u8g2, len*3/4, len-1);
+  u8g2_AddPolygonXY(u8g2, len/4, len-1);
+  u8g2_AddPolygonXY(u8g2, 0, len/3);
+  u8g2_DrawPolygon(u8g2);
+}
+
+static void draw_xbm(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_uint_t len = size == 0 ? 8 : size == 1 ? 16 : 32;
+  u8g2_DrawXBM(u8g2, 1, 1, len, len, xbm_bits);
+}
+
+static void draw_glyph(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_SetFont(u8g2, font_list[size]);
+  u8g2_DrawGlyph(u8g2, 2, 40, 'W');
+}
+
+static void draw_str(u8g2_t *u8g2, uint8_t size)
+{
+  u8g2_SetFont(u8g2, font_list[size]);
+  u8g2_DrawStr(u8g2, 0, 40, "Hello 123");
+}
+
+static void draw_nothing(u8g2_t *u8g2, uint8_t size)
+{
+  (void)u8g2;
+  (void)size;
+}
+
+struct primitive_struct primitive_list[] =
+{
+  { "hline", draw_hline, 1, 1 },
+  { "vline", draw_vline, 1, 1 },
+  { "box", draw_box, 1, 1 },
+  { "frame", draw_frame, 1, 1 },
+  { "rbox", draw_rbox, 1, 1 },
+  { "circle", draw_circle, 1, 1 },
+  { "disc", draw_disc, 1, 1 },
+  { "ellipse", draw_ellipse, 1, 1 },
+  { "filled_ellipse", draw_filled_ellipse, 1, 1 },
+  { "line", draw_line, 1, 1 },
+  { "triangle", draw_triangle, 1, 1 },
+  { "polygon", draw_polygon, 1, 1 },
+  { "xbm", draw_xbm, 1, 1 },
+  { "glyph", draw_glyph, 1, 1 },
+  { "str", draw_str, 1, 1 },
+  { "page_loop", draw_nothing, 0, 0 },
+};
+
+/*========================================================*/
+/* measurement */
+
+static unsigned long long get_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long count_pixel(u8g2_t *u8g2)
+{
+  uint8_t *p = u8g2_GetBufferPtr(u8g2);
+  size_t cnt = (size_t)u8g2_GetBufferTileWidth(u8g2)*u8g2_GetBufferTileHeight(u8g2)*8;
+  unsigned long pixel = 0;
+  uint8_t b;
+  while( cnt > 0 )
+  {
+    for( b = *p++; b != 0; b &= b-1 )
+      pixel++;
+    cnt--;
+  }
+  return pixel;
+}
+
+/* setup the display with empty byte procedure, nothing is transferred */
+static void setup(struct buffer_struct *buffer, struct rotation_struct *rotation)
+{
+  buffer->setup(&u8g2, rotation->cb, u8x8_byte_empty, u8x8_dummy_cb);
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+  u8g2_SetFontMode(&u8g2, 1);
+}
+
+/* pixels set by one operation with draw color 1, full buffer */
+static unsigned long get_pixel_per_op(struct primitive_struct *primitive, struct rotation_struct *rotation, uint8_t size)
+{
+  setup(buffer_list+2, rotation);
+  u8g2_ClearBuffer(&u8g2);
+  u8g2_SetDrawColor(&u8g2, 1);
+  primitive->draw(&u8g2, size);
+  return count_pixel(&u8g2);
+}
+
+/* repetitions for one run, the same for all buffer modes and rotations */
+static unsigned long get_reps(unsigned long pixel_per_op)
+{
+  return 200000UL/(pixel_per_op+64) + 4;
+}
+
+/* best time of all runs for one operation */
+static double measure(struct primitive_struct *primitive, uint8_t size, unsigned long reps, int run_cnt)
+{
+  uint8_t tile_height = u8g2_GetU8x8(&u8g2)->display_info->tile_height;
+  uint8_t buf_height = u8g2_GetBufferTileHeight(&u8g2);
+  unsigned long long t, best = 0;
+  unsigned long i;
+  uint8_t row;
+  int run;
+
+  for( run = 0; run < run_cnt; run++ )
+  {
+    if ( primitive->draw == draw_nothing )
+    {
+      t = get_ns();
+      for( i = 0; i < reps; i++ )
+      {
+	u8g2_FirstPage(&u8g2);
+	do
+	{
+	} while( u8g2_NextPage(&u8g2) );
+      }
+      t = get_ns() - t;
+    }
+    else
+    {
+      u8g2_ClearBuffer(&u8g2);
+      t = get_ns();
+      for( row = 0; row < tile_height; row += buf_height )
+      {
+	u8g2_SetBufferCurrTileRow(&u8g2, row);
+	for( i = 0; i < reps; i++ )
+	  primitive->draw(&u8g2, size);
+      }
+      t = get_ns() - t;
+    }
+    if ( run == 0 || t < best )
+      best = t;
+  }
+  return (double)best/(double)reps;
+}
+
+int main(int argc, char **argv)
+{
+  int is_json = 0;
+  int run_cnt = RUN_CNT;
+  const char *filter = NULL;
+  size_t p, r, b;
+  uint8_t size, size_cnt, color, color_first;
+  unsigned long pixel_per_op, reps;
+  double ns;
+  int is_first = 1;
+  int i;
+
+  for( i = 1; i < argc; i++ )
+  {
+    if ( strcmp(argv[i], "-j") == 0 )
+      is_json = 1;
+    else if ( strcmp(argv[i], "-q") == 0 )
+      run_cnt = 1;
+    else if ( strcmp(argv[i], "-p") == 0 && i+1 < argc )
+      filter = argv[++i];
+    else
+    {
+      fprintf(stderr, "usage: %s [-j] [-q] [-p <primitive>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  for( i = 0; i < (int)sizeof(xbm_bits); i++ )
+    xbm_bits[i] = (i*37+11) ^ (i>>2);
+
+  if ( is_json )
+    printf("[\n");
+  else
+    printf("primitive,size,color,rotation,buffer,reps,ns_per_op,pixels_per_op,pixels_per_s\n");
+
+  for( p = 0; p < sizeof(primitive_list)/sizeof(*primitive_list); p++ )
+  {
+    if ( filter != NULL && strncmp(primitive_list[p].name, filter, strlen(filter)) != 0 )
+      continue;
+    size_cnt = primitive_list[p].is_size ? SIZE_CNT : 1;
+    color_first = primitive_list[p].is_color ? 0 : 1;
+    for( size = 0; size < size_cnt; size++ )
+    {
+      for( r = 0; r < sizeof(rotation_list)/sizeof(*rotation_list); r++ )
+      {
+	pixel_per_op = get_pixel_per_op(primitive_list+p, rotation_list+r, size);
+	reps = get_reps(pixel_per_op);
+	if ( primitive_list[p].draw == draw_nothing )
+	  reps = 64;
+	for( b = 0; b < sizeof(buffer_list)/sizeof(*buffer_list); b++ )
+	{
+	  setup(buffer_list+b, rotation_list+r);
+	  for( color = color_first; color <= (primitive_list[p].is_color ? 2 : 1); color++ )
+	  {
+	    u8g2_SetDrawColor(&u8g2, color);
+	    ns = measure(primitive_list+p, size, reps, run_cnt);
+	    if ( is_json )
+	    {
+	      printf("%s  {\"primitive\": \"%s\", \"size\": \"%s\", \"color\": %d, \"rotation\": \"%s\", \"buffer\": \"%s\", "
+		"\"reps\": %lu, \"ns_per_op\": %.1f, \"pixels_per_op\": %lu, \"pixels_per_s\": %.0f}",
+		is_first ? "" : ",\n",
+		primitive_list[p].name, primitive_list[p].is_size ? size_name[size] : "-", color,
+		rotation_list[r].name, buffer_list[b].name, reps, ns, pixel_per_op,
+		ns > 0.0 ? pixel_per_op*1e9/ns : 0.0);
+	    }
+	    else
+	    {
+	      printf("%s,%s,%d,%s,%s,%lu,%.1f,%lu,%.0f\n",
+		primitive_list[p].name, primitive_list[p].is_size ? size_name[size] : "-", color,
+		rotation_list[r].name, buffer_list[b].name, reps, ns, pixel_per_op,
+		ns > 0.0 ? pixel_per_op*1e9/ns : 0.0);
+	    }
+	    is_first = 0;
+	  }
+	}
+      }
+    }
+  }
+  if ( is_json )
+    printf("\n]\n");
+  return 0;
+}
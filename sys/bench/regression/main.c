@@ -0,0 +1,741 @@
+/*
+
+  regression
+
+  Render a fixed catalogue of scenes and compare the buffer hash with a
+  baseline. Optionally, the draw time is compared also. The scenes are the display parts of the
+  reference manual pictures (sys/tga/ref_man_pics_u8g2) and the sys/utf8
+  picture loops.
+
+  Each scene is drawn with a 128x64 SSD1306 setup and the empty byte
+  procedure for the _1, _2 and _f buffer and for the rotations R0-R3 and
+  mirror. The hash is calculated over all pages of the picture loop, so
+  it is the same for all buffer modes of a rotation.
+
+  The time is only measured with -t. It is the best of several runs for 
+  one complete picture loop. Each run measures all entries, one after the
+  other. Draw times depend on the machine, so the committed baseline.csv
+  contains only the hash values. For a time check, create a local
+  baseline with the time values first:
+    regression -u -t 25 -b time.csv
+    regression -t 25 -b time.csv
+
+  usage: regression [-b <baseline>] [-u] [-t <percent>] [-s <scene>] [-q]
+    -b	baseline file (default: baseline.csv)
+    -u	write the baseline file instead of comparing
+    -t	measure the draw time and compare it with the time of the baseline,
+	time tolerance in percent (e.g. 25), with -u: write the time values
+    -s	only scenes which start with <scene>
+    -q	quick: one run for the time measurement instead of seven
+
+  exit code: 0: ok, 1: hash differs or entry is missing in the baseline,
+    2: hash ok, but at least one scene is slower than the tolerance (-t)
+
+*/
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RUN_CNT 7
+#define LOOP_CNT 50
+#define MAX_ENTRIES 1024
+/* time differences below this value are ignored */
+#define MIN_TIME_DIFF_NS 2000.0
+
+typedef void (*setup_cb)(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
+
+struct buffer_struct
+{
+  const char *name;
+  setup_cb setup;
+};
+
+struct buffer_struct buffer_list[] =
+{
+  { "1", u8g2_Setup_ssd1306_128x64_noname_1 },
+  { "2", u8g2_Setup_ssd1306_128x64_noname_2 },
+  { "f", u8g2_Setup_ssd1306_128x64_noname_f },
+};
+
+struct rotation_struct
+{
+  const char *name;
+  const u8g2_cb_t *cb;
+};
+
+struct rotation_struct rotation_list[] =
+{
+  { "r0", U8G2_R0 },
+  { "r1", U8G2_R1 },
+  { "r2", U8G2_R2 },
+  { "r3", U8G2_R3 },
+  { "mirror", U8G2_MIRROR },
+};
+
+struct baseline_struct
+{
+  char scene[32];
+  char rotation[8];
+  char buffer[4];
+  unsigned long hash;
+  double ns;		/* 0, if the baseline has no time value */
+};
+
+struct baseline_struct baseline[MAX_ENTRIES];
+int baseline_cnt = 0;
+
+/* one scene, rotation and buffer mode */
+struct entry_struct
+{
+  struct scene_struct *scene;
+  struct rotation_struct *rotation;
+  struct buffer_struct *buffer;
+  unsigned long hash;
+  double ns;		/* best time of all runs */
+};
+
+struct entry_struct entry_list[MAX_ENTRIES];
+int entry_cnt = 0;
+
+u8g2_t u8g2;
+
+#define u8g2_logo_97x51_width 97
+#define u8g2_logo_97x51_height 51
+static unsigned char u8g2_logo_97x51_bits[] = {
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x3c, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x00,
+   0x00, 0x00, 0x3c, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe,
+   0x03, 0x00, 0x00, 0x3c, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0xff, 0x03, 0x00, 0x00, 0x3c, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x80, 0xcf, 0x07, 0x00, 0x00, 0x3c, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x80, 0x83, 0x07, 0x00, 0x00, 0x3c, 0x80, 0x07, 0xf8, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x81, 0x07, 0x00, 0x00, 0x3c, 0x80, 0x07, 0xfc, 0x03,
+   0x1c, 0x00, 0x3e, 0x1c, 0xc0, 0x03, 0x00, 0x00, 0x3c, 0x80, 0x07, 0xff,
+   0x07, 0x7f, 0x80, 0xff, 0x3f, 0xe0, 0x01, 0x00, 0x00, 0x3c, 0x80, 0x07,
+   0xff, 0x8f, 0xff, 0xc1, 0xff, 0x3f, 0xf0, 0x00, 0x00, 0x00, 0x3c, 0x80,
+   0x87, 0xff, 0xdf, 0xff, 0xc1, 0xc3, 0x07, 0x7c, 0x00, 0x00, 0x00, 0x3c,
+   0x80, 0x87, 0x0f, 0xfe, 0xff, 0xe3, 0x81, 0x03, 0x1e, 0x00, 0x00, 0x00,
+   0x3c, 0x80, 0xc7, 0x07, 0xfc, 0xe3, 0xe3, 0x81, 0x07, 0x0f, 0x00, 0x00,
+   0x00, 0x3c, 0x80, 0xc7, 0x07, 0xf8, 0xc1, 0xe7, 0x81, 0x87, 0xff, 0x07,
+   0x00, 0x00, 0x3c, 0x80, 0xc7, 0x03, 0xf0, 0x80, 0xe7, 0xc3, 0x87, 0xff,
+   0x07, 0x00, 0x00, 0x3c, 0x80, 0xc7, 0x03, 0x70, 0x80, 0xc7, 0xe7, 0x83,
+   0xff, 0x07, 0x00, 0x00, 0x3c, 0x80, 0xc7, 0x03, 0x78, 0x80, 0xc7, 0xff,
+   0x03, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x80, 0xc7, 0x03, 0xf8, 0xc0, 0x87,
+   0xff, 0x01, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x80, 0xc7, 0x07, 0xfc, 0xc1,
+   0xc7, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0xc0, 0x87, 0x0f, 0xfe,
+   0xff, 0xe3, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x78, 0xc0, 0x83, 0xff,
+   0xdf, 0xff, 0xe3, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0xf1, 0x03,
+   0xff, 0x8f, 0xff, 0xe1, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xff,
+   0x01, 0xfe, 0x0f, 0xff, 0xc0, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00, 0xe0,
+   0xff, 0x00, 0xfc, 0x03, 0x7c, 0xc0, 0xff, 0x1f, 0x00, 0x00, 0x00, 0x00,
+   0x80, 0x3f, 0x00, 0xf8, 0x01, 0x00, 0xe0, 0x01, 0x1e, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x1e, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x1e, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0xf0, 0xc7, 0x0f,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0xe0, 0xff,
+   0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0xc0,
+   0xff, 0x03, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0x01, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x24, 0x20, 0x00,
+   0x00, 0x08, 0x46, 0x02, 0x00, 0x80, 0xc0, 0x40, 0x00, 0x0c, 0x6e, 0x6a,
+   0xc0, 0xa4, 0x48, 0x04, 0xaa, 0xac, 0x8c, 0xaa, 0xac, 0x00, 0x6a, 0xa4,
+   0xaa, 0x20, 0xea, 0xa4, 0x64, 0x66, 0xaa, 0x46, 0x4a, 0x8a, 0x00, 0x4c,
+   0xa4, 0xaa, 0x20, 0xaa, 0xa2, 0x44, 0x2a, 0xaa, 0x28, 0xaa, 0x4c, 0x00,
+   0xe8, 0xa8, 0x6c, 0xc4, 0xa4, 0x42, 0xee, 0x2a, 0xcc, 0x26, 0x6c, 0xe8,
+   0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+   0x00, 0x00, 0x00 };
+
+
+static unsigned char xbm_bits[] = {
+   0xff, 0xff, 0x07, 0x01, 0x00, 0x04, 0x01, 0x00, 0x04, 0x01, 0x08, 0x04,
+   0xe1, 0x1e, 0x04, 0xb1, 0x13, 0x04, 0x11, 0x11, 0x04, 0x11, 0x79, 0x04,
+   0xf1, 0x4f, 0x04, 0x99, 0xc4, 0x04, 0x89, 0x7f, 0x04, 0xc9, 0x38, 0x04,
+   0xf1, 0x08, 0x04, 0x81, 0x08, 0x04, 0x81, 0x0f, 0x04, 0x01, 0xe2, 0x04,
+   0x01, 0xda, 0x04, 0x01, 0xba, 0x04, 0x01, 0x9e, 0x04, 0x01, 0x4e, 0x04,
+   0x01, 0x7e, 0x04, 0x01, 0x1e, 0x04, 0x01, 0x06, 0x04, 0x01, 0x06, 0x04,
+   0x01, 0x06, 0x04, 0x01, 0x02, 0x04, 0x01, 0x00, 0x04, 0x01, 0x00, 0x04,
+   0xff, 0xff, 0x07 };
+
+
+static const unsigned char hbitmap_bits[] = { 0xa5, 0x3c };
+
+/*========================================================*/
+/* scenes from sys/tga/ref_man_pics_u8g2 */
+
+static void scene_hello_world(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_ncenB14_tf);
+  u8g2_DrawStr(u8g2, 0, 15, "Hello World!");
+}
+
+static void scene_ascent_descent(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_ncenB18_tf);
+  u8g2_DrawStr(u8g2, 5, 20, "A  gi");
+}
+
+static void scene_pos_center(u8g2_t *u8g2)
+{
+  u8g2_SetFontPosCenter(u8g2);
+  u8g2_SetFont(u8g2, u8g2_font_ncenB18_tf);
+  u8g2_DrawStr(u8g2, 5, 20, "Agi");
+}
+
+static void scene_snowman(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_unifont_t_symbols);
+  u8g2_DrawGlyph(u8g2, 5, 20, 0x2603);
+  u8g2_DrawUTF8(u8g2, 5, 40, "Snowman: \xe2\x98\x83");
+}
+
+static void scene_logo(u8g2_t *u8g2)
+{
+  u8g2_SetFontMode(u8g2, 1);
+  u8g2_SetFont(u8g2, u8g2_font_inb24_mf);
+  u8g2_DrawStr(u8g2, 0, 30, "U");
+  u8g2_SetFontDirection(u8g2, 1);
+  u8g2_SetFont(u8g2, u8g2_font_inb30_mr);
+  u8g2_DrawStr(u8g2, 21, 8,"8");
+  u8g2_SetFont(u8g2, u8g2_font_inb24_mf);
+  u8g2_SetFontDirection(u8g2, 0);
+  u8g2_DrawStr(u8g2, 51,30,"g");
+  u8g2_DrawStr(u8g2, 67,30,"\xb2");
+  u8g2_DrawHLine(u8g2, 2, 35, 47);
+  u8g2_DrawHLine(u8g2, 3, 36, 47);
+  u8g2_DrawVLine(u8g2, 45, 32, 12);
+  u8g2_DrawVLine(u8g2, 46, 33, 12);
+  u8g2_SetFont(u8g2, u8g2_font_4x6_tr);
+  u8g2_DrawStr(u8g2, 1,54,"github.com/olikraus/u8g2");
+}
+
+static void scene_c_frame(u8g2_t *u8g2)
+{
+  const char *s = "Cage";
+  u8g2_uint_t w, h;
+  u8g2_SetFont(u8g2, u8g2_font_helvR08_tr);
+  w = u8g2_GetStrWidth(u8g2, s);
+  h = u8g2_GetAscent(u8g2)-u8g2_GetDescent(u8g2);
+  u8g2_DrawStr(u8g2, 5, 11, s);
+  u8g2_DrawFrame(u8g2, 5-1, 11-u8g2_GetAscent(u8g2)-1, w+2, h+2);
+}
+
+static void scene_button(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_helvR08_tr);
+  u8g2_DrawButtonUTF8(u8g2, 62, 12, U8G2_BTN_BW2, 0,  2,  2, "Btn");
+  u8g2_DrawButtonUTF8(u8g2, 62, 28, U8G2_BTN_HCENTER|U8G2_BTN_BW2, 34,  2,  2, "Btn");
+  u8g2_DrawButtonUTF8(u8g2, 62, 44, U8G2_BTN_SHADOW1|U8G2_BTN_HCENTER|U8G2_BTN_BW2, 34,  2,  2, "Btn");
+  u8g2_DrawButtonUTF8(u8g2, 5, 12, U8G2_BTN_INV, 0,  2,  2, "Btn");
+  u8g2_DrawButtonUTF8(u8g2, 5, 28, U8G2_BTN_INV|U8G2_BTN_BW2, 0,  2,  2, "Btn");
+  u8g2_DrawButtonUTF8(u8g2, 5, 60, U8G2_BTN_INV, u8g2_GetDisplayWidth(u8g2)-5*2,  5,  2, "Btn");
+}
+
+static void scene_shapes(u8g2_t *u8g2)
+{
+  u8g2_DrawBox(u8g2, 3, 7, 25, 15);
+  u8g2_DrawFrame(u8g2, 3, 27, 25, 15);
+  u8g2_DrawEllipse(u8g2, 50, 25, 15, 10, U8G2_DRAW_ALL);
+  u8g2_DrawCircle(u8g2, 50, 25, 10, U8G2_DRAW_ALL);
+  u8g2_DrawRFrame(u8g2, 70, 15, 30, 22, 7);
+  u8g2_DrawTriangle(u8g2, 100, 5, 107, 50, 85, 32);
+  u8g2_DrawLine(u8g2, 20, 5, 5, 62);
+}
+
+static void scene_font_direction(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_ncenB14_tf);
+  u8g2_SetFontDirection(u8g2, 0);
+  u8g2_DrawStr(u8g2, 15, 20, "Abc");
+  u8g2_SetFontDirection(u8g2, 1);
+  u8g2_DrawStr(u8g2, 15, 20, "Abc");
+  u8g2_SetFontDirection(u8g2, 2);
+  u8g2_DrawStr(u8g2, 100, 40, "Abc");
+  u8g2_SetFontDirection(u8g2, 3);
+  u8g2_DrawStr(u8g2, 100, 40, "Abc");
+}
+
+static void scene_xor(u8g2_t *u8g2)
+{
+  u8g2_DrawBox(u8g2, 22, 2, 35, 50);
+  u8g2_SetFont(u8g2, u8g2_font_ncenB14_tf);
+  u8g2_SetDrawColor(u8g2, 0);
+  u8g2_DrawStr(u8g2, 5, 18, "abcd");
+  u8g2_SetDrawColor(u8g2, 1);
+  u8g2_DrawStr(u8g2, 5, 33, "abcd");
+  u8g2_SetDrawColor(u8g2, 2);
+  u8g2_DrawStr(u8g2, 5, 48, "abcd");
+}
+
+static void scene_bitmap_solid(u8g2_t *u8g2)
+{
+  u8g2_SetBitmapMode(u8g2, 0);
+  u8g2_DrawXBM(u8g2, 4,3, u8g2_logo_97x51_width, u8g2_logo_97x51_height,  u8g2_logo_97x51_bits);
+  u8g2_DrawXBM(u8g2, 12,11, u8g2_logo_97x51_width, u8g2_logo_97x51_height,  u8g2_logo_97x51_bits);
+}
+
+static void scene_bitmap_transparent(u8g2_t *u8g2)
+{
+  u8g2_SetBitmapMode(u8g2, 1);
+  u8g2_DrawXBM(u8g2, 4,3, u8g2_logo_97x51_width, u8g2_logo_97x51_height,  u8g2_logo_97x51_bits);
+  u8g2_DrawXBM(u8g2, 12,11, u8g2_logo_97x51_width, u8g2_logo_97x51_height,  u8g2_logo_97x51_bits);
+}
+
+static void draw_checkerboard(u8g2_t *u8g2)
+{
+  u8g2_uint_t x,y;
+  for( y = 0; y < u8g2_GetDisplayHeight(u8g2); y++ )
+    for( x = 0; x < u8g2_GetDisplayWidth(u8g2); x++ )
+      if ( (x ^ y) & 1 )
+        u8g2_DrawPixel(u8g2, x, y);
+}
+
+static void scene_color(u8g2_t *u8g2)
+{
+  draw_checkerboard(u8g2);
+  u8g2_SetFont(u8g2, u8g2_font_9x15B_mf);
+  u8g2_DrawStr(u8g2, 3, 20, "Color = 1");
+  u8g2_SetDrawColor(u8g2, 0);
+  u8g2_DrawStr(u8g2, 3, 40, "Color = 0");
+}
+
+static void scene_fontmode(u8g2_t *u8g2)
+{
+  draw_checkerboard(u8g2);
+  u8g2_SetFont(u8g2, u8g2_font_8x13B_mf);
+  u8g2_SetFontMode(u8g2, 0);
+  u8g2_DrawStr(u8g2, 3, 15, "Color=1, Mode 0");
+  u8g2_SetDrawColor(u8g2, 0);
+  u8g2_DrawStr(u8g2, 3, 30, "Color=0, Mode 0");
+  u8g2_SetFontMode(u8g2, 1);
+  u8g2_SetDrawColor(u8g2, 1);
+  u8g2_DrawStr(u8g2, 3, 45, "Color=1, Mode 1");
+  u8g2_SetDrawColor(u8g2, 0);
+  u8g2_DrawStr(u8g2, 3, 60, "Color=0, Mode 1");
+}
+
+static void scene_clip_window(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_ncenB24_tf);
+  u8g2_SetClipWindow(u8g2, 10, 10, 85, 30);
+  u8g2_DrawStr(u8g2, 3, 32, "U8g2");
+}
+
+/*========================================================*/
+/* scenes from the sys/utf8 picture loops */
+
+static void scene_box(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawBox(u8g2, 2, 3, 7, 9);
+  u8g2_DrawBox(u8g2, 12, 3, 2, 13);
+  u8g2_DrawBox(u8g2, 12,17, 13, 2);
+  u8g2_DrawFrame(u8g2, 2,21, 11, 7);
+  u8g2_DrawFrame(u8g2, 25,24, 27, 5);
+  u8g2_DrawStr(u8g2, 30, 10, "DrawBox");
+  u8g2_DrawStr(u8g2, 30, 20, "DrawFrame");
+}
+
+static void scene_circle(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawCircle(u8g2, 7, 11, 5, U8G2_DRAW_ALL);
+  u8g2_DrawEllipse(u8g2, 19, 11, 5, 5, U8G2_DRAW_ALL);
+  u8g2_DrawDisc(u8g2, 7, 11+14, 5, U8G2_DRAW_ALL);
+  u8g2_DrawFilledEllipse(u8g2, 19, 11+14, 5, 5, U8G2_DRAW_ALL);
+  u8g2_DrawEllipse(u8g2, 60, 11+12, 17, 5, U8G2_DRAW_ALL);
+  u8g2_DrawFilledEllipse(u8g2, 100, 40, 23, 27, U8G2_DRAW_ALL);
+  u8g2_DrawStr(u8g2, 30, 10, "Circle&Disk");
+}
+
+static void scene_rbox(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawRBox(u8g2, 2, 3, 8, 9, 3);
+  u8g2_DrawRBox(u8g2, 12, 3, 5, 13, 2);
+  u8g2_DrawRBox(u8g2, 12,17, 13, 3, 1);
+  u8g2_DrawRFrame(u8g2, 2,21, 11, 7, 3);
+  u8g2_DrawRFrame(u8g2, 25,24, 27, 5, 2);
+  u8g2_DrawRFrame(u8g2, 23,22, 31, 9, 3);
+  u8g2_DrawStr(u8g2, 30, 10, "RBox");
+  u8g2_DrawStr(u8g2, 30, 20, "RFrame");
+}
+
+static void scene_frame_clip(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawFrame(u8g2, 0, 0, u8g2_GetDisplayWidth(u8g2), u8g2_GetDisplayHeight(u8g2));
+  u8g2_DrawPixel(u8g2, 3, 3);
+  u8g2_DrawHLine(u8g2, u8g2_GetDisplayWidth(u8g2)-1, 2, 4);
+  u8g2_DrawStr(u8g2, 10, 20, "Frame");
+  u8g2_DrawStr(u8g2, u8g2_GetDisplayWidth(u8g2)-9, 40, "Clip");
+}
+
+static void scene_line(u8g2_t *u8g2)
+{
+  u8g2_uint_t i;
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawLine(u8g2, 2, 3, 7, 9);
+  for( i = 0; i < 64; i += 6 )
+    u8g2_DrawLine(u8g2, 0, i, 127, 63-i);
+  u8g2_DrawStr(u8g2, 30, 10, "DrawLine");
+}
+
+static void scene_polygon(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawTriangle(u8g2, 2, 2, 17, 9, 7, 21);
+  u8g2_ClearPolygonXY();
+  u8g2_AddPolygonXY(u8g2, 80, 20);
+  u8g2_AddPolygonXY(u8g2, 120, 30);
+  u8g2_AddPolygonXY(u8g2, 100, 62);
+  u8g2_AddPolygonXY(u8g2, 70, 50);
+  u8g2_DrawPolygon(u8g2);
+  u8g2_DrawStr(u8g2, 22, 10, "DrawTriangle");
+}
+
+static void scene_bitmap(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawXBM(u8g2, 1, 1, 19, 29, xbm_bits);
+  u8g2_DrawHorizontalBitmap(u8g2, 0, 40, 10, hbitmap_bits);
+  u8g2_DrawStr(u8g2, 30, 20, "XBM");
+}
+
+static void scene_inverted_text(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_mf);
+  u8g2_DrawBox(u8g2, 2, 8, 70, 20);
+  u8g2_SetDrawColor(u8g2, 0);
+  u8g2_DrawStr(u8g2, 10, 14, "Hello World!");
+  u8g2_DrawBox(u8g2, 9, 15, 31, 2);
+}
+
+static void scene_utf8_line(u8g2_t *u8g2)
+{
+  u8g2_SetFont(u8g2, u8g2_font_6x13_tf);
+  u8g2_DrawUTF8Line(u8g2, 5, 15, 10, "Agile", 2,1);
+  u8g2_DrawUTF8Line(u8g2, 5, 35, 80, "Agile", 1,0);
+}
+
+struct scene_struct
+{
+  const char *name;
+  void (*draw)(u8g2_t *u8g2);
+};
+
+struct scene_struct scene_list[] =
+{
+  { "hello_world", scene_hello_world },
+  { "ascent_descent", scene_ascent_descent },
+  { "pos_center", scene_pos_center },
+  { "snowman", scene_snowman },
+  { "logo", scene_logo },
+  { "c_frame", scene_c_frame },
+  { "button", scene_button },
+  { "shapes", scene_shapes },
+  { "font_direction", scene_font_direction },
+  { "xor", scene_xor },
+  { "bitmap_solid", scene_bitmap_solid },
+  { "bitmap_transparent", scene_bitmap_transparent },
+  { "color", scene_color },
+  { "fontmode", scene_fontmode },
+  { "clip_window", scene_clip_window },
+  { "box", scene_box },
+  { "circle", scene_circle },
+  { "rbox", scene_rbox },
+  { "frame_clip", scene_frame_clip },
+  { "line", scene_line },
+  { "polygon", scene_polygon },
+  { "bitmap", scene_bitmap },
+  { "inverted_text", scene_inverted_text },
+  { "utf8_line", scene_utf8_line },
+};
+
+/*========================================================*/
+/* rendering */
+
+static unsigned long long get_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+
+/* FNV-1a */
+static unsigned long hash_bytes(unsigned long hash, const uint8_t *p, size_t cnt)
+{
+  while( cnt > 0 )
+  {
+    hash ^= *p++;
+    hash = (hash * 16777619UL) & 0x0ffffffffUL;
+    cnt--;
+  }
+  return hash;
+}
+
+/* the state, which might be changed by a scene */
+static void reset_state(u8g2_t *u8g2)
+{
+  u8g2_SetMaxClipWindow(u8g2);
+  u8g2_SetDrawColor(u8g2, 1);
+  u8g2_SetFontMode(u8g2, 0);
+  u8g2_SetBitmapMode(u8g2, 0);
+  u8g2_SetFontDirection(u8g2, 0);
+  u8g2_SetFontPosBaseline(u8g2);
+}
+
+/* draw one picture loop, return the hash of all pages if is_hash is not 0 */
+static unsigned long render(struct scene_struct *scene, int is_hash)
+{
+  uint8_t tile_height = u8g2_GetU8x8(&u8g2)->display_info->tile_height;
+  unsigned long hash = 2166136261UL;
+  uint8_t rows;
+
+  u8g2_FirstPage(&u8g2);
+  do
+  {
+    reset_state(&u8g2);
+    scene->draw(&u8g2);
+    if ( is_hash )
+    {
+      rows = u8g2_GetBufferTileHeight(&u8g2);
+      if ( rows > tile_height - u8g2.tile_curr_row )
+        rows = tile_height - u8g2.tile_curr_row;
+      hash = hash_bytes(hash, u8g2_GetBufferPtr(&u8g2), (size_t)u8g2_GetBufferTileWidth(&u8g2)*rows*8);
+    }
+  } while( u8g2_NextPage(&u8g2) );
+  return hash;
+}
+
+/* time for one picture loop */
+static double measure(struct scene_struct *scene)
+{
+  unsigned long long t;
+  int i;
+
+  t = get_ns();
+  for( i = 0; i < LOOP_CNT; i++ )
+    render(scene, 0);
+  t = get_ns() - t;
+  return (double)t/LOOP_CNT;
+}
+
+static void setup(struct buffer_struct *buffer, struct rotation_struct *rotation)
+{
+  buffer->setup(&u8g2, rotation->cb, u8x8_byte_empty, u8x8_dummy_cb);
+  u8g2_InitDisplay(&u8g2);
+  u8g2_SetPowerSave(&u8g2, 0);
+}
+
+/*========================================================*/
+/* baseline */
+
+static int read_baseline(const char *filename)
+{
+  FILE *fp;
+  char line[256];
+  struct baseline_struct *b;
+
+  fp = fopen(filename, "r");
+  if ( fp == NULL )
+    return 0;
+  while( fgets(line, sizeof(line), fp) != NULL && baseline_cnt < MAX_ENTRIES )
+  {
+    b = baseline + baseline_cnt;
+    b->ns = 0.0;
+    if ( sscanf(line, "%31[^,],%7[^,],%3[^,],%lx,%lf", b->scene, b->rotation, b->buffer, &b->hash, &b->ns) >= 4 )
+      baseline_cnt++;
+  }
+  fclose(fp);
+  return 1;
+}
+
+static struct baseline_struct *find_baseline(const char *scene, const char *rotation, const char *buffer)
+{
+  int i;
+  for( i = 0; i < baseline_cnt; i++ )
+    if ( strcmp(baseline[i].scene, scene) == 0 && strcmp(baseline[i].rotation, rotation) == 0 && strcmp(baseline[i].buffer, buffer) == 0 )
+      return baseline+i;
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  const char *baseline_name = "baseline.csv";
+  const char *filter = NULL;
+  int is_update = 0;
+  double tolerance = 0.0;		/* 0: do not measure the time */
+  int run_cnt = RUN_CNT;
+  FILE *out = NULL;
+  struct baseline_struct *b;
+  struct entry_struct *e;
+  size_t s, r, f;
+  double ns;
+  const char *status;
+  int hash_err = 0, slow_cnt = 0;
+  int run, i;
+
+  for( i = 1; i < argc; i++ )
+  {
+    if ( strcmp(argv[i], "-b") == 0 && i+1 < argc )
+      baseline_name = argv[++i];
+    else if ( strcmp(argv[i], "-u") == 0 )
+      is_update = 1;
+    else if ( strcmp(argv[i], "-t") == 0 && i+1 < argc )
+      tolerance = atof(argv[++i]);
+    else if ( strcmp(argv[i], "-s") == 0 && i+1 < argc )
+      filter = argv[++i];
+    else if ( strcmp(argv[i], "-q") == 0 )
+      run_cnt = 1;
+    else
+    {
+      fprintf(stderr, "usage: %s [-b <baseline>] [-u] [-t <percent>] [-s <scene>] [-q]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  if ( is_update )
+  {
+    out = fopen(baseline_name, "w");
+    if ( out == NULL )
+    {
+      perror(baseline_name);
+      return 1;
+    }
+    if ( tolerance > 0.0 )
+      fprintf(out, "scene,rotation,buffer,hash,ns_per_frame\n");
+    else
+      fprintf(out, "scene,rotation,buffer,hash\n");
+  }
+  else
+  {
+    if ( read_baseline(baseline_name) == 0 )
+    {
+      perror(baseline_name);
+      return 1;
+    }
+    if ( tolerance > 0.0 )
+      printf("scene,rotation,buffer,hash,baseline_hash,ns_per_frame,baseline_ns_per_frame,status\n");
+    else
+      printf("scene,rotation,buffer,hash,baseline_hash,status\n");
+  }
+
+  /* render all entries once for the hash */
+  for( s = 0; s < sizeof(scene_list)/sizeof(*scene_list); s++ )
+  {
+    if ( filter != NULL && strncmp(scene_list[s].name, filter, strlen(filter)) != 0 )
+      continue;
+    for( r = 0; r < sizeof(rotation_list)/sizeof(*rotation_list); r++ )
+    {
+      for( f = 0; f < sizeof(buffer_list)/sizeof(*buffer_list) && entry_cnt < MAX_ENTRIES; f++ )
+      {
+        e = entry_list + entry_cnt++;
+        e->scene = scene_list+s;
+        e->rotation = rotation_list+r;
+        e->buffer = buffer_list+f;
+        setup(e->buffer, e->rotation);
+        e->hash = render(e->scene, 1);
+        e->ns = 0.0;
+      }
+    }
+  }
+
+  /* each run measures all entries, so that a temporary slow down of the
+     machine does not affect all runs of the same entry */
+  for( run = 0; tolerance > 0.0 && run < run_cnt; run++ )
+  {
+    for( i = 0; i < entry_cnt; i++ )
+    {
+      e = entry_list + i;
+      setup(e->buffer, e->rotation);
+      ns = measure(e->scene);
+      if ( run == 0 || ns < e->ns )
+        e->ns = ns;
+    }
+  }
+
+  for( i = 0; i < entry_cnt; i++ )
+  {
+    e = entry_list + i;
+    if ( is_update )
+    {
+      /* all buffer modes must render the same picture */
+      if ( e->buffer != buffer_list && e->hash != e[-1].hash )
+      {
+        fprintf(stderr, "%s,%s,%s: hash differs from buffer %s\n", e->scene->name, e->rotation->name, e->buffer->name, e[-1].buffer->name);
+        hash_err++;
+      }
+      if ( tolerance > 0.0 )
+        fprintf(out, "%s,%s,%s,%08lx,%.0f\n", e->scene->name, e->rotation->name, e->buffer->name, e->hash, e->ns);
+      else
+        fprintf(out, "%s,%s,%s,%08lx\n", e->scene->name, e->rotation->name, e->buffer->name, e->hash);
+      continue;
+    }
+
+    b = find_baseline(e->scene->name, e->rotation->name, e->buffer->name);
+    status = "ok";
+    if ( b == NULL )
+    {
+      status = "MISSING";
+      hash_err++;
+    }
+    else if ( b->hash != e->hash )
+    {
+      status = "HASH";
+      hash_err++;
+    }
+    else if ( tolerance <= 0.0 || b->ns <= 0.0 )
+    {
+      /* no time check */
+    }
+    else if ( e->ns > b->ns*(1.0+tolerance/100.0) && e->ns - b->ns > MIN_TIME_DIFF_NS )
+    {
+      status = "SLOW";
+      slow_cnt++;
+    }
+    else if ( e->ns < b->ns*(1.0-tolerance/100.0) && b->ns - e->ns > MIN_TIME_DIFF_NS )
+    {
+      status = "fast";
+    }
+    if ( tolerance > 0.0 )
+      printf("%s,%s,%s,%08lx,%08lx,%.0f,%.0f,%s\n", e->scene->name, e->rotation->name, e->buffer->name,
+        e->hash, b == NULL ? 0UL : b->hash, e->ns, b == NULL ? 0.0 : b->ns, status);
+    else
+      printf("%s,%s,%s,%08lx,%08lx,%s\n", e->scene->name, e->rotation->name, e->buffer->name,
+        e->hash, b == NULL ? 0UL : b->hash, status);
+  }
+
+  if ( is_update )
+  {
+    fclose(out);
+    fprintf(stderr, "%d entries written to %s\n", entry_cnt, baseline_name);
+    return hash_err > 0 ? 1 : 0;
+  }
+
+  if ( tolerance > 0.0 )
+    fprintf(stderr, "%d entries, %d hash differences, %d slower than %.0f%%\n", entry_cnt, hash_err, slow_cnt, tolerance);
+  else
+    fprintf(stderr, "%d entries, %d hash differences\n", entry_cnt, hash_err);
+  if ( hash_err > 0 )
+    return 1;
+  if ( slow_cnt > 0 )
+    return 2;
+  return 0;
+}
@@ -274,6 +274,9 @@ void u8g2_SetupBitmap(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, uint16_t pixel_wid
 
 static uint8_t u8x8_d_bitmap_chain(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
+  /* do not forward DRAW_FRAME, so that all rows will arrive as DRAW_TILE */
+  if ( msg == U8X8_MSG_DISPLAY_DRAW_FRAME )
+    return 0;
   if ( msg == U8X8_MSG_DISPLAY_DRAW_TILE )
     u8x8_d_bitmap(u8x8, msg, arg_int, arg_ptr);
   return u8x8_bitmap.u8x8_bitmap_display_old_cb(u8x8, msg, arg_int, arg_ptr);
@@ -0,0 +1,556 @@
+/*
+
+  u8x8_emu.c
+
+  Controller emulation: Interpret the bytes, which are sent by the
+  cad and byte procedures and update a model of the controller RAM.
+
+  Supported controllers:
+    U8X8_EMU_SSD1306	SSD1306, SSD1309: page, horizontal and vertical addressing
+    U8X8_EMU_SH1106	SH1106: page addressing, 132 columns
+    U8X8_EMU_ST7565	ST7565, ST7567, UC1701: page addressing, 132 columns
+    U8X8_EMU_ST7920	ST7920: serial interface only
+    U8X8_EMU_SSD1322	SSD1322: 4 bit gray, any gray value other than 0 is a pixel
+
+  Supported interfaces:
+    U8X8_EMU_SPI		DC line, U8X8_MSG_BYTE_SET_DC
+    U8X8_EMU_I2C		SSD13xx control byte after U8X8_MSG_BYTE_START_TRANSFER
+  The ST7920 always uses the serial protocol with the 0x0f8/0x0fa sync byte.
+
+  The emulator is inserted in front of the byte procedure:
+
+    u8g2_Setup_ssd1306_128x64_noname_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_gpio_and_delay_emu);
+    u8x8_ConnectEmu(u8g2_GetU8x8(&u8g2), U8X8_EMU_SSD1306, U8X8_EMU_SPI);
+
+*/
+
+#include "stdlib.h"
+#include "string.h"	/* memset */
+#include "stdio.h"	/* FILE */
+#include "u8g2.h"
+
+#define U8X8_EMU_PAGE_RAM_WIDTH 256
+#define U8X8_EMU_PAGE_RAM_PAGES 16
+
+#define U8X8_EMU_ST7920_ROWS 64
+#define U8X8_EMU_ST7920_BYTES_PER_ROW 32
+
+#define U8X8_EMU_SSD1322_WIDTH 480
+#define U8X8_EMU_SSD1322_HEIGHT 128
+
+/*========================================================*/
+/* emulator struct */
+
+struct _u8x8_emu_struct
+{
+  u8x8_msg_cb byte_cb;		/* byte procedure, which receives all messages after the emulator */
+  uint8_t controller;
+  uint8_t interface;
+
+  /* interface state */
+  uint8_t dc;			/* 0: command (or arg), 1: data (or arg) */
+  uint8_t i2c_state;		/* 0: control byte expected, 1: continue with the same dc, 2: single byte, then control byte */
+  uint8_t st7920_rs;
+  uint8_t st7920_is_low_nibble;
+  uint8_t st7920_high_nibble;
+
+  /* command decoder */
+  uint8_t cmd;
+  uint8_t arg_cnt;		/* number of expected args */
+  uint8_t arg_pos;
+  uint8_t arg[8];
+
+  /* address counter */
+  uint16_t col, col_start, col_end;
+  uint16_t row, row_start, row_end;	/* page for the page controllers */
+  uint8_t addr_mode;		/* SSD1306: 0: horizontal, 1: vertical, 2: page */
+  uint8_t start_line;		/* SSD1306, SH1106: display start line */
+  uint8_t is_extended;		/* ST7920: extended instruction set */
+  uint8_t is_x_next;		/* ST7920: next address command is the x address */
+  uint8_t is_ram_write;		/* SSD1322: data after 0x05c */
+  uint8_t byte_pos;		/* position inside the current column or word */
+  uint8_t remap;		/* SSD1322: first arg of 0x0a0 */
+
+  uint8_t ram[U8X8_EMU_SSD1322_WIDTH*U8X8_EMU_SSD1322_HEIGHT];
+
+  /* statistics */
+  uint32_t byte_cnt;
+  uint32_t transfer_cnt;
+  uint32_t cmd_cnt;		/* bytes sent as command or arg */
+  uint32_t data_cnt;		/* bytes sent as display data */
+};
+
+typedef struct _u8x8_emu_struct u8x8_emu_t;
+
+u8x8_emu_t u8x8_emu;
+
+/*========================================================*/
+/* page controller: SSD1306, SH1106, ST7565 */
+
+/* number of args for a command, SSD1306, SSD1309 and SH1106 */
+static uint8_t u8x8_emu_ssd13xx_arg_cnt(uint8_t c)
+{
+  switch(c)
+  {
+    case 0x020: case 0x081: case 0x082: case 0x08d: case 0x0a8: case 0x0ad:
+    case 0x0d3: case 0x0d5: case 0x0d6: case 0x0d8: case 0x0d9: case 0x0da:
+    case 0x0db: case 0x0dc: case 0x0fd:
+      return 1;
+    case 0x021: case 0x022: case 0x0a3:
+      return 2;
+    case 0x029: case 0x02a: case 0x02c: case 0x02d:
+      return 5;
+    case 0x026: case 0x027:
+      return 6;
+  }
+  return 0;
+}
+
+/* number of args for a command, ST7565 and UC1701 */
+static uint8_t u8x8_emu_st7565_arg_cnt(uint8_t c)
+{
+  switch(c)
+  {
+    case 0x081: case 0x0ac: case 0x0ad: case 0x0f8: case 0x0fa:
+      return 1;
+  }
+  return 0;
+}
+
+static void u8x8_emu_page_cmd(u8x8_emu_t *emu)
+{
+  uint8_t c = emu->cmd;
+  if ( c < 0x010 )
+  {
+    emu->col = (emu->col & 0x0f0) | (c & 15);
+  }
+  else if ( c < 0x020 )
+  {
+    emu->col = (emu->col & 0x00f) | ((c & 15) << 4);
+  }
+  else if ( c >= 0x0b0 && c < 0x0c0 )
+  {
+    emu->row = c & 15;
+  }
+  else if ( c >= 0x040 && c < 0x080 && emu->controller != U8X8_EMU_ST7565 )
+  {
+    emu->start_line = c & 63;
+  }
+  else if ( emu->controller == U8X8_EMU_SSD1306 )
+  {
+    switch(c)
+    {
+      case 0x020:
+	emu->addr_mode = emu->arg[0] & 3;
+	break;
+      case 0x021:
+	emu->col_start = emu->arg[0];
+	emu->col_end = emu->arg[1];
+	emu->col = emu->col_start;
+	break;
+      case 0x022:
+	emu->row_start = emu->arg[0] & 15;
+	emu->row_end = emu->arg[1] & 15;
+	emu->row = emu->row_start;
+	break;
+    }
+  }
+}
+
+static void u8x8_emu_page_data(u8x8_emu_t *emu, uint8_t b)
+{
+  emu->ram[(emu->row % U8X8_EMU_PAGE_RAM_PAGES)*U8X8_EMU_PAGE_RAM_WIDTH + (emu->col % U8X8_EMU_PAGE_RAM_WIDTH)] = b;
+  if ( emu->controller != U8X8_EMU_SSD1306 || emu->addr_mode >= 2 )
+  {
+    emu->col++;
+    return;
+  }
+  if ( emu->addr_mode == 0 )
+  {
+    emu->col++;
+    if ( emu->col > emu->col_end )
+    {
+      emu->col = emu->col_start;
+      emu->row++;
+      if ( emu->row > emu->row_end )
+	emu->row = emu->row_start;
+    }
+  }
+  else
+  {
+    emu->row++;
+    if ( emu->row > emu->row_end )
+    {
+      emu->row = emu->row_start;
+      emu->col++;
+      if ( emu->col > emu->col_end )
+	emu->col = emu->col_start;
+    }
+  }
+}
+
+static void u8x8_emu_page_byte(u8x8_emu_t *emu, uint8_t dc, uint8_t b)
+{
+  if ( dc != 0 )
+  {
+    emu->data_cnt++;
+    u8x8_emu_page_data(emu, b);
+    return;
+  }
+  emu->cmd_cnt++;
+  if ( emu->arg_pos < emu->arg_cnt )
+  {
+    emu->arg[emu->arg_pos++] = b;
+    if ( emu->arg_pos == emu->arg_cnt )
+      u8x8_emu_page_cmd(emu);
+    return;
+  }
+  emu->cmd = b;
+  emu->arg_pos = 0;
+  if ( emu->controller == U8X8_EMU_ST7565 )
+    emu->arg_cnt = u8x8_emu_st7565_arg_cnt(b);
+  else
+    emu->arg_cnt = u8x8_emu_ssd13xx_arg_cnt(b);
+  if ( emu->arg_cnt == 0 )
+    u8x8_emu_page_cmd(emu);
+}
+
+/*========================================================*/
+/* ST7920 */
+
+static void u8x8_emu_st7920_value(u8x8_emu_t *emu, uint8_t rs, uint8_t v)
+{
+  if ( rs == 0 )
+  {
+    emu->cmd_cnt++;
+    if ( (v & 0x0e0) == 0x020 )
+    {
+      /* function set */
+      emu->is_extended = (v & 4) ? 1 : 0;
+      emu->is_x_next = 0;
+    }
+    else if ( (v & 0x080) != 0 && emu->is_extended != 0 )
+    {
+      /* first vertical, then horizontal address */
+      if ( emu->is_x_next == 0 )
+      {
+	emu->row = v & 63;
+	emu->is_x_next = 1;
+      }
+      else
+      {
+	emu->col = v & 15;
+	emu->byte_pos = 0;
+	emu->is_x_next = 0;
+      }
+    }
+    return;
+  }
+  emu->data_cnt++;
+  emu->ram[(emu->row % U8X8_EMU_ST7920_ROWS)*U8X8_EMU_ST7920_BYTES_PER_ROW + (emu->col % 16)*2 + emu->byte_pos] = v;
+  emu->byte_pos++;
+  if ( emu->byte_pos >= 2 )
+  {
+    emu->byte_pos = 0;
+    emu->col++;
+  }
+}
+
+static void u8x8_emu_st7920_byte(u8x8_emu_t *emu, uint8_t b)
+{
+  if ( (b & 0x00f) != 0 )
+  {
+    /* sync byte: 11111 RW RS 0 */
+    emu->st7920_rs = (b >> 1) & 1;
+    emu->st7920_is_low_nibble = 0;
+    return;
+  }
+  if ( emu->st7920_is_low_nibble == 0 )
+  {
+    emu->st7920_high_nibble = b & 0x0f0;
+    emu->st7920_is_low_nibble = 1;
+    return;
+  }
+  emu->st7920_is_low_nibble = 0;
+  u8x8_emu_st7920_value(emu, emu->st7920_rs, emu->st7920_high_nibble | (b >> 4));
+}
+
+/*========================================================*/
+/* SSD1322 */
+
+static void u8x8_emu_ssd1322_pixel(u8x8_emu_t *emu, uint16_t x, uint8_t v)
+{
+  if ( x < U8X8_EMU_SSD1322_WIDTH && emu->row < U8X8_EMU_SSD1322_HEIGHT )
+    emu->ram[emu->row*U8X8_EMU_SSD1322_WIDTH + x] = v;
+}
+
+static void u8x8_emu_ssd1322_byte(u8x8_emu_t *emu, uint8_t dc, uint8_t b)
+{
+  uint16_t x;
+  if ( dc == 0 )
+  {
+    emu->cmd_cnt++;
+    emu->cmd = b;
+    emu->arg_pos = 0;
+    emu->is_ram_write = ( b == 0x05c ) ? 1 : 0;
+    emu->byte_pos = 0;
+    return;
+  }
+  if ( emu->is_ram_write == 0 )
+  {
+    /* arg */
+    emu->cmd_cnt++;
+    if ( emu->arg_pos < 8 )
+      emu->arg[emu->arg_pos] = b;
+    emu->arg_pos++;
+    if ( emu->cmd == 0x015 && emu->arg_pos == 2 )
+    {
+      emu->col_start = emu->arg[0];
+      emu->col_end = emu->arg[1];
+      emu->col = emu->col_start;
+    }
+    else if ( emu->cmd == 0x075 && emu->arg_pos == 2 )
+    {
+      emu->row_start = emu->arg[0];
+      emu->row_end = emu->arg[1];
+      emu->row = emu->row_start;
+    }
+    else if ( emu->cmd == 0x0a0 && emu->arg_pos == 1 )
+    {
+      emu->remap = b;
+    }
+    return;
+  }
+
+  /* one column address has 4 pixel (2 bytes) */
+  emu->data_cnt++;
+  x = emu->col*4 + emu->byte_pos*2;
+  if ( emu->remap & 4 )
+  {
+    /* nibble remap: high nibble is the left pixel */
+    u8x8_emu_ssd1322_pixel(emu, x, b >> 4);
+    u8x8_emu_ssd1322_pixel(emu, x+1, b & 15);
+  }
+  else
+  {
+    u8x8_emu_ssd1322_pixel(emu, x, b & 15);
+    u8x8_emu_ssd1322_pixel(emu, x+1, b >> 4);
+  }
+  emu->byte_pos++;
+  if ( emu->byte_pos >= 2 )
+  {
+    emu->byte_pos = 0;
+    emu->col++;
+    if ( emu->col > emu->col_end )
+    {
+      emu->col = emu->col_start;
+      emu->row++;
+      if ( emu->row > emu->row_end )
+	emu->row = emu->row_start;
+    }
+  }
+}
+
+/*========================================================*/
+
+static void u8x8_emu_byte(u8x8_emu_t *emu, uint8_t dc, uint8_t b)
+{
+  switch(emu->controller)
+  {
+    case U8X8_EMU_SSD1306:
+    case U8X8_EMU_SH1106:
+    case U8X8_EMU_ST7565:
+      u8x8_emu_page_byte(emu, dc, b);
+      break;
+    case U8X8_EMU_ST7920:
+      u8x8_emu_st7920_byte(emu, b);
+      break;
+    case U8X8_EMU_SSD1322:
+      u8x8_emu_ssd1322_byte(emu, dc, b);
+      break;
+    default:
+      /* no controller model, count bytes by the D/C line only */
+      if ( dc != 0 )
+	emu->data_cnt++;
+      else
+	emu->cmd_cnt++;
+      break;
+  }
+}
+
+static void u8x8_emu_send(u8x8_emu_t *emu, uint8_t cnt, uint8_t *data)
+{
+  uint8_t b;
+  while( cnt > 0 )
+  {
+    b = *data++;
+    cnt--;
+    emu->byte_cnt++;
+    if ( emu->interface == U8X8_EMU_I2C && emu->controller != U8X8_EMU_ST7920 )
+    {
+      if ( emu->i2c_state == 0 )
+      {
+	/* control byte: Co (bit 7) and D/C (bit 6) */
+	emu->dc = (b & 0x040) ? 1 : 0;
+	emu->i2c_state = (b & 0x080) ? 2 : 1;
+	continue;
+      }
+      if ( emu->i2c_state == 2 )
+	emu->i2c_state = 0;
+    }
+    u8x8_emu_byte(emu, emu->dc, b);
+  }
+}
+
+static void u8x8_emu_reset(u8x8_emu_t *emu)
+{
+  memset(emu->ram, 0, sizeof(emu->ram));
+  emu->dc = 0;
+  emu->i2c_state = 0;
+  emu->st7920_is_low_nibble = 0;
+  emu->arg_cnt = 0;
+  emu->arg_pos = 0;
+  emu->col = 0;
+  emu->col_start = 0;
+  emu->col_end = 127;
+  emu->row = 0;
+  emu->row_start = 0;
+  emu->row_end = 7;
+  emu->addr_mode = 2;
+  emu->start_line = 0;
+  emu->is_extended = 0;
+  emu->is_x_next = 0;
+  emu->is_ram_write = 0;
+  emu->byte_pos = 0;
+  emu->remap = 0;
+  if ( emu->controller == U8X8_EMU_SSD1322 )
+  {
+    emu->col_end = U8X8_EMU_SSD1322_WIDTH/4-1;
+    emu->row_end = U8X8_EMU_SSD1322_HEIGHT-1;
+  }
+}
+
+uint8_t u8x8_byte_emu(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_emu_t *emu = &u8x8_emu;
+  switch(msg)
+  {
+    case U8X8_MSG_BYTE_SEND:
+      u8x8_emu_send(emu, arg_int, (uint8_t *)arg_ptr);
+      break;
+    case U8X8_MSG_BYTE_SET_DC:
+      emu->dc = arg_int;
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      emu->transfer_cnt++;
+      emu->i2c_state = 0;
+      break;
+  }
+  return emu->byte_cb(u8x8, msg, arg_int, arg_ptr);
+}
+
+/*========================================================*/
+/* functions for handling of the global emulator object */
+
+/* call this after u8x8_Setup() or u8g2_Setup_xxx() and before u8x8_InitDisplay() */
+void u8x8_ConnectEmu(u8x8_t *u8x8, uint8_t controller, uint8_t interface)
+{
+  if ( u8x8->byte_cb != u8x8_byte_emu )
+    u8x8_emu.byte_cb = u8x8->byte_cb;
+  u8x8_emu.controller = controller;
+  u8x8_emu.interface = interface;
+  u8x8_emu_reset(&u8x8_emu);
+  u8x8_ResetEmuStatistics();
+  u8x8->byte_cb = u8x8_byte_emu;
+}
+
+void u8x8_ResetEmuStatistics(void)
+{
+  u8x8_emu.byte_cnt = 0;
+  u8x8_emu.transfer_cnt = 0;
+  u8x8_emu.cmd_cnt = 0;
+  u8x8_emu.data_cnt = 0;
+}
+
+uint32_t u8x8_GetEmuByteCnt(void)
+{
+  return u8x8_emu.byte_cnt;
+}
+
+uint32_t u8x8_GetEmuTransferCnt(void)
+{
+  return u8x8_emu.transfer_cnt;
+}
+
+uint32_t u8x8_GetEmuCmdCnt(void)
+{
+  return u8x8_emu.cmd_cnt;
+}
+
+uint32_t u8x8_GetEmuDataCnt(void)
+{
+  return u8x8_emu.data_cnt;
+}
+
+/* return the visible pixel at x/y, considers the x_offset of the display */
+uint8_t u8x8_GetEmuPixel(u8x8_t *u8x8, uint16_t x, uint16_t y)
+{
+  u8x8_emu_t *emu = &u8x8_emu;
+  uint16_t col;
+  switch(emu->controller)
+  {
+    case U8X8_EMU_SSD1306:
+    case U8X8_EMU_SH1106:
+    case U8X8_EMU_ST7565:
+      col = x + u8x8->x_offset;
+      if ( y < 64 )
+	y = (y + emu->start_line) & 63;
+      if ( col >= U8X8_EMU_PAGE_RAM_WIDTH || y/8 >= U8X8_EMU_PAGE_RAM_PAGES )
+	return 0;
+      return (emu->ram[(y/8)*U8X8_EMU_PAGE_RAM_WIDTH + col] >> (y&7)) & 1;
+    case U8X8_EMU_ST7920:
+      /* 128x64 displays: the lower half is placed right of the upper half */
+      if ( u8x8->display_info->pixel_height > 32 && y >= 32 )
+      {
+	y -= 32;
+	x += 128;
+      }
+      if ( x >= U8X8_EMU_ST7920_BYTES_PER_ROW*8 || y >= U8X8_EMU_ST7920_ROWS )
+	return 0;
+      return (emu->ram[y*U8X8_EMU_ST7920_BYTES_PER_ROW + x/8] >> (7-(x&7))) & 1;
+    case U8X8_EMU_SSD1322:
+      /* the NHD 128x64 OLED uses only every second column of the controller */
+      if ( u8x8->display_cb == u8x8_d_ssd1322_nhd_128x64 )
+	x *= 2;
+      x += u8x8->x_offset*4;
+      if ( x >= U8X8_EMU_SSD1322_WIDTH || y >= U8X8_EMU_SSD1322_HEIGHT )
+	return 0;
+      return emu->ram[y*U8X8_EMU_SSD1322_WIDTH + x] != 0 ? 1 : 0;
+  }
+  return 0;
+}
+
+void u8x8_SaveEmuPBM(u8x8_t *u8x8, const char *filename)
+{
+  FILE *fp;
+  uint16_t x, y, w, h;
+
+  w = u8x8->display_info->pixel_width;
+  h = u8x8->display_info->pixel_height;
+  fp = fopen(filename, "w");
+  if ( fp == NULL )
+    return;
+  fprintf(fp, "P1\n%u %u\n", w, h);
+  for( y = 0; y < h; y++ )
+  {
+    for( x = 0; x < w; x++ )
+      fputc(u8x8_GetEmuPixel(u8x8, x, y) ? '1' : '0', fp);
+    fputc('\n', fp);
+  }
+  fclose(fp);
+}
+
+uint8_t u8x8_gpio_and_delay_emu(U8X8_UNUSED u8x8_t *u8x8, U8X8_UNUSED uint8_t msg, U8X8_UNUSED uint8_t arg_int, U8X8_UNUSED void *arg_ptr)
+{
+  return 1;
+}
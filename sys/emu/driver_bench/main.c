@@ -0,0 +1,204 @@
+/*
+
+  driver_bench
+
+  Send a standard scene through the display procedures and count the 
+  bytes and transfers per frame. For emulated controllers, compare the 
+  emulated controller RAM with the u8g2 buffer.
+  A second frame with a small change (update) shows the effect of 
+  drivers, which send changed data only. All drivers get memory for 
+  their state (u8x8_SetDisplayMemory).
+
+  usage: driver_bench [-p]
+    -p	write the emulated display content to <name>.pbm
+
+*/
+
+#include "u8g2.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef void (*setup_cb)(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
+
+#define BUS_SPI 0
+#define BUS_I2C 1
+#define BUS_ST7920 2
+
+#define EMU_NONE 0
+
+struct driver_struct
+{
+  const char *name;
+  setup_cb setup;
+  uint8_t bus;
+  uint8_t emu;		/* U8X8_EMU_xxx or EMU_NONE */
+};
+
+struct driver_struct driver_list[] = 
+{
+  { "ssd1306_128x64_noname", u8g2_Setup_ssd1306_128x64_noname_f, BUS_SPI, U8X8_EMU_SSD1306 },
+  { "ssd1306_i2c_128x64_noname", u8g2_Setup_ssd1306_i2c_128x64_noname_f, BUS_I2C, U8X8_EMU_SSD1306 },
+  { "ssd1306_128x32_univision", u8g2_Setup_ssd1306_128x32_univision_f, BUS_SPI, U8X8_EMU_SSD1306 },
+  { "ssd1306_i2c_128x32_univision", u8g2_Setup_ssd1306_i2c_128x32_univision_f, BUS_I2C, U8X8_EMU_SSD1306 },
+  { "ssd1309_128x64_noname0", u8g2_Setup_ssd1309_128x64_noname0_f, BUS_SPI, U8X8_EMU_SSD1306 },
+  { "ssd1309_i2c_128x64_noname0", u8g2_Setup_ssd1309_i2c_128x64_noname0_f, BUS_I2C, U8X8_EMU_SSD1306 },
+  { "sh1106_128x64_noname", u8g2_Setup_sh1106_128x64_noname_f, BUS_SPI, U8X8_EMU_SH1106 },
+  { "sh1106_i2c_128x64_noname", u8g2_Setup_sh1106_i2c_128x64_noname_f, BUS_I2C, U8X8_EMU_SH1106 },
+  { "st7565_ea_dogm128", u8g2_Setup_st7565_ea_dogm128_f, BUS_SPI, U8X8_EMU_ST7565 },
+  { "st7565_64128n", u8g2_Setup_st7565_64128n_f, BUS_SPI, U8X8_EMU_ST7565 },
+  { "uc1701_ea_dogs102", u8g2_Setup_uc1701_ea_dogs102_f, BUS_SPI, U8X8_EMU_ST7565 },
+  { "uc1701_mini12864", u8g2_Setup_uc1701_mini12864_f, BUS_SPI, U8X8_EMU_ST7565 },
+  { "st7920_s_128x64", u8g2_Setup_st7920_s_128x64_f, BUS_ST7920, U8X8_EMU_ST7920 },
+  { "st7920_s_192x32", u8g2_Setup_st7920_s_192x32_f, BUS_ST7920, U8X8_EMU_ST7920 },
+  { "ssd1322_nhd_256x64", u8g2_Setup_ssd1322_nhd_256x64_f, BUS_SPI, U8X8_EMU_SSD1322 },
+  { "ssd1322_nhd_128x64", u8g2_Setup_ssd1322_nhd_128x64_f, BUS_SPI, U8X8_EMU_SSD1322 },
+  /* no emulator, bytes and transfers only */
+  { "ssd1327_ws_128x128", u8g2_Setup_ssd1327_ws_128x128_f, BUS_SPI, EMU_NONE },
+  { "ssd1327_i2c_ws_128x128", u8g2_Setup_ssd1327_i2c_ws_128x128_f, BUS_I2C, EMU_NONE },
+  { "st75256_jlx256128", u8g2_Setup_st75256_jlx256128_f, BUS_SPI, EMU_NONE },
+  { "st75256_i2c_jlx256128", u8g2_Setup_st75256_i2c_jlx256128_f, BUS_I2C, EMU_NONE },
+  { "sh1107_128x128", u8g2_Setup_sh1107_128x128_f, BUS_SPI, EMU_NONE },
+  { "pcd8544_84x48", u8g2_Setup_pcd8544_84x48_f, BUS_SPI, EMU_NONE },
+  { "ls013b7dh03_128x128", u8g2_Setup_ls013b7dh03_128x128_f, BUS_SPI, EMU_NONE },
+  { "max7219_32x8", u8g2_Setup_max7219_32x8_f, BUS_SPI, EMU_NONE },
+  { "t6963_240x128", u8g2_Setup_t6963_240x128_f, BUS_SPI, EMU_NONE },
+  { "sed1330_240x128", u8g2_Setup_sed1330_240x128_f, BUS_SPI, EMU_NONE },
+};
+
+u8g2_t u8g2;
+uint8_t display_mem[16384];
+
+/* standard scene, does not require any font */
+void draw_scene(u8g2_t *u8g2)
+{
+  u8g2_uint_t w = u8g2_GetDisplayWidth(u8g2);
+  u8g2_uint_t h = u8g2_GetDisplayHeight(u8g2);
+  u8g2_uint_t i;
+  
+  u8g2_ClearBuffer(u8g2);
+  u8g2_DrawFrame(u8g2, 0, 0, w, h);
+  u8g2_DrawBox(u8g2, 3, 3, w/4, h/4);
+  u8g2_DrawDisc(u8g2, w/2, h/2, h/4, U8G2_DRAW_ALL);
+  u8g2_DrawCircle(u8g2, w/2, h/2, h/3, U8G2_DRAW_ALL);
+  u8g2_DrawLine(u8g2, 0, h-1, w-1, 0);
+  for( i = 0; i < w; i += 7 )
+    u8g2_DrawPixel(u8g2, i, h-3);
+}
+
+/* standard scene with a small change, like a counter on a static screen */
+void draw_update_scene(u8g2_t *u8g2)
+{
+  draw_scene(u8g2);
+  u8g2_SetDrawColor(u8g2, 2);
+  u8g2_DrawBox(u8g2, 5, 5, 10, 6);
+  u8g2_SetDrawColor(u8g2, 1);
+}
+
+/* return the number of pixel, which differ between u8g2 buffer and emulator */
+unsigned long compare_emu(u8g2_t *u8g2)
+{
+  u8x8_t *u8x8 = u8g2_GetU8x8(u8g2);
+  uint8_t *buf = u8g2_GetBufferPtr(u8g2);
+  uint8_t tile_width = u8g2_GetBufferTileWidth(u8g2);
+  uint16_t x, y;
+  uint8_t expected;
+  unsigned long err = 0;
+  
+  for( y = 0; y < u8x8->display_info->pixel_height; y++ )
+  {
+    for( x = 0; x < u8x8->display_info->pixel_width; x++ )
+    {
+      if ( u8g2->ll_hvline == u8g2_ll_hvline_horizontal_right_lsb )
+	expected = u8x8_capture_get_pixel_2(x, y, buf, tile_width);
+      else
+	expected = u8x8_capture_get_pixel_1(x, y, buf, tile_width);
+      if ( expected != u8x8_GetEmuPixel(u8x8, x, y) )
+	err++;
+    }
+  }
+  return err;
+}
+
+/* estimated transfer time in micro seconds */
+double get_transfer_time(u8x8_t *u8x8, uint8_t bus)
+{
+  double bits;
+  double hz;
+  if ( bus == BUS_I2C )
+  {
+    /* 9 bits per byte, address byte and start/stop condition for each transfer */
+    bits = (u8x8_GetEmuByteCnt() + u8x8_GetEmuTransferCnt())*9.0 + u8x8_GetEmuTransferCnt()*2.0;
+    hz = u8x8->display_info->i2c_bus_clock_100kHz*100000.0;
+  }
+  else
+  {
+    bits = u8x8_GetEmuByteCnt()*8.0;
+    hz = u8x8->display_info->sck_clock_hz;
+  }
+  if ( hz <= 0.0 )
+    return 0.0;
+  return bits*1000000.0/hz;
+}
+
+int main(int argc, char **argv)
+{
+  size_t i;
+  int is_pbm = 0;
+  int is_error = 0;
+  unsigned long err;
+  u8x8_t *u8x8;
+  char name[128];
+  
+  if ( argc > 1 && strcmp(argv[1], "-p") == 0 )
+    is_pbm = 1;
+  
+  printf("driver,bytes,transfers,cmd_bytes,data_bytes,time_us,pixel_errors,update_bytes,update_errors\n");
+  for( i = 0; i < sizeof(driver_list)/sizeof(*driver_list); i++ )
+  {
+    driver_list[i].setup(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_gpio_and_delay_emu);
+    u8x8 = u8g2_GetU8x8(&u8g2);
+    u8x8_ConnectEmu(u8x8, driver_list[i].emu, driver_list[i].bus == BUS_I2C ? U8X8_EMU_I2C : U8X8_EMU_SPI);
+    u8x8_SetDisplayMemory(u8x8, display_mem, sizeof(display_mem));
+    u8g2_InitDisplay(&u8g2);
+    u8g2_SetPowerSave(&u8g2, 0);
+    
+    u8x8_ResetEmuStatistics();
+    draw_scene(&u8g2);
+    u8g2_SendBuffer(&u8g2);
+    
+    printf("%s,%lu,%lu,%lu,%lu,%.0f,", driver_list[i].name,
+      (unsigned long)u8x8_GetEmuByteCnt(), (unsigned long)u8x8_GetEmuTransferCnt(),
+      (unsigned long)u8x8_GetEmuCmdCnt(), (unsigned long)u8x8_GetEmuDataCnt(),
+      get_transfer_time(u8x8, driver_list[i].bus));
+    
+    if ( driver_list[i].emu == EMU_NONE )
+      printf("-,");
+    else
+    {
+      err = compare_emu(&u8g2);
+      printf("%lu,", err);
+      if ( err != 0 )
+	is_error = 1;
+      if ( is_pbm )
+      {
+	snprintf(name, sizeof(name), "%s.pbm", driver_list[i].name);
+	u8x8_SaveEmuPBM(u8x8, name);
+      }
+    }
+    
+    u8x8_ResetEmuStatistics();
+    draw_update_scene(&u8g2);
+    u8g2_SendBuffer(&u8g2);
+    printf("%lu,", (unsigned long)u8x8_GetEmuByteCnt());
+    if ( driver_list[i].emu == EMU_NONE )
+    {
+      printf("-\n");
+      continue;
+    }
+    err = compare_emu(&u8g2);
+    printf("%lu\n", err);
+    if ( err != 0 )
+      is_error = 1;
+  }
+  return is_error;
+}
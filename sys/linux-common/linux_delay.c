@@ -0,0 +1,138 @@
+/*
+ * Delay procedures for the Linux ports (arm-linux, linux-i2c), see
+ * linux_delay.h.
+ */
+
+#include "linux_delay.h"
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Time in nanoseconds, not affected by NTP adjustments.
+ */
+unsigned long long linux_delay_get_time_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Measure the time for one linux_delay_get_time_ns() call. The busy wait
+ * stops this time earlier than the target.
+ */
+static unsigned long linux_delay_measure_overhead_ns(void) {
+	unsigned long overhead = 1000000;
+	unsigned long long t0, t1;
+	int i;
+
+	for (i = 0; i < 64; i++) {
+		t0 = linux_delay_get_time_ns();
+		t1 = linux_delay_get_time_ns();
+		if (t1 - t0 < overhead) {
+			overhead = t1 - t0;
+		}
+	}
+	return overhead;
+}
+
+/*
+ * Sleep until spin_threshold nanoseconds before target, then busy wait
+ * until target minus overhead.
+ */
+static void linux_delay_wait(unsigned long long target, unsigned long spin_threshold,
+		unsigned long overhead) {
+	unsigned long long now = linux_delay_get_time_ns();
+
+	if (target > now + spin_threshold) {
+		unsigned long long sleep = target - now - spin_threshold;
+		struct timespec ts;
+		ts.tv_sec = sleep / 1000000000ULL;
+		ts.tv_nsec = sleep % 1000000000ULL;
+		while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+			;
+	}
+	while (linux_delay_get_time_ns() + overhead < target)
+		;
+}
+
+/*
+ * Wait until linux_delay_get_time_ns() reaches target. The last
+ * spin_threshold nanoseconds are a busy wait. The duration of the time
+ * measurement is not subtracted, use linux_delay_wait_until_ns() for short
+ * delays.
+ */
+void linux_delay_until_ns(unsigned long long target, unsigned long spin_threshold) {
+	linux_delay_wait(target, spin_threshold, 0);
+}
+
+/*
+ * Same as linux_delay_until_ns(), but with the spin threshold and the
+ * time measurement overhead of d.
+ */
+void linux_delay_wait_until_ns(linux_delay_t *d, unsigned long long target) {
+	linux_delay_wait(target, d->spin_threshold_ns, d->overhead_ns);
+}
+
+/*
+ * The overhead is measured here, so that the delay procedures do not
+ * change any shared state.
+ */
+void linux_delay_init(linux_delay_t *d) {
+	memset(d, 0, sizeof(linux_delay_t));
+	d->spin_threshold_ns = LINUX_DELAY_SPIN_THRESHOLD_NS;
+	d->overhead_ns = linux_delay_measure_overhead_ns();
+}
+
+/*
+ * The delay is not executed immediately. It is added up until the next
+ * linux_delay_flush().
+ */
+void linux_delay_add(linux_delay_t *d, unsigned long long nanoseconds) {
+	d->pending_ns += nanoseconds;
+}
+
+/*
+ * Execute the pending delay and update the histogram.
+ */
+void linux_delay_flush(linux_delay_t *d) {
+	unsigned long long requested = d->pending_ns;
+	unsigned long long start;
+	unsigned long long actual;
+	int i;
+
+	if (requested == 0) {
+		return;
+	}
+	d->pending_ns = 0;
+	start = linux_delay_get_time_ns();
+	linux_delay_wait_until_ns(d, start + requested);
+	actual = linux_delay_get_time_ns() - start;
+	for (i = 0; i < LINUX_DELAY_HIST_CNT - 1 && (requested >> (i + 1)) != 0; i++)
+		;
+	d->hist[i].cnt++;
+	d->hist[i].requested_ns += requested;
+	d->hist[i].actual_ns += actual;
+}
+
+void linux_delay_reset_histogram(linux_delay_t *d) {
+	memset(d->hist, 0, sizeof(d->hist));
+}
+
+/*
+ * Print count, average requested and average actual delay for each
+ * histogram entry.
+ */
+void linux_delay_print_histogram(linux_delay_t *d, FILE *fp) {
+	linux_delay_hist_t *h;
+	int i;
+
+	fprintf(fp, "%12s %10s %14s %14s\n", "range [ns]", "count", "requested [ns]", "actual [ns]");
+	for (i = 0; i < LINUX_DELAY_HIST_CNT; i++) {
+		h = d->hist + i;
+		if (h->cnt != 0) {
+			fprintf(fp, "%12llu %10lu %14llu %14llu\n", 1ULL << i, h->cnt,
+					h->requested_ns / h->cnt, h->actual_ns / h->cnt);
+		}
+	}
+}
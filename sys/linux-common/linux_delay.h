@@ -0,0 +1,67 @@
+/*
+ * Delay procedures for the Linux ports (arm-linux, linux-i2c).
+ *
+ * nanosleep() has a latency of 50-100us, so only the part of a delay above
+ * the spin threshold is slept, the rest is a busy wait on
+ * CLOCK_MONOTONIC_RAW. Consecutive short delays are added up and executed
+ * with linux_delay_flush() before the next GPIO or bus access. Each
+ * executed delay is recorded in a log2 histogram of requested vs. actual
+ * time.
+ */
+
+#ifndef LINUX_DELAY_H
+#define LINUX_DELAY_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Delays below this value are done with a busy wait instead of nanosleep()
+#define LINUX_DELAY_SPIN_THRESHOLD_NS 100000
+// Number of histogram entries, entry n counts delays from 2^n to 2^(n+1)-1 ns
+#define LINUX_DELAY_HIST_CNT 32
+
+/*
+ * Histogram entry for requested vs. actual delay.
+ */
+struct linux_delay_hist_struct {
+	unsigned long cnt;
+	unsigned long long requested_ns;
+	unsigned long long actual_ns;
+};
+
+typedef struct linux_delay_hist_struct linux_delay_hist_t;
+
+/*
+ * Delay state, one object for each display. The object is owned by the
+ * port, it is not stored in the u8x8 user_ptr.
+ */
+struct linux_delay_struct {
+	// Requested delay, which is not yet done. Consecutive delays are combined.
+	unsigned long long pending_ns;
+	// Delays below this value are busy waits, default LINUX_DELAY_SPIN_THRESHOLD_NS
+	unsigned long spin_threshold_ns;
+	// Duration of one linux_delay_get_time_ns() call, measured by linux_delay_init()
+	unsigned long overhead_ns;
+	// Requested vs. actual delay, index is log2 of the requested delay
+	linux_delay_hist_t hist[LINUX_DELAY_HIST_CNT];
+};
+
+typedef struct linux_delay_struct linux_delay_t;
+
+unsigned long long linux_delay_get_time_ns(void);
+void linux_delay_until_ns(unsigned long long target, unsigned long spin_threshold);
+void linux_delay_wait_until_ns(linux_delay_t *d, unsigned long long target);
+void linux_delay_init(linux_delay_t *d);
+void linux_delay_add(linux_delay_t *d, unsigned long long nanoseconds);
+void linux_delay_flush(linux_delay_t *d);
+void linux_delay_reset_histogram(linux_delay_t *d);
+void linux_delay_print_histogram(linux_delay_t *d, FILE *fp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,9 +1,23 @@
 /*
 
   u8x8_framebuffer.c
-  
+
   a framebuffer device
 
+  Each u8x8 object has its own framebuffer object, so several framebuffer 
+  devices can be used at the same time. The object is the display memory
+  (u8x8_SetDisplayMemory()) of the u8x8 object, the user_ptr remains 
+  available for the application.
+
+  Tiles are transposed into pixel rows and expanded with a lookup table,
+  which contains the pixel data of all 256 patterns of 8 pixel. Supported
+  formats: 1, 8, 16, 24 and 32 bits per pixel.
+
+  Double buffering (optional, see u8x8_LinuxFbSetDoubleBuffer()): The
+  virtual screen is doubled (yres_virtual) and all tiles are drawn into
+  the hidden half. U8X8_MSG_DISPLAY_REFRESH (sent by u8g2_SendBuffer())
+  shows the hidden half with FBIOPAN_DISPLAY.
+
 */
 
 #include <unistd.h>
@@ -21,14 +35,20 @@
 
 struct _u8x8_linuxfb_struct
 {
-	u8x8_msg_cb u8x8_bitmap_display_old_cb;
+	u8x8_display_info_t info;
 	int fbfd;
 	struct fb_var_screeninfo vinfo;
 	struct fb_fix_screeninfo finfo;
-	uint8_t *u8x8_buf;
+	uint8_t *u8x8_buf;		/* transposed tile row: 8 pixel rows with tile_width bytes */
 	uint8_t *u8g2_buf;
 	uint8_t *fbp;
+	size_t fbp_len;
 	uint32_t active_color;
+	uint8_t *lut;			/* 256 patterns, 8 pixel each, bytes_per_pixel */
+	uint32_t bytes_per_pixel;	/* 0 for 1 bit per pixel */
+	uint8_t is_double_buffer;
+	uint32_t draw_yoffset;		/* first line of the visible (single) or hidden (double buffer) screen */
+	uint32_t dirty_first, dirty_last;	/* pixel lines changed since the last refresh, nothing changed if first > last */
 };
 
 typedef struct _u8x8_linuxfb_struct u8x8_linuxfb_t;
@@ -36,11 +56,93 @@ typedef struct _u8x8_linuxfb_struct u8x8_linuxfb_t;
 /*========================================================*/
 /* framebuffer functions */
 
+static void u8x8_LinuxFb_free(u8x8_linuxfb_t *fb)
+{
+	if ( fb->fbp != NULL && fb->fbp != MAP_FAILED )
+		munmap(fb->fbp, fb->fbp_len);
+	fb->fbp = NULL;
+	free(fb->u8x8_buf);
+	fb->u8x8_buf = NULL;
+	fb->u8g2_buf = NULL;
+	free(fb->lut);
+	fb->lut = NULL;
+}
+
+static uint8_t u8x8_LinuxFb_map(u8x8_linuxfb_t *fb)
+{
+	if ( fb->fbp != NULL && fb->fbp != MAP_FAILED )
+		munmap(fb->fbp, fb->fbp_len);
+	fb->fbp_len = fb->finfo.smem_len;
+	fb->fbp = mmap(0, fb->fbp_len, PROT_READ | PROT_WRITE, MAP_SHARED, fb->fbfd, 0);
+	if (fb->fbp == MAP_FAILED) {
+		fb->fbp = NULL;
+		printf("Error: failed to map framebuffer device to memory.\n");
+		return 0;
+	}
+	return 1;
+}
+
+/* convert 0xRRGGBB into the pixel value of the current format */
+static uint32_t u8x8_LinuxFb_pixel(u8x8_linuxfb_t *fb, uint32_t rgb)
+{
+	struct fb_var_screeninfo *v = &fb->vinfo;
+	uint32_t r = (rgb >> 16) & 255;
+	uint32_t g = (rgb >> 8) & 255;
+	uint32_t b = rgb & 255;
+
+	if ( v->bits_per_pixel == 1 )
+		return rgb != 0 ? 1 : 0;
+	if ( v->red.length == 0 || v->green.length == 0 || v->blue.length == 0 )
+	{
+		/* palette (e.g. 8 bit pseudo color): use the gray value as index */
+		return ((r+g+b)/3) >> (8 - (v->bits_per_pixel < 8 ? v->bits_per_pixel : 8));
+	}
+	return ((r >> (8-v->red.length)) << v->red.offset) |
+		((g >> (8-v->green.length)) << v->green.offset) |
+		((b >> (8-v->blue.length)) << v->blue.offset);
+}
+
+/* build the lookup table for the active color, background is always 0 */
+static uint8_t u8x8_LinuxFb_build_lut(u8x8_linuxfb_t *fb)
+{
+	uint32_t pixel = u8x8_LinuxFb_pixel(fb, fb->active_color);
+	uint32_t bpp = fb->bytes_per_pixel;
+	uint8_t *p;
+	int pattern, bit, j, k;
+
+	if ( fb->lut == NULL )
+		fb->lut = (uint8_t *)malloc(bpp == 0 ? 256 : 256*8*bpp);
+	if ( fb->lut == NULL )
+		return 0;
+
+	p = fb->lut;
+	for( pattern = 0; pattern < 256; pattern++ )
+	{
+		if ( bpp == 0 )
+		{
+			/* 1 bit per pixel: leftmost pixel is the MSB */
+			k = 0;
+			if ( pixel != 0 )
+				for( bit = 0; bit < 8; bit++ )
+					if ( pattern & (1 << bit) )
+						k |= 128 >> bit;
+			*p++ = k;
+			continue;
+		}
+		for( bit = 0; bit < 8; bit++ )
+		{
+			/* little endian pixel data, leftmost pixel is bit 0 of the pattern */
+			for( j = 0; j < (int)bpp; j++ )
+				*p++ = (pattern & (1 << bit)) ? (pixel >> (8*j)) & 255 : 0;
+		}
+	}
+	return 1;
+}
+
 uint8_t u8x8_LinuxFb_alloc(int fbfd, u8x8_linuxfb_t *fb)
 {
 	size_t tile_width;
 	size_t tile_height;
-	size_t screensize = 0;
 
 	// Make sure that the display is on.
 	if (ioctl(fbfd, FBIOBLANK, FB_BLANK_UNBLANK) != 0) {
@@ -60,97 +162,159 @@ uint8_t u8x8_LinuxFb_alloc(int fbfd, u8x8_linuxfb_t *fb)
 		return 0;
 	}
 
-	if ( fb->u8x8_buf != NULL )
-		free(fb->u8x8_buf);
+	switch(fb->vinfo.bits_per_pixel)
+	{
+		case 1: case 8: case 16: case 24: case 32:
+			break;
+		default:
+			fprintf(stderr,"Unsupported framebuffer format: %u bits per pixel.\n", fb->vinfo.bits_per_pixel);
+			return 0;
+	}
+
+	u8x8_LinuxFb_free(fb);
 
 	fb->fbfd = fbfd;
 	fb->active_color = 0xFFFFFF;
+	fb->bytes_per_pixel = fb->vinfo.bits_per_pixel / 8;
+	fb->is_double_buffer = 0;
+	fb->draw_yoffset = fb->vinfo.yoffset;
+	fb->dirty_first = 1;
+	fb->dirty_last = 0;
 	tile_width = (fb->vinfo.xres+7)/8;
 	tile_height = (fb->vinfo.yres+7)/8;
+	if ( tile_width > 255 || tile_height > 255 ) {
+		fprintf(stderr,"Framebuffer too large: %ux%u.\n", fb->vinfo.xres, fb->vinfo.yres);
+		return 0;
+	}
 
-	/* allocate the tile buffer twice, one for u8x8 and another bitmap for u8g2 */
-	fb->u8x8_buf = (uint8_t *)malloc(tile_width*tile_height*8*2);
-	fb->u8g2_buf = (uint8_t *)fb->u8x8_buf + tile_width*tile_height*8;
+	/* allocate one transposed tile row for u8x8 and the tile buffer for u8g2 */
+	fb->u8x8_buf = (uint8_t *)malloc(tile_width*8 + tile_width*tile_height*8);
+	if ( fb->u8x8_buf == NULL )
+		return 0;
+	fb->u8g2_buf = fb->u8x8_buf + tile_width*8;
 
-	if ( fb->u8x8_buf == NULL ) {
-		fb->u8g2_buf = NULL;
+	if ( u8x8_LinuxFb_build_lut(fb) == 0 )
 		return 0;
-	}
 
 	// Map the device to memory
-	fb->fbp = mmap(0, fb->finfo.smem_len, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
-	if (fb->fbp == MAP_FAILED) {
-		printf("Error: failed to map framebuffer device to memory.\n");
+	if ( u8x8_LinuxFb_map(fb) == 0 )
 		return 0;
-	}
-	memset(fb->fbp,0x00,screensize);
+	memset(fb->fbp + (size_t)fb->draw_yoffset*fb->finfo.line_length, 0x00, (size_t)fb->vinfo.yres*fb->finfo.line_length);
 	return 1;
 }
 
+/* transpose an 8x8 bit matrix: bit r of byte c becomes bit c of byte r */
+static uint64_t u8x8_LinuxFb_transpose(const uint8_t *tile)
+{
+	uint64_t x, t;
+	int i;
+	x = 0;
+	for( i = 7; i >= 0; i-- )
+		x = (x << 8) | tile[i];
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+	return x;
+}
+
 void u8x8_LinuxFb_DrawTiles(u8x8_linuxfb_t *fb, uint16_t tx, uint16_t ty, uint8_t tile_cnt, uint8_t *tile_ptr)
 {
-	uint8_t byte;
-	memset(fb->u8x8_buf,0x00,8*tile_cnt);
-
-	for(int i=0; i < tile_cnt * 8; i++){
-		byte = *tile_ptr++;
-		for(int bit=0; bit < 8;bit++){
-			if(byte & (1 << bit))
-				fb->u8x8_buf[tile_cnt*bit+(i/8)] |= (1 << i%8);
-		}
+	uint32_t xres = fb->vinfo.xres;
+	uint32_t yres = fb->vinfo.yres;
+	uint32_t bpp = fb->bytes_per_pixel;
+	uint32_t line_length = fb->finfo.line_length;
+	uint32_t x0, y0, rows, last_width, i, r;
+	uint64_t t;
+	uint8_t *src;
+	uint8_t *dest;
+
+	x0 = tx*8;
+	y0 = ty*8;
+	if ( x0 >= xres || y0 >= yres || tile_cnt == 0 )
+		return;
+	if ( x0 + tile_cnt*8 > xres )
+		tile_cnt = (xres - x0 + 7)/8;
+	rows = yres - y0 < 8 ? yres - y0 : 8;
+	last_width = xres - x0 - (tile_cnt-1)*8;	/* pixel of the last tile inside the screen */
+	if ( last_width > 8 )
+		last_width = 8;
+
+	/* transpose all tiles of the row: one byte for 8 pixel, leftmost pixel is bit 0 */
+	for( i = 0; i < tile_cnt; i++ )
+	{
+		t = u8x8_LinuxFb_transpose(tile_ptr + i*8);
+		for( r = 0; r < 8; r++ )
+			fb->u8x8_buf[r*tile_cnt + i] = (t >> (8*r)) & 255;
 	}
 
-	switch (fb->vinfo.bits_per_pixel) {
-		case 1:
-			memcpy(fb->fbp+ty*8*tile_cnt, fb->u8x8_buf, tile_cnt*8);
-			break;
-		case 16:{
-			uint16_t pixel;
-			uint16_t *fbp16 = (uint16_t *)fb->fbp;
-			long int location = 0;
-
-			uint8_t b = (fb->active_color & 0x0000FF) >> 0;
-			uint8_t g = (fb->active_color & 0x00FF00) >> 8;
-			uint8_t r = (fb->active_color & 0xFF0000) >> 16;
-
-			for(int y=0; y<8;y++){
-				for(int x=0; x<8*tile_cnt;x++){
-					if(fb->u8x8_buf[(x/8) + (y*tile_cnt) ] & (1 << x%8))
-						pixel =  r<<11 | g << 5 | b;
-					else
-						pixel = 0x000000;
-					location = (x + fb->vinfo.xoffset) + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 2;
-					memcpy(&fbp16[location], &pixel, sizeof(pixel));
-				}
-			}
-		}break;
-		case 32:{
-			uint32_t pixel;
-			uint32_t *fbp32 = (uint32_t *)fb->fbp;
-			long int location = 0;
-
-			for(int y=0; y<8;y++){
-				for(int x=0; x<8*tile_cnt;x++){
-					if(fb->u8x8_buf[(x/8) + (y*tile_cnt) ] & (1 << x%8))
-						pixel = fb->active_color;
-					else
-						pixel = 0x000000;
-					location = (x + fb->vinfo.xoffset) + ((ty*8)+y + fb->vinfo.yoffset) * fb->finfo.line_length / 4;
-					memcpy(&fbp32[location], &pixel, sizeof(pixel));
-				}
+	/* expand the pixel rows, each row is written from left to right */
+	for( r = 0; r < rows; r++ )
+	{
+		src = fb->u8x8_buf + r*tile_cnt;
+		dest = fb->fbp + (size_t)(y0 + r + fb->draw_yoffset)*line_length;
+		if ( bpp == 0 )
+		{
+			dest += (x0 + fb->vinfo.xoffset)/8;
+			for( i = 0; i < tile_cnt; i++ )
+				*dest++ = fb->lut[*src++];
+		}
+		else
+		{
+			dest += (size_t)(x0 + fb->vinfo.xoffset)*bpp;
+			for( i = 1; i < tile_cnt; i++ )
+			{
+				memcpy(dest, fb->lut + *src++ * 8 * bpp, 8*bpp);
+				dest += 8*bpp;
 			}
-		}break;
-		//TODO support 24/16/8 bits_per_pixel
-		default:
-			break;
+			memcpy(dest, fb->lut + *src * 8 * bpp, last_width*bpp);
+		}
+	}
+
+	if ( fb->dirty_first > fb->dirty_last )
+	{
+		fb->dirty_first = y0;
+		fb->dirty_last = y0 + rows - 1;
+	}
+	else
+	{
+		if ( fb->dirty_first > y0 )
+			fb->dirty_first = y0;
+		if ( fb->dirty_last < y0 + rows - 1 )
+			fb->dirty_last = y0 + rows - 1;
 	}
 }
 
+/* double buffer: show the hidden screen, then copy the changed lines into the new hidden screen */
+static void u8x8_LinuxFb_Refresh(u8x8_linuxfb_t *fb)
+{
+	uint32_t line_length = fb->finfo.line_length;
+	uint32_t hidden;
+
+	if ( fb->is_double_buffer == 0 || fb->dirty_first > fb->dirty_last )
+		return;
+
+	hidden = fb->vinfo.yoffset;
+	fb->vinfo.yoffset = fb->draw_yoffset;
+	if (ioctl(fb->fbfd, FBIOPAN_DISPLAY, &fb->vinfo)) {
+		perror("ioctl(FBIOPAN_DISPLAY)");
+		fb->vinfo.yoffset = hidden;
+		return;
+	}
+	memcpy(fb->fbp + (size_t)(hidden + fb->dirty_first)*line_length,
+		fb->fbp + (size_t)(fb->draw_yoffset + fb->dirty_first)*line_length,
+		(size_t)(fb->dirty_last - fb->dirty_first + 1)*line_length);
+	fb->draw_yoffset = hidden;
+	fb->dirty_first = 1;
+	fb->dirty_last = 0;
+}
+
 /*========================================================*/
-/* global objects for the framebuffer */
+/* default values of the u8x8 info object */
 
-static u8x8_linuxfb_t u8x8_linuxfb;
-static u8x8_display_info_t u8x8_libuxfb_info =
+static const u8x8_display_info_t u8x8_libuxfb_info =
 {
 	/* chip_enable_level = */ 0,
 	/* chip_disable_level = */ 1,
@@ -176,42 +340,53 @@ static u8x8_display_info_t u8x8_libuxfb_info =
 
 
 /*========================================================*/
-/* functions for handling of the global objects */
+/* functions for handling of the framebuffer objects */
+
+static uint8_t u8x8_framebuffer_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 
-/* allocate bitmap */
-/* will be called by u8x8_SetupBitmap or u8g2_SetupBitmap */
-static uint8_t u8x8_SetLinuxFbDevice(U8X8_UNUSED u8x8_t *u8x8, int fbfd)
+/* returns the framebuffer object, NULL if u8x8 is not a framebuffer device */
+static u8x8_linuxfb_t *u8x8_LinuxFb_GetDevice(u8x8_t *u8x8)
 {
-	struct fb_var_screeninfo *vinfo = &u8x8_linuxfb.vinfo;
+	if ( u8x8->display_cb != u8x8_framebuffer_cb || u8x8->display_mem_size != sizeof(u8x8_linuxfb_t) )
+		return NULL;
+	return (u8x8_linuxfb_t *)u8x8->display_mem;
+}
 
-	/* update the global framebuffer object, allocate memory */
-	if ( u8x8_LinuxFb_alloc(fbfd, &u8x8_linuxfb) == 0 )
+/* allocate the framebuffer object and the bitmap, the object is the display memory of u8x8 */
+static uint8_t u8x8_SetLinuxFbDevice(u8x8_t *u8x8, int fbfd)
+{
+	u8x8_linuxfb_t *fb = (u8x8_linuxfb_t *)calloc(1, sizeof(u8x8_linuxfb_t));
+	if ( fb == NULL )
+		return 0;
+	u8x8_SetDisplayMemory(u8x8, fb, sizeof(u8x8_linuxfb_t));
+	fb->fbfd = fbfd;	/* closed by u8x8_LinuxFbClose(), also if the setup fails */
+	fb->info = u8x8_libuxfb_info;
+
+	/* update the framebuffer object, allocate memory */
+	if ( u8x8_LinuxFb_alloc(fbfd, fb) == 0 )
 		return 0;
 
 	/* update the u8x8 info object */
-	u8x8_libuxfb_info.tile_width = (u8x8_linuxfb.vinfo.xres+7)/8;
-	u8x8_libuxfb_info.tile_height = (vinfo->yres+7)/8;
-	u8x8_libuxfb_info.pixel_width = vinfo->xres;
-	u8x8_libuxfb_info.pixel_height = vinfo->yres;
+	fb->info.tile_width = (fb->vinfo.xres+7)/8;
+	fb->info.tile_height = (fb->vinfo.yres+7)/8;
+	fb->info.pixel_width = fb->vinfo.xres;
+	fb->info.pixel_height = fb->vinfo.yres;
 	return 1;
 }
 
-/* draw tiles to the bitmap, called by the device procedure */
-static void u8x8_DrawLinuxFbTiles(U8X8_UNUSED u8x8_t *u8x8, uint16_t tx, uint16_t ty, uint8_t tile_cnt, uint8_t *tile_ptr)
-{
-	u8x8_LinuxFb_DrawTiles(&u8x8_linuxfb, tx, ty, tile_cnt, tile_ptr);
-}
-
 /*========================================================*/
 
 static uint8_t u8x8_framebuffer_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
+	u8x8_linuxfb_t *fb = u8x8_LinuxFb_GetDevice(u8x8);
 	u8g2_uint_t x, y, c;
 	uint8_t *ptr;
+	if ( fb == NULL )
+		return 0;
 	switch(msg)
 	{
 	case U8X8_MSG_DISPLAY_SETUP_MEMORY:
-		u8x8_d_helper_display_setup_memory(u8x8, &u8x8_libuxfb_info);
+		u8x8_d_helper_display_setup_memory(u8x8, &fb->info);
 		break;
 	case U8X8_MSG_DISPLAY_INIT:
 		u8x8_d_helper_display_init(u8x8);	/* update low level interfaces (not required here) */
@@ -220,14 +395,19 @@ static uint8_t u8x8_framebuffer_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, v
 		break;
 	case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
 		break;
+	case U8X8_MSG_DISPLAY_REFRESH:
+		u8x8_LinuxFb_Refresh(fb);
+		break;
 	case U8X8_MSG_DISPLAY_DRAW_TILE:
+		if ( fb->fbp == NULL )
+			break;
 		x = ((u8x8_tile_t *)arg_ptr)->x_pos;
 		y = ((u8x8_tile_t *)arg_ptr)->y_pos;
 		c = ((u8x8_tile_t *)arg_ptr)->cnt;
 		ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
 		do
 		{
-			u8x8_DrawLinuxFbTiles(u8x8, x, y, c, ptr);
+			u8x8_LinuxFb_DrawTiles(fb, x, y, c, ptr);
 			x += c;
 			arg_int--;
 		} while( arg_int > 0 );
@@ -242,9 +422,9 @@ static uint8_t u8x8_framebuffer_cb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, v
 /*========================================================*/
 /* u8x8 and u8g2 setup functions */
 
-void u8x8_SetupLinuxFb(u8x8_t *u8x8, int fbfd)
+uint8_t u8x8_SetupLinuxFb(u8x8_t *u8x8, int fbfd)
 {
-	u8x8_SetLinuxFbDevice(u8x8,fbfd);
+	uint8_t is_ok;
 
 	/* setup defaults */
 	u8x8_SetupDefaults(u8x8);
@@ -252,12 +432,18 @@ void u8x8_SetupLinuxFb(u8x8_t *u8x8, int fbfd)
 	/* setup specific callbacks */
 	u8x8->display_cb = u8x8_framebuffer_cb;
 
+	is_ok = u8x8_SetLinuxFbDevice(u8x8,fbfd);
+
 	/* setup display info */
+	if ( u8x8_LinuxFb_GetDevice(u8x8) == NULL )
+		return 0;
 	u8x8_SetupMemory(u8x8);
+	return is_ok;
 }
 
 void u8g2_SetupLinuxFb(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *fb_device)
 {
+	u8x8_linuxfb_t *fb;
 	int fbfd = open(fb_device,O_RDWR);
 	if (fbfd == -1) {
 		perror(fb_device);
@@ -265,13 +451,90 @@ void u8g2_SetupLinuxFb(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *fb_de
 	}
 
 	/* allocate bitmap, assign the device callback to u8x8 */
-	u8x8_SetupLinuxFb(u8g2_GetU8x8(u8g2), fbfd);
+	if ( u8x8_SetupLinuxFb(u8g2_GetU8x8(u8g2), fbfd) == 0 )
+		return;
+	fb = u8x8_LinuxFb_GetDevice(u8g2_GetU8x8(u8g2));
+	if ( fb == NULL )
+		return;
 
 	/* configure u8g2 in full buffer mode */
-	u8g2_SetupBuffer(u8g2, u8x8_linuxfb.u8g2_buf, (u8x8_libuxfb_info.pixel_height+7)/8, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
+	u8g2_SetupBuffer(u8g2, fb->u8g2_buf, fb->info.tile_height, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
+}
+
+/* set the color of the pixel, the background is always black */
+void u8x8_LinuxFbSetActiveColor(u8x8_t *u8x8, uint32_t color)
+{
+	u8x8_linuxfb_t *fb = u8x8_LinuxFb_GetDevice(u8x8);
+	if ( fb == NULL )
+		return;
+	fb->active_color = color;
+	u8x8_LinuxFb_build_lut(fb);
 }
 
-void u8x8_LinuxFbSetActiveColor(uint32_t color)
+/*
+  Enable (is_enable = 1) or disable page flipping. The virtual screen must
+  have space for two screens, yres_virtual is increased if possible.
+  Returns 1 if page flipping is active.
+  The new content becomes visible with u8x8_RefreshDisplay() (called by
+  u8g2_SendBuffer() and u8g2_NextPage()).
+*/
+uint8_t u8x8_LinuxFbSetDoubleBuffer(u8x8_t *u8x8, uint8_t is_enable)
 {
-	u8x8_linuxfb.active_color = color;
+	u8x8_linuxfb_t *fb = u8x8_LinuxFb_GetDevice(u8x8);
+	struct fb_var_screeninfo v;
+	uint32_t yres;
+	uint32_t line_length;
+
+	if ( fb == NULL || fb->fbp == NULL )
+		return 0;
+	yres = fb->vinfo.yres;
+
+	if ( is_enable == 0 )
+	{
+		fb->is_double_buffer = 0;
+		fb->draw_yoffset = fb->vinfo.yoffset;	/* continue with the visible screen */
+		return 0;
+	}
+	if ( fb->is_double_buffer )
+		return 1;
+
+	if ( fb->vinfo.yres_virtual < 2*yres )
+	{
+		v = fb->vinfo;
+		v.yres_virtual = 2*yres;
+		v.yoffset = 0;
+		if (ioctl(fb->fbfd, FBIOPUT_VSCREENINFO, &v))
+			return 0;
+		if (ioctl(fb->fbfd, FBIOGET_VSCREENINFO, &fb->vinfo) || ioctl(fb->fbfd, FBIOGET_FSCREENINFO, &fb->finfo))
+			return 0;
+		if ( u8x8_LinuxFb_map(fb) == 0 )
+			return 0;
+		fb->draw_yoffset = fb->vinfo.yoffset;
+		if ( fb->vinfo.yres_virtual < 2*yres )
+			return 0;
+	}
+	line_length = fb->finfo.line_length;
+	if ( fb->finfo.smem_len < (size_t)2*yres*line_length )
+		return 0;
+
+	/* the hidden screen starts with the content of the visible screen */
+	fb->draw_yoffset = fb->vinfo.yoffset >= yres ? 0 : yres;
+	memcpy(fb->fbp + (size_t)fb->draw_yoffset*line_length, fb->fbp + (size_t)fb->vinfo.yoffset*line_length, (size_t)yres*line_length);
+	fb->dirty_first = 1;
+	fb->dirty_last = 0;
+	fb->is_double_buffer = 1;
+	return 1;
+}
+
+/* release the framebuffer object and close the device */
+void u8x8_LinuxFbClose(u8x8_t *u8x8)
+{
+	u8x8_linuxfb_t *fb = u8x8_LinuxFb_GetDevice(u8x8);
+	if ( fb == NULL )
+		return;
+	u8x8_LinuxFb_free(fb);
+	if ( fb->fbfd >= 0 )
+		close(fb->fbfd);
+	free(fb);
+	u8x8_SetDisplayMemory(u8x8, NULL, 0);
 }
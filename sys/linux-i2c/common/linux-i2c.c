@@ -12,6 +12,8 @@
 #include <time.h>
 #include <u8x8.h>
 #include <unistd.h>
+#include "linux-i2c.h"
+#include "linux_delay.h"
 
 
 #define BUFSIZ_I2C 32
@@ -24,6 +26,72 @@ int file = 1;
 uint8_t addr = 0x3c;
 int adapter_nr = 0; /* probably dynamically determined */
 
+/* 
+  delay state of each display, assigned with U8X8_MSG_GPIO_AND_DELAY_INIT, 
+  the u8x8 user_ptr is not used 
+*/
+struct linux_i2c_delay_entry {
+	u8x8_t *u8x8;
+	linux_delay_t delay;
+};
+
+static struct linux_i2c_delay_entry linux_i2c_delay_list[LINUX_I2C_MAX_DISPLAYS];
+
+/* returns NULL if the display is unknown */
+static linux_delay_t *
+linux_i2c_get_delay(u8x8_t *u8x8)
+{
+	int i;
+	for(i = 0; i < LINUX_I2C_MAX_DISPLAYS; i++){
+		if (linux_i2c_delay_list[i].u8x8 == u8x8)
+			return &linux_i2c_delay_list[i].delay;
+	}
+	return NULL;
+}
+
+static linux_delay_t *
+linux_i2c_add_delay(u8x8_t *u8x8)
+{
+	linux_delay_t *d = linux_i2c_get_delay(u8x8);
+	int i;
+	if (d != NULL)
+		return d;
+	for(i = 0; i < LINUX_I2C_MAX_DISPLAYS; i++){
+		if (linux_i2c_delay_list[i].u8x8 == NULL) {
+			linux_i2c_delay_list[i].u8x8 = u8x8;
+			linux_delay_init(&linux_i2c_delay_list[i].delay);
+			return &linux_i2c_delay_list[i].delay;
+		}
+	}
+	fprintf(stderr, "linux-i2c: more than %d displays, delays without histogram\n", LINUX_I2C_MAX_DISPLAYS);
+	return NULL;
+}
+
+void
+linux_i2c_delay_flush(u8x8_t *u8x8)
+{
+	linux_delay_t *d = linux_i2c_get_delay(u8x8);
+	if (d != NULL)
+		linux_delay_flush(d);
+}
+
+void
+linux_i2c_delay_reset_histogram(u8x8_t *u8x8)
+{
+	linux_delay_t *d = linux_i2c_get_delay(u8x8);
+	if (d != NULL)
+		linux_delay_reset_histogram(d);
+}
+
+/* count, average requested and average actual delay per histogram entry */
+void
+linux_i2c_delay_print(u8x8_t *u8x8, FILE *fp)
+{
+	linux_delay_t *d = linux_i2c_get_delay(u8x8);
+	if (d != NULL)
+		linux_delay_print_histogram(d, fp);
+}
+
 
 uint8_t
 u8x8_byte_linux_i2c(u8x8_t *u8x8,
@@ -31,7 +99,8 @@ u8x8_byte_linux_i2c(u8x8_t *u8x8,
 		    uint8_t arg_int,
 		    void *arg_ptr)
 {
-	
+	/* pending delays (e.g. after reset) must be done before the transfer */
+	linux_i2c_delay_flush(u8x8);
 	
 	switch(msg){
 	case U8X8_MSG_BYTE_SEND:
@@ -82,45 +151,57 @@ u8x8_byte_linux_i2c(u8x8_t *u8x8,
 }
 
 
+/*
+  Short delays are not executed immediately: Consecutive delays are added
+  and executed with the next bus message (including END_TRANSFER) or any
+  other message. Millisecond delays (e.g. the reset wait at the end of a
+  sequence) are executed immediately.
+*/
 uint8_t
 u8x8_linux_i2c_delay(u8x8_t *u8x8,
 		     uint8_t msg,
 		     uint8_t arg_int,
 		     void *arg_ptr)
 {
-	struct timespec req;
-	struct timespec rem;
-	int ret;
+	linux_delay_t *d;
+	unsigned long long ns;
+
+	if (msg == U8X8_MSG_GPIO_AND_DELAY_INIT) {
+		linux_i2c_add_delay(u8x8);
+		return 1;
+	}
+	d = linux_i2c_get_delay(u8x8);
+	if (d == NULL) {
+		/* unknown display: execute the delay immediately */
+		switch(msg) {
+		case U8X8_MSG_DELAY_NANO:	ns = arg_int; break;
+		case U8X8_MSG_DELAY_100NANO:	ns = arg_int * 100ULL; break;
+		case U8X8_MSG_DELAY_10MICRO:	ns = arg_int * 10000ULL; break;
+		case U8X8_MSG_DELAY_MILLI:	ns = arg_int * 1000000ULL; break;
+		default:			return 0;
+		}
+		linux_delay_until_ns(linux_delay_get_time_ns() + ns, LINUX_DELAY_SPIN_THRESHOLD_NS);
+		return 1;
+	}
 
-	req.tv_sec = 0;
-	
 	switch(msg) {
 	case U8X8_MSG_DELAY_NANO:  // delay arg_int * 1 nano second
-		req.tv_nsec = arg_int;
+		linux_delay_add(d, arg_int);
 		break;
 	case U8X8_MSG_DELAY_100NANO:       // delay arg_int * 100 nano seconds
-		req.tv_nsec = arg_int * 100;
+		linux_delay_add(d, arg_int * 100ULL);
 		break;
 	case U8X8_MSG_DELAY_10MICRO: // delay arg_int * 10 micro seconds
-		req.tv_nsec = arg_int * 10000;
+		linux_delay_add(d, arg_int * 10000ULL);
 		break;
 	case U8X8_MSG_DELAY_MILLI:  // delay arg_int * 1 milli second
-		req.tv_nsec = arg_int * 1000000;
+		linux_delay_add(d, arg_int * 1000000ULL);
+		linux_delay_flush(d);
 		break;
 	default:
+		linux_delay_flush(d);
 		return 0;
 	}
-
-	while((ret = nanosleep(&req, &rem)) && errno == EINTR){
-		struct timespec tmp = req;
-		req = rem;
-		rem = tmp;
-	}
-	if (ret) {
-		perror("nanosleep");
-		fprintf(stderr, "can't sleep\n");
-		return(errno);
-	}
 	
 	return 1;
 }
@@ -17,6 +17,16 @@
 #include <unistd.h>
 
 
+/* max number of displays with their own delay state and histogram */
+#ifndef LINUX_I2C_MAX_DISPLAYS
+#define LINUX_I2C_MAX_DISPLAYS 4
+#endif
+
+/* delay histogram of a display, see sys/linux-common/linux_delay.c */
+void linux_i2c_delay_flush(u8x8_t *u8x8);
+void linux_i2c_delay_reset_histogram(u8x8_t *u8x8);
+void linux_i2c_delay_print(u8x8_t *u8x8, FILE *fp);
+
 uint8_t u8x8_byte_linux_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 
 uint8_t u8x8_linux_i2c_delay (u8x8_t * u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) ;
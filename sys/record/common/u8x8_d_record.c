@@ -0,0 +1,409 @@
+/*
+
+  u8x8_d_record.c
+
+  a recorder device: each frame is appended to a file, keyframes and
+  XOR delta frames are run length compressed, see u8x8_record.h for the
+  file format and tools/u8rec2pbm for the conversion into PBM files
+
+  A frame is recorded with U8X8_MSG_DISPLAY_REFRESH (u8x8_RefreshDisplay(),
+  sent by u8g2_SendBuffer() and u8g2_NextPage()).
+  The device object is the display memory (u8x8_SetDisplayMemory()) of the
+  u8x8 object, so the user_ptr remains available for the application.
+
+*/
+
+#include <stdlib.h>	/* malloc */
+#include <stdint.h>	/* uint16_t */
+#include <string.h>	/* memcpy */
+#include <stdio.h>	/* FILE */
+#include <time.h>	/* clock_gettime */
+#include "u8g2.h"		/* because of u8g2_Setup... */
+#include "u8x8_record.h"
+
+/*========================================================*/
+/* recorder struct */
+
+struct _u8x8_record_struct
+{
+  u8x8_display_info_t info;
+  FILE *fp;
+  size_t size;			/* bytes of one image */
+  uint8_t *u8x8_buf;		/* current content of the display */
+  uint8_t *u8g2_buf;
+  uint8_t *prev_buf;		/* last recorded image */
+  uint8_t *delta_buf;
+  uint8_t *rle_buf;
+  uint64_t *index;		/* file offset of each frame */
+  uint32_t index_size;
+  uint32_t frame_cnt;
+  uint32_t lost_cnt;		/* frames, which could not be recorded */
+  uint64_t offset;		/* current file offset */
+  uint16_t keyframe_interval;
+  struct timespec start;
+};
+
+typedef struct _u8x8_record_struct u8x8_record_t;
+
+/*========================================================*/
+/* recorder functions */
+
+static void record_write_byte(u8x8_record_t *r, uint8_t byte)
+{
+  fputc(byte, r->fp);
+  r->offset++;
+}
+
+static void record_write_word(u8x8_record_t *r, uint16_t word)
+{
+  record_write_byte(r, word&255);
+  record_write_byte(r, word>>8);
+}
+
+static void record_write_long(u8x8_record_t *r, uint32_t v)
+{
+  record_write_word(r, v&0x0ffff);
+  record_write_word(r, v>>16);
+}
+
+static void record_write_data(u8x8_record_t *r, const void *data, size_t len)
+{
+  fwrite(data, len, 1, r->fp);
+  r->offset += len;
+}
+
+/*
+  run length compression, returns the number of bytes written to dest,
+  dest must have space for len + (len+127)/128 bytes
+*/
+static size_t record_rle(const uint8_t *src, size_t len, uint8_t *dest)
+{
+  size_t i = 0, out = 0, run, cnt;
+  while( i < len )
+  {
+    run = 1;
+    while( i + run < len && run < 129 && src[i+run] == src[i] )
+      run++;
+    if ( run >= 2 )
+    {
+      dest[out++] = run + 126;
+      dest[out++] = src[i];
+      i += run;
+    }
+    else
+    {
+      /* literal bytes until the next run of two equal bytes */
+      cnt = 0;
+      while( i + cnt < len && cnt < 128 )
+      {
+	if ( cnt > 0 && i + cnt + 1 < len && src[i+cnt] == src[i+cnt+1] )
+	  break;
+	cnt++;
+      }
+      dest[out++] = cnt - 1;
+      memcpy(dest+out, src+i, cnt);
+      out += cnt;
+      i += cnt;
+    }
+  }
+  return out;
+}
+
+static uint32_t record_time_ms(u8x8_record_t *r)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((ts.tv_sec - r->start.tv_sec)*1000 + (ts.tv_nsec - r->start.tv_nsec)/1000000);
+}
+
+static void u8x8_record_Frame(u8x8_record_t *r)
+{
+  uint8_t type = U8X8_RECORD_KEYFRAME;
+  const uint8_t *data = r->u8x8_buf;
+  size_t i, len;
+  uint8_t is_changed = 0;
+  uint64_t *index;
+
+  if ( r->fp == NULL )
+    return;
+
+  /* append the offset to the frame index */
+  if ( r->frame_cnt >= r->index_size )
+  {
+    index = (uint64_t *)realloc(r->index, (r->index_size*2+256)*sizeof(uint64_t));
+    if ( index == NULL )
+    {
+      /* the frame is not recorded, the next delta frame is based on the last recorded frame */
+      if ( r->lost_cnt == 0 )
+	perror("u8x8_record: frame index");
+      r->lost_cnt++;
+      return;
+    }
+    r->index = index;
+    r->index_size = r->index_size*2+256;
+  }
+  r->index[r->frame_cnt] = r->offset;
+
+  if ( r->frame_cnt % r->keyframe_interval != 0 )
+  {
+    type = U8X8_RECORD_DELTA;
+    for( i = 0; i < r->size; i++ )
+    {
+      r->delta_buf[i] = r->u8x8_buf[i] ^ r->prev_buf[i];
+      is_changed |= r->delta_buf[i];
+    }
+    data = r->delta_buf;
+  }
+
+  len = 0;
+  if ( type == U8X8_RECORD_KEYFRAME || is_changed != 0 )
+    len = record_rle(data, r->size, r->rle_buf);
+
+  record_write_byte(r, type);
+  record_write_long(r, record_time_ms(r));
+  record_write_long(r, len);
+  record_write_data(r, r->rle_buf, len);
+
+  memcpy(r->prev_buf, r->u8x8_buf, r->size);
+  r->frame_cnt++;
+  if ( type == U8X8_RECORD_KEYFRAME )
+    fflush(r->fp);
+}
+
+static void u8x8_record_DrawTiles(u8x8_record_t *r, uint16_t tx, uint16_t ty, uint8_t tile_cnt, uint8_t *tile_ptr)
+{
+  if ( r->u8x8_buf == NULL || tx >= r->info.tile_width || ty >= r->info.tile_height )
+    return;
+  if ( tx + tile_cnt > r->info.tile_width )
+    tile_cnt = r->info.tile_width - tx;
+  memcpy(r->u8x8_buf + ((size_t)ty*r->info.tile_width + tx)*8, tile_ptr, tile_cnt*8);
+}
+
+static void u8x8_record_free(u8x8_record_t *r)
+{
+  free(r->u8x8_buf);
+  r->u8x8_buf = NULL;
+  r->u8g2_buf = NULL;
+  r->prev_buf = NULL;
+  r->delta_buf = NULL;
+  r->rle_buf = NULL;
+  free(r->index);
+  r->index = NULL;
+  r->index_size = 0;
+}
+
+static uint8_t u8x8_record_Open(u8x8_record_t *r, const char *filename, uint16_t pixel_width, uint16_t pixel_height, uint16_t keyframe_interval)
+{
+  u8x8_record_free(r);
+
+  r->info.tile_width = (pixel_width+7)/8;
+  r->info.tile_height = (pixel_height+7)/8;
+  r->info.pixel_width = pixel_width;
+  r->info.pixel_height = pixel_height;
+  r->size = (size_t)r->info.tile_width*r->info.tile_height*8;
+  r->keyframe_interval = keyframe_interval == 0 ? 1 : keyframe_interval;
+  r->frame_cnt = 0;
+  r->lost_cnt = 0;
+  r->offset = 0;
+
+  /* display content, u8g2 buffer, previous frame, delta and compressed data */
+  r->u8x8_buf = (uint8_t *)malloc(r->size*5 + (r->size+127)/128);
+  if ( r->u8x8_buf == NULL )
+    return 0;
+  memset(r->u8x8_buf, 0, r->size*3);
+  r->u8g2_buf = r->u8x8_buf + r->size;
+  r->prev_buf = r->u8g2_buf + r->size;
+  r->delta_buf = r->prev_buf + r->size;
+  r->rle_buf = r->delta_buf + r->size;
+
+  r->fp = fopen(filename, "wb");
+  if ( r->fp == NULL )
+  {
+    perror(filename);
+    return 0;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &r->start);
+  record_write_data(r, "U8RC", 4);
+  record_write_word(r, U8X8_RECORD_VERSION);
+  record_write_word(r, pixel_width);
+  record_write_word(r, pixel_height);
+  record_write_word(r, r->keyframe_interval);
+  record_write_long(r, 0);
+  return 1;
+}
+
+/* write the frame index and the trailer, returns 0 if frames are missing or the file could not be written */
+static uint8_t u8x8_record_Close(u8x8_record_t *r)
+{
+  uint64_t index_offset = r->offset;
+  uint32_t i;
+  uint8_t is_ok = 1;
+  if ( r->fp == NULL )
+    return 0;
+  record_write_data(r, "U8RI", 4);
+  record_write_long(r, r->frame_cnt);
+  for( i = 0; i < r->frame_cnt; i++ )
+  {
+    record_write_long(r, r->index[i] & 0x0ffffffffUL);
+    record_write_long(r, r->index[i] >> 32);
+  }
+  record_write_data(r, "U8RT", 4);
+  record_write_long(r, r->frame_cnt);
+  record_write_long(r, index_offset & 0x0ffffffffUL);
+  record_write_long(r, index_offset >> 32);
+  if ( ferror(r->fp) || fclose(r->fp) != 0 )
+  {
+    perror("u8x8_record");
+    is_ok = 0;
+  }
+  r->fp = NULL;
+  if ( r->lost_cnt > 0 )
+  {
+    fprintf(stderr, "u8x8_record: %lu of %lu frames not recorded\n", (unsigned long)r->lost_cnt, (unsigned long)(r->lost_cnt + r->frame_cnt));
+    is_ok = 0;
+  }
+  return is_ok;
+}
+
+/*========================================================*/
+
+static uint8_t u8x8_d_record(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+/* returns the device object, NULL if u8x8 is not a recorder device */
+static u8x8_record_t *u8x8_record_GetDevice(u8x8_t *u8x8)
+{
+  if ( u8x8->display_cb != u8x8_d_record || u8x8->display_mem_size != sizeof(u8x8_record_t) )
+    return NULL;
+  return (u8x8_record_t *)u8x8->display_mem;
+}
+
+static const u8x8_display_info_t u8x8_record_info =
+{
+  /* chip_enable_level = */ 0,
+  /* chip_disable_level = */ 1,
+
+  /* post_chip_enable_wait_ns = */ 0,
+  /* pre_chip_disable_wait_ns = */ 0,
+  /* reset_pulse_width_ms = */ 0,
+  /* post_reset_wait_ms = */ 0,
+  /* sda_setup_time_ns = */ 0,
+  /* sck_pulse_width_ns = */ 0,
+  /* sck_clock_hz = */ 4000000UL,
+  /* spi_mode = */ 1,
+  /* i2c_bus_clock_100kHz = */ 0,
+  /* data_setup_time_ns = */ 0,
+  /* write_pulse_width_ns = */ 0,
+  /* tile_width = */ 8,		/* dummy value */
+  /* tile_hight = */ 4,		/* dummy value */
+  /* default_x_offset = */ 0,
+  /* flipmode_x_offset = */ 0,
+  /* pixel_width = */ 64,		/* dummy value */
+  /* pixel_height = */ 32		/* dummy value */
+};
+
+static uint8_t u8x8_d_record(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_record_t *r = u8x8_record_GetDevice(u8x8);
+  u8g2_uint_t x, y, c;
+  uint8_t *ptr;
+  if ( r == NULL )
+    return 0;
+  switch(msg)
+  {
+    case U8X8_MSG_DISPLAY_SETUP_MEMORY:
+      u8x8_d_helper_display_setup_memory(u8x8, &r->info);
+      break;
+    case U8X8_MSG_DISPLAY_INIT:
+      u8x8_d_helper_display_init(u8x8);	/* update low level interfaces (not required here) */
+      break;
+    case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
+      break;
+    case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
+      break;
+    case U8X8_MSG_DISPLAY_REFRESH:
+      u8x8_record_Frame(r);
+      break;
+    case U8X8_MSG_DISPLAY_DRAW_TILE:
+      x = ((u8x8_tile_t *)arg_ptr)->x_pos;
+      y = ((u8x8_tile_t *)arg_ptr)->y_pos;
+      c = ((u8x8_tile_t *)arg_ptr)->cnt;
+      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
+      do
+      {
+	u8x8_record_DrawTiles(r, x, y, c, ptr);
+	x += c;
+	arg_int--;
+      } while( arg_int > 0 );
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+
+/*========================================================*/
+/* u8x8 and u8g2 setup functions */
+
+/*
+  filename: recording, will be overwritten
+  keyframe_interval: every n-th frame is a keyframe, the other frames are delta frames
+  returns 0 if the file could not be created,
+  u8x8_CloseRecord() releases the device object also in this case
+*/
+uint8_t u8x8_SetupRecord(u8x8_t *u8x8, const char *filename, uint16_t pixel_width, uint16_t pixel_height, uint16_t keyframe_interval)
+{
+  u8x8_record_t *r = (u8x8_record_t *)calloc(1, sizeof(u8x8_record_t));
+  uint8_t is_ok;
+  if ( r == NULL )
+    return 0;
+
+  /* setup defaults */
+  u8x8_SetupDefaults(u8x8);
+  u8x8_SetDisplayMemory(u8x8, r, sizeof(u8x8_record_t));
+
+  /* setup specific callbacks */
+  u8x8->display_cb = u8x8_d_record;
+
+  r->info = u8x8_record_info;
+  is_ok = u8x8_record_Open(r, filename, pixel_width, pixel_height, keyframe_interval);
+
+  /* setup display info */
+  u8x8_SetupMemory(u8x8);
+  return is_ok;
+}
+
+uint8_t u8g2_SetupRecord(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *filename, uint16_t pixel_width, uint16_t pixel_height, uint16_t keyframe_interval)
+{
+  u8x8_record_t *r;
+  uint8_t is_ok;
+
+  /* open the file, assign the device callback to u8x8 */
+  is_ok = u8x8_SetupRecord(u8g2_GetU8x8(u8g2), filename, pixel_width, pixel_height, keyframe_interval);
+  if ( is_ok == 0 )
+    return 0;
+  r = u8x8_record_GetDevice(u8g2_GetU8x8(u8g2));
+  if ( r == NULL || r->u8g2_buf == NULL )
+    return 0;
+
+  /* configure u8g2 in full buffer mode */
+  u8g2_SetupBuffer(u8g2, r->u8g2_buf, r->info.tile_height, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
+  return 1;
+}
+
+/* 
+  finish the recording (write the frame index) and release the device object
+  returns 0 if frames could not be recorded or the file could not be written
+*/
+uint8_t u8x8_CloseRecord(u8x8_t *u8x8)
+{
+  u8x8_record_t *r = u8x8_record_GetDevice(u8x8);
+  uint8_t is_ok;
+  if ( r == NULL )
+    return 0;
+  is_ok = u8x8_record_Close(r);
+  u8x8_record_free(r);
+  free(r);
+  u8x8_SetDisplayMemory(u8x8, NULL, 0);
+  return is_ok;
+}
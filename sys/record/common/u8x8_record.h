@@ -0,0 +1,58 @@
+/*
+
+  u8x8_record.h
+
+  File format of the frame recorder (u8x8_SetupRecord(), u8g2_SetupRecord()).
+  All values are little endian.
+
+  File header (16 bytes)
+    4 bytes	"U8RC"
+    uint16	version (U8X8_RECORD_VERSION)
+    uint16	pixel width
+    uint16	pixel height
+    uint16	keyframe interval
+    uint32	reserved (0)
+
+  Frame (one for each U8X8_MSG_DISPLAY_REFRESH)
+    uint8	type: U8X8_RECORD_KEYFRAME or U8X8_RECORD_DELTA
+    uint32	time in milliseconds since the start of the recording
+    uint32	length of the compressed data
+    ...	compressed data
+
+    The uncompressed data of a frame has tile_width*tile_height*8 bytes,
+    same format as the u8g2 full buffer (vertical bytes, LSB on top).
+    A keyframe contains the image, a delta frame contains the XOR of the
+    image with the image of the previous frame. A delta frame with length
+    0 is identical to the previous frame.
+
+    Compression (run length): a control byte c is followed by
+      c < 128: c+1 literal bytes
+      c >= 128: one byte, which is repeated c-126 times (2..129)
+
+  Frame index (written when the recording is closed)
+    "U8RI"
+    uint32	number of frames
+    uint64	file offset of each frame
+
+  Trailer (last 16 bytes of the file)
+    "U8RT"
+    uint32	number of frames
+    uint64	file offset of the frame index
+
+  A recording without trailer (e.g. the program was terminated) can still
+  be read frame by frame from the beginning.
+
+*/
+
+#ifndef U8X8_RECORD_H
+#define U8X8_RECORD_H
+
+#define U8X8_RECORD_VERSION 1
+#define U8X8_RECORD_KEYFRAME 0
+#define U8X8_RECORD_DELTA 1
+
+#define U8X8_RECORD_FILE_HEADER_SIZE 16
+#define U8X8_RECORD_FRAME_HEADER_SIZE 9
+#define U8X8_RECORD_TRAILER_SIZE 16
+
+#endif
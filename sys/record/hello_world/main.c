@@ -0,0 +1,37 @@
+#include "u8g2.h"
+#include <stdio.h>
+
+/*
+ * This example records 300 frames into "hello_world.u8r".
+ * Convert the recording into PBM files with tools/u8rec2pbm:
+ *   u8rec2pbm hello_world.u8r
+ */
+
+u8g2_t u8g2;
+
+int main(void)
+{
+  int i;
+  char s[16];
+  
+  if ( u8g2_SetupRecord(&u8g2, &u8g2_cb_r0, "hello_world.u8r", 128, 64, 100) == 0 )
+    return 1;
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);
+  u8g2_SetFont(&u8g2, u8g2_font_helvB08_tr);
+
+  for( i = 0; i < 300; i++ )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    u8g2_DrawStr(&u8g2, 10, 20, "Hello, world!");
+    sprintf(s, "Frame %d", i);
+    u8g2_DrawStr(&u8g2, 10, 40, s);
+    u8g2_DrawBox(&u8g2, i%100, 50, 28, 8);
+    u8g2_SendBuffer(&u8g2);
+  }
+  
+  /* write the frame index */
+  if ( u8x8_CloseRecord(u8g2_GetU8x8(&u8g2)) == 0 )
+    return 1;
+  return 0;
+}
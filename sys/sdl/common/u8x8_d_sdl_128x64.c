@@ -1,12 +1,33 @@
 /*
   u8x8_d_sdl_128x64.c
+
+  SDL2 display: The display content is kept in a texture with one texel 
+  per display pixel (SDL_TEXTUREACCESS_STREAMING). Only the area of the 
+  changed tiles is uploaded, the texture is scaled by an integer factor 
+  (u8g_sdl_multiple) with SDL_RenderCopy().
+  
+  The window is updated with U8X8_MSG_DISPLAY_REFRESH (u8g2_SendBuffer(), 
+  u8g2_NextPage()). Tiles, which are drawn with u8x8 procedures, are shown
+  at most every 16ms and with the next call to u8g_sdl_get_key().
+  
+  u8g_sdl_set_fps(): The refresh waits for the next frame of a fixed frame 
+  rate, so that a busy drawing loop does not use the CPU all the time.
+  
+  Headless (e.g. for benchmarks): SDL_VIDEODRIVER=dummy
+  
+  There is only one SDL display per process: The window, the texture and 
+  the pixel memory are shared by all u8x8/u8g2 objects. Each setup procedure
+  creates a new window with the size of the new display, objects from an 
+  earlier setup will draw into this window. The buffers of these objects 
+  remain valid.
 */
 
 #include "u8g2.h"
 #ifndef NO_SDL
 #include "SDL.h"
 #endif
-#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
 
 //#define HEIGHT (64)
 //#define WIDTH 128
@@ -15,93 +36,164 @@
 
 #ifndef NO_SDL
 SDL_Window *u8g_sdl_window;
-SDL_Surface *u8g_sdl_screen;
+SDL_Renderer *u8g_sdl_renderer;
+SDL_Texture *u8g_sdl_texture;
 #endif
 
 int u8g_sdl_multiple = 3;
 uint32_t u8g_sdl_color[256];
 int u8g_sdl_height, u8g_sdl_width;
 
+static uint32_t *u8g_sdl_pixel;	/* u8g_sdl_width*u8g_sdl_height texels, ARGB8888 */
+static int u8g_sdl_fps = 0;	/* 0: no frame rate limit */
+static uint32_t u8g_sdl_next_frame;	/* time of the next frame in ms */
+static uint32_t u8g_sdl_last_present;	/* time of the last update of the window in ms */
+static int u8g_sdl_dirty_x0, u8g_sdl_dirty_y0, u8g_sdl_dirty_x1, u8g_sdl_dirty_y1;	/* changed area, empty if x0 >= x1 */
 
-
-static void u8g_sdl_set_pixel(int x, int y, int idx)
+static void u8g_sdl_set_multiple_8pixel(int x, int y, int cnt, uint8_t *pixel)
 {
-  uint32_t  *ptr;
-  uint32_t offset;
-  int i, j;
+  uint32_t *p;
+  uint32_t bg, fg = u8g_sdl_color[3];
+  uint8_t b;
+  int i, h;
   
-  if ( y >= u8g_sdl_height )
-    return;
-  if ( y < 0 )
-    return;
-  if ( x >= u8g_sdl_width )
-    return;
-  if ( x < 0 )
+  if ( u8g_sdl_pixel == NULL || y < 0 || y >= u8g_sdl_height || x < 0 || x >= u8g_sdl_width )
     return;
+  if ( x + cnt > u8g_sdl_width )
+    cnt = u8g_sdl_width - x;
+  h = u8g_sdl_height - y < 8 ? u8g_sdl_height - y : 8;
   
-  for( i = 0; i < u8g_sdl_multiple; i++ )
-    for( j = 0; j < u8g_sdl_multiple; j++ )
+  for( i = 0; i < cnt; i++ )
+  {
+    /* checkerboard background, one color per tile */
+    bg = u8g_sdl_color[ (((x+i)/8 + y/8) & 1) ? 4 : 0 ];
+    b = pixel[i];
+    p = u8g_sdl_pixel + y*u8g_sdl_width + x + i;
+    switch(h)
     {
+      case 8: p[7*u8g_sdl_width] = (b & 128) ? fg : bg;	/* fall through */
+      case 7: p[6*u8g_sdl_width] = (b & 64) ? fg : bg;	/* fall through */
+      case 6: p[5*u8g_sdl_width] = (b & 32) ? fg : bg;	/* fall through */
+      case 5: p[4*u8g_sdl_width] = (b & 16) ? fg : bg;	/* fall through */
+      case 4: p[3*u8g_sdl_width] = (b & 8) ? fg : bg;	/* fall through */
+      case 3: p[2*u8g_sdl_width] = (b & 4) ? fg : bg;	/* fall through */
+      case 2: p[1*u8g_sdl_width] = (b & 2) ? fg : bg;	/* fall through */
+      default: p[0] = (b & 1) ? fg : bg;
+    }
+  }
+  
+  /* extend the changed area */
+  if ( u8g_sdl_dirty_x0 >= u8g_sdl_dirty_x1 )
+  {
+    u8g_sdl_dirty_x0 = x;
+    u8g_sdl_dirty_y0 = y;
+    u8g_sdl_dirty_x1 = x + cnt;
+    u8g_sdl_dirty_y1 = y + h;
+  }
+  else
+  {
+    if ( u8g_sdl_dirty_x0 > x ) u8g_sdl_dirty_x0 = x;
+    if ( u8g_sdl_dirty_y0 > y ) u8g_sdl_dirty_y0 = y;
+    if ( u8g_sdl_dirty_x1 < x + cnt ) u8g_sdl_dirty_x1 = x + cnt;
+    if ( u8g_sdl_dirty_y1 < y + h ) u8g_sdl_dirty_y1 = y + h;
+  }
+}
+
+/* upload the changed area into the texture and show it */
+static void u8g_sdl_present(void)
+{
 #ifndef NO_SDL
-      offset = (
-        ((y * u8g_sdl_multiple) + i) * (u8g_sdl_width * u8g_sdl_multiple) + 
-        ((x * u8g_sdl_multiple) + j)) * u8g_sdl_screen->format->BytesPerPixel;
-        
-      assert( offset < (Uint32)(u8g_sdl_width * u8g_sdl_multiple * u8g_sdl_height * u8g_sdl_multiple * u8g_sdl_screen->format->BytesPerPixel) );
-      
-      ptr = (uint32_t *)(((uint8_t *)(u8g_sdl_screen->pixels)) + offset);
-      *ptr = u8g_sdl_color[idx];
+  SDL_Rect r;
+  if ( u8g_sdl_renderer == NULL || u8g_sdl_dirty_x0 >= u8g_sdl_dirty_x1 )
+    return;
+  r.x = u8g_sdl_dirty_x0;
+  r.y = u8g_sdl_dirty_y0;
+  r.w = u8g_sdl_dirty_x1 - u8g_sdl_dirty_x0;
+  r.h = u8g_sdl_dirty_y1 - u8g_sdl_dirty_y0;
+  SDL_UpdateTexture(u8g_sdl_texture, &r, u8g_sdl_pixel + r.y*u8g_sdl_width + r.x, u8g_sdl_width*4);
+  SDL_RenderCopy(u8g_sdl_renderer, u8g_sdl_texture, NULL, NULL);
+  SDL_RenderPresent(u8g_sdl_renderer);
+  u8g_sdl_last_present = SDL_GetTicks();
 #endif
-    }
+  u8g_sdl_dirty_x0 = 0;
+  u8g_sdl_dirty_x1 = 0;
+}
+
+/* show pending changes, called by u8g_sdl_get_key() */
+void u8g_sdl_flush(void)
+{
+  u8g_sdl_present();
 }
 
-static void u8g_sdl_set_8pixel(int x, int y, uint8_t pixel)
+/* show the display content, wait for the next frame if a frame rate is set */
+static void u8g_sdl_refresh(void)
 {
-  int cnt = 8;
-  int bg = 0;
-  if ( (x/8 + y/8)  & 1 )
-    bg = 4;
-  while( cnt > 0 )
+#ifndef NO_SDL
+  uint32_t now;
+  if ( u8g_sdl_fps > 0 )
   {
-    if ( (pixel & 1) == 0 )
-    {
-      u8g_sdl_set_pixel(x,y,bg);
-    }
+    now = SDL_GetTicks();
+    if ( (int32_t)(u8g_sdl_next_frame - now) > 0 )
+      SDL_Delay(u8g_sdl_next_frame - now);
     else
-    {
-      u8g_sdl_set_pixel(x,y,3);
-    }
-    pixel >>= 1;
-    y++;
-    cnt--;
+      u8g_sdl_next_frame = now;	/* too late, restart the frame sequence */
+    u8g_sdl_next_frame += 1000 / u8g_sdl_fps;
   }
+#endif
+  u8g_sdl_present();
 }
 
-static void u8g_sdl_set_multiple_8pixel(int x, int y, int cnt, uint8_t *pixel)
+/* fps = 0: no limit */
+void u8g_sdl_set_fps(int fps)
 {
-  uint8_t b;
-  while( cnt > 0 )
-  {
-    b = *pixel;
-    u8g_sdl_set_8pixel(x, y, b);
-    x++;
-    pixel++;
-    cnt--;
-  }
+  u8g_sdl_fps = fps < 0 ? 0 : fps;
+#ifndef NO_SDL
+  u8g_sdl_next_frame = SDL_GetTicks();
+#endif
+}
+
+/* integer scale factor of the window, must be called before the setup procedure */
+void u8g_sdl_set_scale(int scale)
+{
+  u8g_sdl_multiple = scale < 1 ? 1 : scale;
 }
 
 static void u8g_sdl_init(int width, int height)
 {
+  uint32_t *pixel;
+  int i;
+  
+  /* the pixel memory is only used by this file, the size follows the new window */
+  pixel = (uint32_t *)realloc(u8g_sdl_pixel, (size_t)width*height*sizeof(uint32_t));
+  if ( pixel == NULL )
+  {
+    printf("Out of memory\n");
+    exit(1);
+  }
+  u8g_sdl_pixel = pixel;
   u8g_sdl_height = height;
   u8g_sdl_width = width;
+  u8g_sdl_dirty_x0 = 0;
+  u8g_sdl_dirty_x1 = 0;
   
 #ifndef NO_SDL
   
-  if (SDL_Init(SDL_INIT_VIDEO) != 0) 
+  if ( u8g_sdl_window != NULL )
+  {
+    /* new setup: create a new window with the new size */
+    SDL_DestroyTexture(u8g_sdl_texture);
+    SDL_DestroyRenderer(u8g_sdl_renderer);
+    SDL_DestroyWindow(u8g_sdl_window);
+  }
+  else if (SDL_Init(SDL_INIT_VIDEO) != 0) 
   {
     printf("Unable to initialize SDL:  %s\n", SDL_GetError());
     exit(1);
   }
+  else
+  {
+    atexit(SDL_Quit);
+  }
   
   u8g_sdl_window = SDL_CreateWindow("U8g2", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, u8g_sdl_width * u8g_sdl_multiple, u8g_sdl_height * u8g_sdl_multiple, 0);
 
@@ -111,53 +203,47 @@ static void u8g_sdl_init(int width, int height)
     exit(1);
   }
 
-  u8g_sdl_screen = SDL_GetWindowSurface(u8g_sdl_window);
-
-  if ( u8g_sdl_screen == NULL )
+  u8g_sdl_renderer = SDL_CreateRenderer(u8g_sdl_window, -1, 0);
+  if ( u8g_sdl_renderer == NULL )
   {
-    printf("Couldn't create screen: %s\n", SDL_GetError());
+    printf("Couldn't create renderer: %s\n", SDL_GetError());
     exit(1);
   }
   
-  printf("%d bits-per-pixel mode\n", u8g_sdl_screen->format->BitsPerPixel);
-  printf("%d bytes-per-pixel mode\n", u8g_sdl_screen->format->BytesPerPixel);
+  /* nearest pixel, integer scaling */
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+  SDL_RenderSetLogicalSize(u8g_sdl_renderer, u8g_sdl_width, u8g_sdl_height);
+  SDL_RenderSetIntegerScale(u8g_sdl_renderer, SDL_TRUE);
   
-  u8g_sdl_color[0] = SDL_MapRGB( u8g_sdl_screen->format, 0, 0, 0 );
-  u8g_sdl_color[1] = SDL_MapRGB( u8g_sdl_screen->format, W(100, 50), W(255,50), 0 );
-  u8g_sdl_color[2] = SDL_MapRGB( u8g_sdl_screen->format, W(100, 80), W(255,80), 0 );
-  u8g_sdl_color[3] = SDL_MapRGB( u8g_sdl_screen->format, 100, 255, 0 );
-  u8g_sdl_color[4] = SDL_MapRGB( u8g_sdl_screen->format, 30, 30, 30 );
-
-  /*
-  u8g_sdl_set_pixel(0,0);
-  u8g_sdl_set_pixel(1,1);
-  u8g_sdl_set_pixel(2,2);
-  */
-
-  /* update all */
-  SDL_UpdateWindowSurface(u8g_sdl_window);
-
-  atexit(SDL_Quit);
+  u8g_sdl_texture = SDL_CreateTexture(u8g_sdl_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, u8g_sdl_width, u8g_sdl_height);
+  if ( u8g_sdl_texture == NULL )
+  {
+    printf("Couldn't create texture: %s\n", SDL_GetError());
+    exit(1);
+  }
 #endif  
+  
+  u8g_sdl_color[0] = 0xff000000;
+  u8g_sdl_color[1] = 0xff000000 | (W(100, 50) << 16) | (W(255,50) << 8);
+  u8g_sdl_color[2] = 0xff000000 | (W(100, 80) << 16) | (W(255,80) << 8);
+  u8g_sdl_color[3] = 0xff000000 | (100 << 16) | (255 << 8);
+  u8g_sdl_color[4] = 0xff000000 | (30 << 16) | (30 << 8) | 30;
+
+  /* clear the display (background pattern) and update all */
+  for( i = 0; i < height; i += 8 )
+  {
+    int x;
+    uint8_t zero = 0;
+    for( x = 0; x < width; x++ )
+      u8g_sdl_set_multiple_8pixel(x, i, 1, &zero);
+  }
+  u8g_sdl_next_frame = 0;
+  u8g_sdl_last_present = 0;
+  u8g_sdl_present();
   return;
 }
 
 
-
-/*
-void main(void)
-{
-  u8g_sdl_init();
-  u8g_sdl_set_pixel(0,0,3);
-  u8g_sdl_set_pixel(0,1,3);
-  u8g_sdl_set_pixel(0,2,3);
-  u8g_sdl_set_pixel(1,1,3);
-  u8g_sdl_set_pixel(2,2,3);
-  while( u8g_sdl_get_key() < 0 )
-    ;
-}
-*/
-
 static const u8x8_display_info_t u8x8_sdl_128x64_info =
 {
   /* chip_enable_level = */ 0,
@@ -263,16 +349,12 @@ static uint8_t u8x8_d_sdl_gpio(u8x8_t *u8x8, uint8_t msg, U8X8_UNUSED uint8_t ar
 	return 1;
 }
 
-uint8_t u8x8_d_sdl_128x64(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+static uint8_t u8x8_d_sdl_common(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  uint8_t x, y, c;
+  uint16_t x, y, c;
   uint8_t *ptr;
   switch(msg)
   {
-    case U8X8_MSG_DISPLAY_SETUP_MEMORY:
-      u8x8_d_helper_display_setup_memory(u8g2, &u8x8_sdl_128x64_info);
-      u8g_sdl_init(128, 64);
-      break;
     case U8X8_MSG_DISPLAY_INIT:
       u8x8_d_helper_display_init(u8g2);
       break;
@@ -282,6 +364,9 @@ uint8_t u8x8_d_sdl_128x64(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_
       break;
     case U8X8_MSG_DISPLAY_SET_CONTRAST:
       break;
+    case U8X8_MSG_DISPLAY_REFRESH:
+      u8g_sdl_refresh();
+      break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
       x = ((u8x8_tile_t *)arg_ptr)->x_pos;
       x *= 8;
@@ -299,10 +384,11 @@ uint8_t u8x8_d_sdl_128x64(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_
 	x+=c*8;
       } while( arg_int > 0 );
       
-      /* update all */
+      /* u8x8 procedures do not send a refresh, show the tiles from time to time */
 #ifndef NO_SDL
-      SDL_UpdateWindowSurface(u8g_sdl_window);
-#endif      
+      if ( u8g_sdl_fps == 0 && SDL_GetTicks() - u8g_sdl_last_present >= 16 )
+        u8g_sdl_present();
+#endif
       break;
     default:
       return 0;
@@ -310,51 +396,41 @@ uint8_t u8x8_d_sdl_128x64(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_
   return 1;
 }
 
+uint8_t u8x8_d_sdl_128x64(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  if ( msg == U8X8_MSG_DISPLAY_SETUP_MEMORY )
+  {
+    u8x8_d_helper_display_setup_memory(u8g2, &u8x8_sdl_128x64_info);
+    u8g_sdl_init(128, 64);
+    return 1;
+  }
+  return u8x8_d_sdl_common(u8g2, msg, arg_int, arg_ptr);
+}
+
 uint8_t u8x8_d_sdl_240x160(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-  uint8_t x, y, c;
-  uint8_t *ptr;
-  switch(msg)
+  if ( msg == U8X8_MSG_DISPLAY_SETUP_MEMORY )
   {
-    case U8X8_MSG_DISPLAY_SETUP_MEMORY:
-      u8x8_d_helper_display_setup_memory(u8g2, &u8x8_sdl_240x160_info);
-      u8g_sdl_init(240, 160);
-      break;
-    case U8X8_MSG_DISPLAY_INIT:
-      u8x8_d_helper_display_init(u8g2);
-      break;
-    case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
-      break;
-    case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
-      break;
-    case U8X8_MSG_DISPLAY_SET_CONTRAST:
-      break;
-    case U8X8_MSG_DISPLAY_DRAW_TILE:
-      x = ((u8x8_tile_t *)arg_ptr)->x_pos;
-      x *= 8;
-      x += u8g2->x_offset;
-    
-      y = ((u8x8_tile_t *)arg_ptr)->y_pos;
-      y *= 8;
-    
-      do
-      {
-        c = ((u8x8_tile_t *)arg_ptr)->cnt;
-        ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
-        u8g_sdl_set_multiple_8pixel(x, y, c*8, ptr);
-        arg_int--;
-      } while( arg_int > 0 );
+    u8x8_d_helper_display_setup_memory(u8g2, &u8x8_sdl_240x160_info);
+    u8g_sdl_init(240, 160);
+    return 1;
+  }
+  return u8x8_d_sdl_common(u8g2, msg, arg_int, arg_ptr);
+}
 
-#ifndef NO_SDL
-      /* update all */
-      SDL_UpdateWindowSurface(u8g_sdl_window);
-#endif
-      
-      break;
-    default:
-      return 0;
+/* any size, the display info is the display memory of the u8x8 object, see u8x8_Setup_SDL() */
+uint8_t u8x8_d_sdl(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  const u8x8_display_info_t *info = (const u8x8_display_info_t *)u8g2->display_mem;
+  if ( info == NULL || u8g2->display_mem_size != sizeof(u8x8_display_info_t) )
+    return 0;
+  if ( msg == U8X8_MSG_DISPLAY_SETUP_MEMORY )
+  {
+    u8x8_d_helper_display_setup_memory(u8g2, info);
+    u8g_sdl_init(info->pixel_width, info->pixel_height);
+    return 1;
   }
-  return 1;
+  return u8x8_d_sdl_common(u8g2, msg, arg_int, arg_ptr);
 }
 
 
@@ -423,3 +499,59 @@ void u8g2_SetupBuffer_SDL_240x160(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb)
   u8x8_Setup_SDL_240x160(u8g2_GetU8x8(u8g2));
   u8g2_SetupBuffer(u8g2, buf, 20, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
 }
+
+
+/* 
+  display with any size, width and height up to 2040 pixel 
+  each u8x8 object has its own display info, so an object from an earlier
+  setup keeps its size
+*/
+void u8x8_Setup_SDL(u8x8_t *u8x8, uint16_t pixel_width, uint16_t pixel_height)
+{
+  u8x8_display_info_t *info = NULL;
+  
+  /* reuse the display info, if the object was already setup for SDL */
+  if ( u8x8->display_cb == u8x8_d_sdl && u8x8->display_mem_size == sizeof(u8x8_display_info_t) )
+    info = (u8x8_display_info_t *)u8x8->display_mem;
+  if ( info == NULL )
+    info = (u8x8_display_info_t *)malloc(sizeof(u8x8_display_info_t));
+  if ( info == NULL )
+  {
+    printf("Out of memory\n");
+    exit(1);
+  }
+  
+  /* setup defaults */
+  u8x8_SetupDefaults(u8x8);
+  u8x8_SetDisplayMemory(u8x8, info, sizeof(u8x8_display_info_t));
+  
+  *info = u8x8_sdl_128x64_info;
+  info->tile_width = (pixel_width+7)/8;
+  info->tile_height = (pixel_height+7)/8;
+  info->pixel_width = pixel_width;
+  info->pixel_height = pixel_height;
+  
+  /* setup specific callbacks */
+  u8x8->display_cb = u8x8_d_sdl;
+	
+  u8x8->gpio_and_delay_cb = u8x8_d_sdl_gpio;
+
+  /* setup display info */
+  u8x8_SetupMemory(u8x8);  
+}
+
+/* full buffer, the buffer is allocated for each call and never released */
+void u8g2_SetupBuffer_SDL(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, uint16_t pixel_width, uint16_t pixel_height)
+{
+  uint8_t *buf;
+  
+  /* an earlier u8g2 object might still use its buffer, so it is not released here */
+  buf = (uint8_t *)malloc((size_t)((pixel_width+7)/8)*((pixel_height+7)/8)*8);
+  if ( buf == NULL )
+  {
+    printf("Out of memory\n");
+    exit(1);
+  }
+  u8x8_Setup_SDL(u8g2_GetU8x8(u8g2), pixel_width, pixel_height);
+  u8g2_SetupBuffer(u8g2, buf, (pixel_height+7)/8, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
+}
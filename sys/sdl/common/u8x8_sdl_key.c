@@ -1,4 +1,5 @@
 
+#include "u8x8.h"
 #ifndef NO_SDL
 #include "SDL.h"
 #endif
@@ -9,6 +10,7 @@ int u8g_sdl_get_key(void)
 #ifndef NO_SDL
 
   SDL_Event event;
+  u8g_sdl_flush();	/* show tiles, which were not yet shown */
   /* https://wiki.libsdl.org/SDL_PollEvent */
   if ( SDL_PollEvent(&event) != 0 )
   {
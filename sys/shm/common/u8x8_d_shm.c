@@ -0,0 +1,408 @@
+/*
+
+  u8x8_d_shm.c
+
+  a shared memory device: each frame is published into a POSIX shared
+  memory ring, which can be followed by other processes (viewer, recorder,
+  test procedures), see u8x8_shm.h for the layout
+
+  A new frame is published with U8X8_MSG_DISPLAY_REFRESH (u8x8_RefreshDisplay(),
+  sent by u8g2_SendBuffer() and u8g2_NextPage()).
+  The device object is the display memory (u8x8_SetDisplayMemory()) of the
+  u8x8 object, so the user_ptr remains available for the application.
+
+*/
+
+#include <stdlib.h>	/* malloc */
+#include <stdint.h>	/* uint16_t */
+#include <string.h>	/* memcpy */
+#include <stdio.h>
+#include <time.h>	/* clock_gettime */
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "u8g2.h"		/* because of u8g2_Setup... */
+#include "u8x8_shm.h"
+
+#define U8X8_SHM_HEADER_SIZE 64
+
+/*========================================================*/
+/* shm device struct */
+
+struct _u8x8_shm_struct
+{
+  u8x8_display_info_t info;
+  char *name;
+  u8x8_shm_ring_t *ring;
+  size_t ring_size;
+  uint8_t *u8x8_buf;		/* current content of the display */
+  uint8_t *u8g2_buf;
+  uint8_t *dirty;		/* tiles changed since the last frame */
+  uint32_t dirty_tile_cnt;
+};
+
+typedef struct _u8x8_shm_struct u8x8_shm_t;
+
+/*========================================================*/
+/* ring functions */
+
+static uint8_t *u8x8_shm_GetSlot(const u8x8_shm_ring_t *ring, uint64_t seq)
+{
+  return (uint8_t *)ring + ring->header_size + (size_t)(seq % ring->frame_cnt) * ring->frame_size;
+}
+
+static uint64_t u8x8_shm_timestamp(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void u8x8_shm_free(u8x8_shm_t *s)
+{
+  if ( s->ring != NULL )
+    munmap(s->ring, s->ring_size);
+  s->ring = NULL;
+  free(s->u8x8_buf);
+  s->u8x8_buf = NULL;
+  s->u8g2_buf = NULL;
+  s->dirty = NULL;
+  free(s->name);
+  s->name = NULL;
+}
+
+static uint8_t u8x8_shm_Create(u8x8_shm_t *s, const char *name, uint16_t pixel_width, uint16_t pixel_height, uint8_t frame_cnt)
+{
+  size_t tiles, dirty_size, frame_size;
+  int fd;
+
+  u8x8_shm_free(s);
+  if ( frame_cnt < 2 )
+    frame_cnt = 2;
+
+  s->info.tile_width = (pixel_width+7)/8;
+  s->info.tile_height = (pixel_height+7)/8;
+  s->info.pixel_width = pixel_width;
+  s->info.pixel_height = pixel_height;
+
+  tiles = (size_t)s->info.tile_width * (size_t)s->info.tile_height;
+  dirty_size = ((tiles+7)/8 + 7) & ~(size_t)7;
+  frame_size = (sizeof(u8x8_shm_frame_t) + dirty_size + tiles*8 + 63) & ~(size_t)63;
+
+  /* the display content for u8x8, the buffer for u8g2 and the dirty bitmap */
+  s->u8x8_buf = (uint8_t *)malloc(tiles*8*2 + dirty_size);
+  if ( s->u8x8_buf == NULL )
+    return 0;
+  s->u8g2_buf = s->u8x8_buf + tiles*8;
+  s->dirty = s->u8g2_buf + tiles*8;
+  memset(s->u8x8_buf, 0, tiles*8*2 + dirty_size);
+  s->dirty_tile_cnt = 0;
+
+  s->name = strdup(name);
+  s->ring_size = U8X8_SHM_HEADER_SIZE + frame_size * frame_cnt;
+  fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+  if ( fd < 0 )
+  {
+    perror(name);
+    return 0;
+  }
+  if ( ftruncate(fd, s->ring_size) != 0 )
+  {
+    perror("ftruncate");
+    close(fd);
+    return 0;
+  }
+  s->ring = (u8x8_shm_ring_t *)mmap(NULL, s->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( s->ring == MAP_FAILED )
+  {
+    s->ring = NULL;
+    perror("mmap");
+    return 0;
+  }
+
+  /* readers ignore the ring until the magic value is written */
+  __atomic_store_n(&s->ring->magic, 0, __ATOMIC_RELEASE);
+  memset(s->ring, 0, s->ring_size);
+  s->ring->version = U8X8_SHM_VERSION;
+  s->ring->header_size = U8X8_SHM_HEADER_SIZE;
+  s->ring->frame_cnt = frame_cnt;
+  s->ring->frame_size = frame_size;
+  s->ring->dirty_size = dirty_size;
+  s->ring->pixel_width = pixel_width;
+  s->ring->pixel_height = pixel_height;
+  s->ring->tile_width = s->info.tile_width;
+  s->ring->tile_height = s->info.tile_height;
+  __atomic_store_n(&s->ring->magic, U8X8_SHM_MAGIC, __ATOMIC_RELEASE);
+  return 1;
+}
+
+static void u8x8_shm_DrawTiles(u8x8_shm_t *s, uint16_t tx, uint16_t ty, uint8_t tile_cnt, uint8_t *tile_ptr)
+{
+  uint32_t pos;
+  if ( s->u8x8_buf == NULL || ty >= s->info.tile_height )
+    return;
+  if ( tx >= s->info.tile_width )
+    return;
+  if ( tx + tile_cnt > s->info.tile_width )
+    tile_cnt = s->info.tile_width - tx;
+  pos = (uint32_t)ty*s->info.tile_width + tx;
+  /* only tiles with new content are marked as dirty */
+  while( tile_cnt > 0 )
+  {
+    if ( memcmp(s->u8x8_buf + pos*8, tile_ptr, 8) != 0 )
+    {
+      memcpy(s->u8x8_buf + pos*8, tile_ptr, 8);
+      if ( (s->dirty[pos>>3] & (1<<(pos&7))) == 0 )
+      {
+	s->dirty[pos>>3] |= 1<<(pos&7);
+	s->dirty_tile_cnt++;
+      }
+    }
+    tile_ptr += 8;
+    pos++;
+    tile_cnt--;
+  }
+}
+
+/* copy the display content into the next slot of the ring */
+static void u8x8_shm_Publish(u8x8_shm_t *s)
+{
+  u8x8_shm_ring_t *ring = s->ring;
+  u8x8_shm_frame_t *frame;
+  uint8_t *slot;
+  uint64_t seq;
+
+  if ( ring == NULL )
+    return;
+  seq = ring->write_seq + 1;
+  slot = u8x8_shm_GetSlot(ring, seq);
+  frame = (u8x8_shm_frame_t *)slot;
+
+  /* invalidate the slot, readers of the old frame will notice this */
+  __atomic_store_n(&frame->seq, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  frame->timestamp_ns = u8x8_shm_timestamp();
+  frame->dirty_tile_cnt = s->dirty_tile_cnt;
+  memcpy(slot + sizeof(u8x8_shm_frame_t), s->dirty, ring->dirty_size);
+  memcpy(slot + sizeof(u8x8_shm_frame_t) + ring->dirty_size, s->u8x8_buf, (size_t)s->info.tile_width*s->info.tile_height*8);
+
+  __atomic_store_n(&frame->seq, seq, __ATOMIC_RELEASE);
+  __atomic_store_n(&ring->write_seq, seq, __ATOMIC_RELEASE);
+
+  memset(s->dirty, 0, ring->dirty_size);
+  s->dirty_tile_cnt = 0;
+}
+
+/*========================================================*/
+/* reader functions */
+
+const u8x8_shm_ring_t *u8x8_shm_OpenReader(const char *name)
+{
+  u8x8_shm_ring_t *ring;
+  u8x8_shm_ring_t header;
+  size_t size;
+  int fd;
+
+  fd = shm_open(name, O_RDONLY, 0);
+  if ( fd < 0 )
+    return NULL;
+  if ( read(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)
+    || __atomic_load_n(&header.magic, __ATOMIC_ACQUIRE) != U8X8_SHM_MAGIC
+    || header.version != U8X8_SHM_VERSION )
+  {
+    close(fd);
+    return NULL;
+  }
+  size = header.header_size + (size_t)header.frame_cnt * header.frame_size;
+  ring = (u8x8_shm_ring_t *)mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( ring == MAP_FAILED )
+    return NULL;
+  return ring;
+}
+
+void u8x8_shm_CloseReader(const u8x8_shm_ring_t *ring)
+{
+  if ( ring == NULL )
+    return;
+  munmap((void *)ring, ring->header_size + (size_t)ring->frame_cnt * ring->frame_size);
+}
+
+uint64_t u8x8_shm_GetLastSeq(const u8x8_shm_ring_t *ring)
+{
+  return __atomic_load_n(&ring->write_seq, __ATOMIC_ACQUIRE);
+}
+
+const u8x8_shm_frame_t *u8x8_shm_GetFrame(const u8x8_shm_ring_t *ring, uint64_t seq)
+{
+  const u8x8_shm_frame_t *frame;
+  if ( seq == 0 )
+    return NULL;
+  frame = (const u8x8_shm_frame_t *)u8x8_shm_GetSlot(ring, seq);
+  if ( __atomic_load_n(&frame->seq, __ATOMIC_ACQUIRE) != seq )
+    return NULL;
+  return frame;
+}
+
+uint8_t u8x8_shm_IsFrameValid(const u8x8_shm_frame_t *frame, uint64_t seq)
+{
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&frame->seq, __ATOMIC_RELAXED) == seq;
+}
+
+uint8_t u8x8_shm_GetPixel(const u8x8_shm_ring_t *ring, const u8x8_shm_frame_t *frame, uint16_t x, uint16_t y)
+{
+  const uint8_t *p = u8x8_shm_GetTiles(ring, frame);
+  if ( x >= ring->pixel_width || y >= ring->pixel_height )
+    return 0;
+  p += (size_t)(y/8)*ring->tile_width*8;
+  p += x;
+  return (*p >> (y&7)) & 1;
+}
+
+uint8_t u8x8_shm_IsTileDirty(const u8x8_shm_ring_t *ring, const u8x8_shm_frame_t *frame, uint16_t tx, uint16_t ty)
+{
+  uint32_t pos = (uint32_t)ty*ring->tile_width + tx;
+  return (u8x8_shm_GetDirtyMap(frame)[pos>>3] >> (pos&7)) & 1;
+}
+
+/*========================================================*/
+
+static uint8_t u8x8_d_shm(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+/* returns the device object, NULL if u8x8 is not a shm device */
+static u8x8_shm_t *u8x8_shm_GetDevice(u8x8_t *u8x8)
+{
+  if ( u8x8->display_cb != u8x8_d_shm || u8x8->display_mem_size != sizeof(u8x8_shm_t) )
+    return NULL;
+  return (u8x8_shm_t *)u8x8->display_mem;
+}
+
+static const u8x8_display_info_t u8x8_shm_info =
+{
+  /* chip_enable_level = */ 0,
+  /* chip_disable_level = */ 1,
+
+  /* post_chip_enable_wait_ns = */ 0,
+  /* pre_chip_disable_wait_ns = */ 0,
+  /* reset_pulse_width_ms = */ 0,
+  /* post_reset_wait_ms = */ 0,
+  /* sda_setup_time_ns = */ 0,
+  /* sck_pulse_width_ns = */ 0,
+  /* sck_clock_hz = */ 4000000UL,
+  /* spi_mode = */ 1,
+  /* i2c_bus_clock_100kHz = */ 0,
+  /* data_setup_time_ns = */ 0,
+  /* write_pulse_width_ns = */ 0,
+  /* tile_width = */ 8,		/* dummy value */
+  /* tile_hight = */ 4,		/* dummy value */
+  /* default_x_offset = */ 0,
+  /* flipmode_x_offset = */ 0,
+  /* pixel_width = */ 64,		/* dummy value */
+  /* pixel_height = */ 32		/* dummy value */
+};
+
+static uint8_t u8x8_d_shm(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+  u8x8_shm_t *s = u8x8_shm_GetDevice(u8x8);
+  u8g2_uint_t x, y, c;
+  uint8_t *ptr;
+  if ( s == NULL )
+    return 0;
+  switch(msg)
+  {
+    case U8X8_MSG_DISPLAY_SETUP_MEMORY:
+      u8x8_d_helper_display_setup_memory(u8x8, &s->info);
+      break;
+    case U8X8_MSG_DISPLAY_INIT:
+      u8x8_d_helper_display_init(u8x8);	/* update low level interfaces (not required here) */
+      break;
+    case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
+      break;
+    case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
+      break;
+    case U8X8_MSG_DISPLAY_REFRESH:
+      u8x8_shm_Publish(s);
+      break;
+    case U8X8_MSG_DISPLAY_DRAW_TILE:
+      x = ((u8x8_tile_t *)arg_ptr)->x_pos;
+      y = ((u8x8_tile_t *)arg_ptr)->y_pos;
+      c = ((u8x8_tile_t *)arg_ptr)->cnt;
+      ptr = ((u8x8_tile_t *)arg_ptr)->tile_ptr;
+      do
+      {
+	u8x8_shm_DrawTiles(s, x, y, c, ptr);
+	x += c;
+	arg_int--;
+      } while( arg_int > 0 );
+      break;
+    default:
+      return 0;
+  }
+  return 1;
+}
+
+
+/*========================================================*/
+/* u8x8 and u8g2 setup functions */
+
+/*
+  name: name of the shared memory object, e.g. "/u8g2"
+  frame_cnt: number of frames in the ring (at least 2)
+  returns 0 if the shared memory ring could not be created,
+  u8x8_CloseShm() releases the device object also in this case
+*/
+uint8_t u8x8_SetupShm(u8x8_t *u8x8, const char *name, uint16_t pixel_width, uint16_t pixel_height, uint8_t frame_cnt)
+{
+  u8x8_shm_t *s = (u8x8_shm_t *)calloc(1, sizeof(u8x8_shm_t));
+  uint8_t is_ok;
+  if ( s == NULL )
+    return 0;
+
+  /* setup defaults */
+  u8x8_SetupDefaults(u8x8);
+  u8x8_SetDisplayMemory(u8x8, s, sizeof(u8x8_shm_t));
+
+  /* setup specific callbacks */
+  u8x8->display_cb = u8x8_d_shm;
+
+  s->info = u8x8_shm_info;
+  is_ok = u8x8_shm_Create(s, name, pixel_width, pixel_height, frame_cnt);
+
+  /* setup display info */
+  u8x8_SetupMemory(u8x8);
+  return is_ok;
+}
+
+uint8_t u8g2_SetupShm(u8g2_t *u8g2, const u8g2_cb_t *u8g2_cb, const char *name, uint16_t pixel_width, uint16_t pixel_height, uint8_t frame_cnt)
+{
+  u8x8_shm_t *s;
+  uint8_t is_ok;
+
+  /* create the ring, assign the device callback to u8x8 */
+  is_ok = u8x8_SetupShm(u8g2_GetU8x8(u8g2), name, pixel_width, pixel_height, frame_cnt);
+  if ( is_ok == 0 )
+    return 0;
+  s = u8x8_shm_GetDevice(u8g2_GetU8x8(u8g2));
+  if ( s == NULL || s->u8g2_buf == NULL )
+    return 0;
+
+  /* configure u8g2 in full buffer mode */
+  u8g2_SetupBuffer(u8g2, s->u8g2_buf, s->info.tile_height, u8g2_ll_hvline_vertical_top_lsb, u8g2_cb);
+  return 1;
+}
+
+/* release the device object, is_unlink = 1: also remove the shared memory object */
+void u8x8_CloseShm(u8x8_t *u8x8, uint8_t is_unlink)
+{
+  u8x8_shm_t *s = u8x8_shm_GetDevice(u8x8);
+  if ( s == NULL )
+    return;
+  if ( is_unlink && s->name != NULL )
+    shm_unlink(s->name);
+  u8x8_shm_free(s);
+  free(s);
+  u8x8_SetDisplayMemory(u8x8, NULL, 0);
+}
@@ -0,0 +1,77 @@
+/*
+
+  u8x8_shm.h
+
+  Layout of the shared memory ring, written by the shm device
+  (u8x8_SetupShm(), u8g2_SetupShm()) and read by other processes.
+
+  The shared memory object contains a ring header followed by frame_cnt
+  frame slots of frame_size bytes. Frame with sequence number seq (1, 2, ...)
+  is stored in slot seq % frame_cnt. Each slot contains:
+    u8x8_shm_frame_t	header
+    dirty bitmap		one bit per tile, tiles changed since the previous frame,
+                                bit (ty*tile_width+tx)&7 of byte (ty*tile_width+tx)/8
+    tiles			tile_width*tile_height*8 bytes, same format as the
+                                u8g2 full buffer (vertical bytes, LSB on top)
+
+  The writer never waits for readers. A reader must check with
+  u8x8_shm_IsFrameValid() after using the frame, that the slot had not
+  been overwritten in the meantime.
+
+*/
+
+#ifndef U8X8_SHM_H
+#define U8X8_SHM_H
+
+#include <stdint.h>
+
+#define U8X8_SHM_MAGIC 0x48533855UL	/* "U8SH" */
+#define U8X8_SHM_VERSION 1
+
+typedef struct _u8x8_shm_ring_struct u8x8_shm_ring_t;
+typedef struct _u8x8_shm_frame_struct u8x8_shm_frame_t;
+
+struct _u8x8_shm_ring_struct
+{
+  uint32_t magic;		/* U8X8_SHM_MAGIC, written after the ring is initialized */
+  uint32_t version;
+  uint32_t header_size;		/* offset of the first frame slot */
+  uint32_t frame_cnt;
+  uint32_t frame_size;		/* size of one frame slot */
+  uint32_t dirty_size;		/* size of the dirty bitmap */
+  uint16_t pixel_width;
+  uint16_t pixel_height;
+  uint16_t tile_width;
+  uint16_t tile_height;
+  uint64_t write_seq;		/* sequence number of the last complete frame, 0: no frame */
+  uint8_t reserved[16];
+};
+
+struct _u8x8_shm_frame_struct
+{
+  uint64_t seq;			/* 0 while the frame is written */
+  uint64_t timestamp_ns;	/* CLOCK_MONOTONIC */
+  uint32_t dirty_tile_cnt;	/* number of bits set in the dirty bitmap */
+  uint32_t reserved;
+};
+
+#define u8x8_shm_GetDirtyMap(frame) ((const uint8_t *)(frame) + sizeof(u8x8_shm_frame_t))
+#define u8x8_shm_GetTiles(ring, frame) (u8x8_shm_GetDirtyMap(frame) + (ring)->dirty_size)
+
+/* reader, map the ring read-only, returns NULL if not available or not initialized */
+const u8x8_shm_ring_t *u8x8_shm_OpenReader(const char *name);
+void u8x8_shm_CloseReader(const u8x8_shm_ring_t *ring);
+
+/* sequence number of the last complete frame, 0 if there is no frame */
+uint64_t u8x8_shm_GetLastSeq(const u8x8_shm_ring_t *ring);
+
+/* frame with sequence number seq, NULL if the frame was overwritten or is not yet written */
+const u8x8_shm_frame_t *u8x8_shm_GetFrame(const u8x8_shm_ring_t *ring, uint64_t seq);
+
+/* returns 1 if the frame still contains sequence number seq */
+uint8_t u8x8_shm_IsFrameValid(const u8x8_shm_frame_t *frame, uint64_t seq);
+
+uint8_t u8x8_shm_GetPixel(const u8x8_shm_ring_t *ring, const u8x8_shm_frame_t *frame, uint16_t x, uint16_t y);
+uint8_t u8x8_shm_IsTileDirty(const u8x8_shm_ring_t *ring, const u8x8_shm_frame_t *frame, uint16_t tx, uint16_t ty);
+
+#endif
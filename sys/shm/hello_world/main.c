@@ -0,0 +1,37 @@
+#include "u8g2.h"
+#include <stdio.h>
+#include <unistd.h>
+
+/*
+ * This example publishes 100 frames into the shared memory ring "/u8g2".
+ * Use the viewer example to follow the frames from another process.
+ */
+
+u8g2_t u8g2;
+
+int main(void)
+{
+  int i;
+  char s[16];
+  
+  if ( u8g2_SetupShm(&u8g2, &u8g2_cb_r0, "/u8g2", 128, 64, 8) == 0 )
+    return 1;
+  u8x8_InitDisplay(u8g2_GetU8x8(&u8g2));
+  u8x8_SetPowerSave(u8g2_GetU8x8(&u8g2), 0);
+  u8g2_SetFont(&u8g2, u8g2_font_helvB08_tr);
+
+  for( i = 0; i < 100; i++ )
+  {
+    u8g2_ClearBuffer(&u8g2);
+    u8g2_DrawStr(&u8g2, 10, 20, "Hello, world!");
+    sprintf(s, "Frame %d", i);
+    u8g2_DrawStr(&u8g2, 10, 40, s);
+    u8g2_DrawBox(&u8g2, i, 50, 28, 8);
+    u8g2_SendBuffer(&u8g2);
+    usleep(50000);
+  }
+  
+  /* keep the shared memory object for late readers */
+  u8x8_CloseShm(u8g2_GetU8x8(&u8g2), 0);
+  return 0;
+}
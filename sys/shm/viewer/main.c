@@ -0,0 +1,59 @@
+#include "u8x8_shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Follow the frames of a shared memory ring and print them to stdout.
+ * Usage: viewer [name [frames]], default: "/u8g2", 10 frames
+ */
+
+int main(int argc, char **argv)
+{
+  const char *name = "/u8g2";
+  const u8x8_shm_ring_t *ring;
+  const u8x8_shm_frame_t *frame;
+  uint64_t seq = 0;
+  uint64_t last;
+  int cnt = 10;
+  int x, y;
+  
+  if ( argc > 1 )
+    name = argv[1];
+  if ( argc > 2 )
+    cnt = atoi(argv[2]);
+  
+  while( (ring = u8x8_shm_OpenReader(name)) == NULL )
+    usleep(10000);
+  
+  while( cnt > 0 )
+  {
+    last = u8x8_shm_GetLastSeq(ring);
+    if ( last == seq )
+    {
+      usleep(1000);
+      continue;
+    }
+    seq = last;		/* always show the latest frame, skip older frames */
+    frame = u8x8_shm_GetFrame(ring, seq);
+    if ( frame == NULL )
+      continue;
+    printf("frame %llu, %u dirty tiles, time %llu ns\n", (unsigned long long)seq, frame->dirty_tile_cnt, (unsigned long long)frame->timestamp_ns);
+    for( y = 0; y < ring->pixel_height; y+=2 )
+    {
+      for( x = 0; x < ring->pixel_width; x++ )
+      {
+	if ( u8x8_shm_GetPixel(ring, frame, x, y) )
+	  putchar( u8x8_shm_GetPixel(ring, frame, x, y+1) ? '#' : '"' );
+	else
+	  putchar( u8x8_shm_GetPixel(ring, frame, x, y+1) ? '.' : ' ' );
+      }
+      putchar('\n');
+    }
+    if ( u8x8_shm_IsFrameValid(frame, seq) == 0 )
+      printf("frame %llu was overwritten while reading\n", (unsigned long long)seq);
+    cnt--;
+  }
+  u8x8_shm_CloseReader(ring);
+  return 0;
+}
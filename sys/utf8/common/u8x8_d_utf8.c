@@ -129,6 +129,173 @@ void chgr_set_multiple_8pixel(int x, int y, int cnt, uint8_t *pixel, uint16_t f)
 
 
 
+/*==========================================*/
+/* 
+  terminal output: only the changed cells are written, the cursor is moved 
+  with ANSI escape sequences (ESC [ row ; col H and ESC [ n C) 
+  
+  UTF8_TERM_QUADRANT: 2x2 pixel per cell (same as utf8_show())
+  UTF8_TERM_BRAILLE: 2x4 pixel per cell
+  
+  If enabled with utf8_term_set_mode(), the output is also done with
+  U8X8_MSG_DISPLAY_REFRESH (u8g2_SendBuffer(), u8g2_NextPage()).
+*/
+
+#define UTF8_TERM_ROWS (CHGR_HEIGHT/2)
+#define UTF8_TERM_COLS (CHGR_WIDTH/2)
+/* unchanged cells between two changed cells, which are written again instead of moving the cursor */
+#define UTF8_TERM_MAX_GAP 2
+
+static int utf8_term_mode = UTF8_TERM_OFF;
+static int utf8_term_is_valid = 0;	/* 0: clear the terminal and write all cells */
+static unsigned char utf8_term_prev[UTF8_TERM_ROWS][UTF8_TERM_COLS];	/* cells on the terminal */
+static unsigned char utf8_term_curr[UTF8_TERM_ROWS][UTF8_TERM_COLS];
+static char utf8_term_buf[UTF8_TERM_ROWS*(UTF8_TERM_COLS*3+16)+32];
+
+static unsigned chgr_get_pixel(unsigned x, unsigned y)
+{
+  unsigned char *p;
+  p = chgr_bitmap_pos(x, y);
+  if ( p == NULL )
+    return 0;
+  return (*p >> (((y&1)<<1) + (1-(x&1)))) & 1;
+}
+
+/* braille dots 1..8 (bit 0..7) for a 2x4 cell */
+static unsigned chgr_get_braille(unsigned cx, unsigned cy)
+{
+  unsigned x = cx*2, y = cy*4;
+  return chgr_get_pixel(x, y) | 
+    (chgr_get_pixel(x, y+1) << 1) | 
+    (chgr_get_pixel(x, y+2) << 2) | 
+    (chgr_get_pixel(x+1, y) << 3) | 
+    (chgr_get_pixel(x+1, y+1) << 4) | 
+    (chgr_get_pixel(x+1, y+2) << 5) | 
+    (chgr_get_pixel(x, y+3) << 6) | 
+    (chgr_get_pixel(x+1, y+3) << 7);
+}
+
+static char *utf8_term_put_cell(char *p, int mode, unsigned v)
+{
+  const char *s;
+  if ( v == 0 )
+  {
+    *p++ = ' ';
+  }
+  else if ( mode == UTF8_TERM_BRAILLE )
+  {
+    /* U+2800 + v */
+    *p++ = 0xe2;
+    *p++ = 0xa0 | (v >> 6);
+    *p++ = 0x80 | (v & 0x3f);
+  }
+  else
+  {
+    s = chgr_to_str(v);
+    while( *s != '\0' )
+      *p++ = *s++;
+  }
+  return p;
+}
+
+/* UTF8_TERM_OFF, UTF8_TERM_QUADRANT, UTF8_TERM_BRAILLE */
+void utf8_term_set_mode(int mode)
+{
+  utf8_term_mode = mode;
+  utf8_term_is_valid = 0;
+}
+
+/* clear the terminal and write all cells with the next utf8_term_show() */
+void utf8_term_reset(void)
+{
+  utf8_term_is_valid = 0;
+}
+
+/* 
+  write the changed cells to stdout, returns the number of bytes 
+  if the mode is UTF8_TERM_OFF, this call uses UTF8_TERM_QUADRANT, the mode is not changed
+*/
+size_t utf8_term_show(void)
+{
+  unsigned x, y, rows, end, gap;
+  unsigned cursor_x = 0, cursor_y = 0;	/* 0: unknown */
+  int is_cursor_valid = 0;
+  int mode = utf8_term_mode;
+  char *p = utf8_term_buf;
+  
+  if ( mode == UTF8_TERM_OFF )
+    mode = UTF8_TERM_QUADRANT;
+  rows = mode == UTF8_TERM_BRAILLE ? (CHGR_HEIGHT+3)/4 : UTF8_TERM_ROWS;
+  
+  for( y = 0; y < rows; y++ )
+    for( x = 0; x < UTF8_TERM_COLS; x++ )
+      utf8_term_curr[y][x] = mode == UTF8_TERM_BRAILLE ? chgr_get_braille(x, y) : chgr_bitmap[y][x];
+  
+  if ( utf8_term_is_valid == 0 )
+  {
+    p += sprintf(p, "\x1b[H\x1b[2J");
+    for( y = 0; y < rows; y++ )
+      for( x = 0; x < UTF8_TERM_COLS; x++ )
+	utf8_term_prev[y][x] = 0;	/* cleared terminal */
+    cursor_x = 1;
+    cursor_y = 1;
+    is_cursor_valid = 1;
+    utf8_term_is_valid = 1;
+  }
+  
+  for( y = 0; y < rows; y++ )
+  {
+    x = 0;
+    while( x < UTF8_TERM_COLS )
+    {
+      if ( utf8_term_curr[y][x] == utf8_term_prev[y][x] )
+      {
+	x++;
+	continue;
+      }
+      /* find the end of the run, include short gaps of unchanged cells */
+      end = x+1;
+      gap = 0;
+      while( end + gap < UTF8_TERM_COLS && gap <= UTF8_TERM_MAX_GAP )
+      {
+	if ( utf8_term_curr[y][end+gap] != utf8_term_prev[y][end+gap] )
+	{
+	  end += gap+1;
+	  gap = 0;
+	}
+	else
+	{
+	  gap++;
+	}
+      }
+      
+      /* move the cursor to x+1, y+1 */
+      if ( is_cursor_valid == 0 || cursor_y != y+1 || cursor_x > x+1 )
+	p += sprintf(p, "\x1b[%u;%uH", y+1, x+1);
+      else if ( cursor_x < x+1 )
+	p += sprintf(p, "\x1b[%uC", x+1-cursor_x);
+      
+      while( x < end )
+      {
+	p = utf8_term_put_cell(p, mode, utf8_term_curr[y][x]);
+	utf8_term_prev[y][x] = utf8_term_curr[y][x];
+	x++;
+      }
+      cursor_x = end+1;
+      cursor_y = y+1;
+      is_cursor_valid = 1;
+    }
+  }
+  
+  if ( p == utf8_term_buf )
+    return 0;
+  /* place the cursor below the picture */
+  p += sprintf(p, "\x1b[%u;1H", rows+1);
+  fwrite(utf8_term_buf, p - utf8_term_buf, 1, stdout);
+  fflush(stdout);
+  return p - utf8_term_buf;
+}
+
 /*==========================================*/
 /* tga description procedures */
 
@@ -177,6 +344,10 @@ uint8_t u8x8_d_utf8(u8x8_t *u8g2, uint8_t msg, uint8_t arg_int, void *arg_ptr)
       break;
     case U8X8_MSG_DISPLAY_SET_CONTRAST:
       break;
+    case U8X8_MSG_DISPLAY_REFRESH:
+      if ( utf8_term_mode != UTF8_TERM_OFF )
+	utf8_term_show();
+      break;
     case U8X8_MSG_DISPLAY_DRAW_TILE:
           
       x = ((u8x8_tile_t *)arg_ptr)->x_pos;
@@ -0,0 +1,300 @@
+/*
+
+  u8rec2pbm.c
+  
+  Convert a recording of the recorder device (sys/record) into PBM files
+  
+  Copyright (c) 2023, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+
+  usage: u8rec2pbm [-i] [-f first] [-l last] recording [prefix]
+    -i		list the frames, do not write PBM files
+    -f first	number of the first frame (default: 0)
+    -l last	number of the last frame (default: last frame of the recording)
+    prefix	name of the PBM files, default "frame", files are <prefix>00000.pbm, ...
+  
+  If the recording has a frame index, the conversion starts at the keyframe
+  before the first frame. Otherwise all frames are decoded from the start.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "u8x8_record.h"
+
+FILE *fp;
+uint16_t pixel_width, pixel_height, tile_width, tile_height;
+size_t image_size;
+uint8_t *image;
+uint8_t *data;
+uint8_t *rle;
+
+uint64_t *frame_index = NULL;
+uint32_t frame_cnt = 0;
+
+uint8_t frame_type;
+uint32_t frame_time;
+uint32_t frame_len;
+
+static uint32_t get_long(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1]<<8) | ((uint32_t)p[2]<<16) | ((uint32_t)p[3]<<24);
+}
+
+static uint64_t get_longlong(const uint8_t *p)
+{
+  return (uint64_t)get_long(p) | ((uint64_t)get_long(p+4) << 32);
+}
+
+/* read the frame index, returns 0 if there is no index */
+static int read_index(void)
+{
+  uint8_t buf[U8X8_RECORD_TRAILER_SIZE];
+  uint64_t offset;
+  uint32_t i;
+  
+  if ( fseek(fp, -U8X8_RECORD_TRAILER_SIZE, SEEK_END) != 0 )
+    return 0;
+  if ( fread(buf, U8X8_RECORD_TRAILER_SIZE, 1, fp) != 1 || memcmp(buf, "U8RT", 4) != 0 )
+    return 0;
+  frame_cnt = get_long(buf+4);
+  offset = get_longlong(buf+8);
+  frame_index = (uint64_t *)malloc(((size_t)frame_cnt+1)*sizeof(uint64_t));
+  if ( frame_index == NULL || fseek(fp, (long)offset, SEEK_SET) != 0 )
+    return 0;
+  if ( fread(buf, 8, 1, fp) != 1 || memcmp(buf, "U8RI", 4) != 0 )
+    return 0;
+  for( i = 0; i < frame_cnt; i++ )
+  {
+    if ( fread(buf, 8, 1, fp) != 1 )
+      return 0;
+    frame_index[i] = get_longlong(buf);
+  }
+  return 1;
+}
+
+/* read the next frame at the current file position, returns 0 at the end of the recording */
+static int read_frame(void)
+{
+  uint8_t buf[U8X8_RECORD_FRAME_HEADER_SIZE];
+  size_t i, o;
+  uint8_t c;
+  
+  if ( fread(buf, U8X8_RECORD_FRAME_HEADER_SIZE, 1, fp) != 1 )
+    return 0;
+  frame_type = buf[0];
+  if ( frame_type != U8X8_RECORD_KEYFRAME && frame_type != U8X8_RECORD_DELTA )
+    return 0;		/* frame index or garbage */
+  frame_time = get_long(buf+1);
+  frame_len = get_long(buf+5);
+  if ( frame_len > image_size + (image_size+127)/128 )
+    return 0;
+  if ( fread(rle, 1, frame_len, fp) != frame_len )
+    return 0;
+  if ( frame_len == 0 )
+    return 1;	/* delta frame without change */
+  
+  /* decompress */
+  i = 0;
+  o = 0;
+  while( i < frame_len && o < image_size )
+  {
+    c = rle[i++];
+    if ( c < 128 )
+    {
+      while( c != 255 && i < frame_len && o < image_size )
+      {
+	data[o++] = rle[i++];
+	c--;
+      }
+    }
+    else if ( i < frame_len )
+    {
+      c -= 126;
+      while( c > 0 && o < image_size )
+      {
+	data[o++] = rle[i];
+	c--;
+      }
+      i++;
+    }
+  }
+  if ( o != image_size )
+    return 0;
+  
+  if ( frame_type == U8X8_RECORD_KEYFRAME )
+    memcpy(image, data, image_size);
+  else
+    for( i = 0; i < image_size; i++ )
+      image[i] ^= data[i];
+  return 1;
+}
+
+static int write_pbm(const char *name)
+{
+  FILE *out;
+  uint16_t x, y;
+  uint8_t b;
+  
+  out = fopen(name, "wb");
+  if ( out == NULL )
+  {
+    perror(name);
+    return 0;
+  }
+  fprintf(out, "P4\n%d %d\n", pixel_width, pixel_height);
+  for( y = 0; y < pixel_height; y++ )
+  {
+    b = 0;
+    for( x = 0; x < pixel_width; x++ )
+    {
+      b <<= 1;
+      b |= (image[(size_t)(y/8)*tile_width*8 + x] >> (y&7)) & 1;
+      if ( (x & 7) == 7 )
+      {
+	fputc(b, out);
+	b = 0;
+      }
+    }
+    if ( (pixel_width & 7) != 0 )
+      fputc(b << (8 - (pixel_width & 7)), out);
+  }
+  fclose(out);
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  uint8_t header[U8X8_RECORD_FILE_HEADER_SIZE];
+  const char *name = NULL;
+  const char *prefix = "frame";
+  char pbm_name[1024];
+  int is_list = 0;
+  uint32_t first = 0;
+  uint32_t last = 0xffffffff;
+  uint32_t n;
+  
+  while( argc > 1 )
+  {
+    argc--; argv++;
+    if ( strcmp(argv[0], "-i") == 0 )
+      is_list = 1;
+    else if ( strcmp(argv[0], "-f") == 0 && argc > 1 )
+    {
+      argc--; argv++;
+      first = strtoul(argv[0], NULL, 10);
+    }
+    else if ( strcmp(argv[0], "-l") == 0 && argc > 1 )
+    {
+      argc--; argv++;
+      last = strtoul(argv[0], NULL, 10);
+    }
+    else if ( name == NULL )
+      name = argv[0];
+    else
+      prefix = argv[0];
+  }
+  if ( name == NULL )
+  {
+    printf("usage: u8rec2pbm [-i] [-f first] [-l last] recording [prefix]\n");
+    return 1;
+  }
+  
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
+  {
+    perror(name);
+    return 1;
+  }
+  if ( fread(header, U8X8_RECORD_FILE_HEADER_SIZE, 1, fp) != 1 || memcmp(header, "U8RC", 4) != 0 || header[4] != U8X8_RECORD_VERSION )
+  {
+    printf("%s: not a recording (version %d)\n", name, U8X8_RECORD_VERSION);
+    return 1;
+  }
+  pixel_width = header[6] | (header[7] << 8);
+  pixel_height = header[8] | (header[9] << 8);
+  tile_width = (pixel_width+7)/8;
+  tile_height = (pixel_height+7)/8;
+  image_size = (size_t)tile_width*tile_height*8;
+  image = (uint8_t *)calloc(1, image_size);
+  data = (uint8_t *)malloc(image_size);
+  rle = (uint8_t *)malloc(image_size + (image_size+127)/128);
+  if ( image == NULL || data == NULL || rle == NULL )
+  {
+    printf("%s: out of memory\n", name);
+    return 1;
+  }
+  
+  /* start at the keyframe before the first frame */
+  n = 0;
+  if ( read_index() && frame_cnt > 0 )
+  {
+    n = first < frame_cnt ? first : frame_cnt-1;
+    for(;;)
+    {
+      if ( fseek(fp, (long)frame_index[n], SEEK_SET) != 0 || fread(header, 1, 1, fp) != 1 )
+      {
+	printf("%s: read error\n", name);
+	return 1;
+      }
+      if ( header[0] == U8X8_RECORD_KEYFRAME || n == 0 )
+	break;
+      n--;
+    }
+    fseek(fp, (long)frame_index[n], SEEK_SET);
+  }
+  else
+  {
+    fseek(fp, U8X8_RECORD_FILE_HEADER_SIZE, SEEK_SET);
+  }
+  
+  if ( is_list )
+    printf("%dx%d\n frame     time type   bytes\n", pixel_width, pixel_height);
+  while( n <= last && read_frame() )
+  {
+    if ( n >= first )
+    {
+      if ( is_list )
+      {
+	printf("%6u %8u %s %7u\n", n, frame_time, frame_type == U8X8_RECORD_KEYFRAME ? "key  " : "delta", frame_len);
+      }
+      else
+      {
+	snprintf(pbm_name, sizeof(pbm_name), "%s%05u.pbm", prefix, n);
+	if ( write_pbm(pbm_name) == 0 )
+	  return 1;
+      }
+    }
+    n++;
+  }
+  fclose(fp);
+  return 0;
+}
@@ -0,0 +1,327 @@
+/*
+
+  u8x8trace.c
+  
+  Summary of a trace file, written by u8x8_trace.c
+  
+  Copyright (c) 2023, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+
+
+  usage: u8x8trace [-v] tracefile
+    -v	list all records
+  
+  Output is one line per frame:
+    bytes	number of bytes sent by the byte procedure
+    transfers	number of U8X8_MSG_BYTE_START_TRANSFER
+    tiles	number of tiles (cnt*arg_int) of all U8X8_MSG_DISPLAY_DRAW_TILE/DRAW_FRAME
+    draw_calls	number of U8X8_MSG_DISPLAY_DRAW_TILE/DRAW_FRAME
+    draw_time	time spent inside U8X8_MSG_DISPLAY_DRAW_TILE/DRAW_FRAME 
+    frame_time	time from the first to the last record of the frame
+  Time values are in the unit of the get_time() procedure.
+  
+  Frames are separated by u8x8_trace_MarkFrame(). If there is no frame marker
+  in the trace, a new frame starts with a DRAW_TILE message, which does not 
+  continue the tile position of the previous DRAW_TILE message.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "u8x8.h"
+
+struct frame_struct
+{
+  unsigned long bytes;
+  unsigned long transfers;
+  unsigned long tiles;
+  unsigned long draw_calls;
+  unsigned long draw_time;
+  uint32_t start_time;
+  uint32_t end_time;
+  int is_used;
+};
+
+struct frame_struct frame;
+struct frame_struct total;
+unsigned long frame_cnt = 0;
+
+int is_verbose = 0;
+int is_frame_marker = 0;
+int last_x = -1, last_y = -1;
+uint32_t draw_start_time;
+uint8_t draw_frame[3];	/* payload of the last U8X8_MSG_DISPLAY_DRAW_FRAME */
+
+void frame_clear(void)
+{
+  memset(&frame, 0, sizeof(frame));
+}
+
+void frame_print(void)
+{
+  if ( frame.is_used == 0 )
+    return;
+  printf("%6lu %8lu %9lu %6lu %10lu %9lu %10lu\n", 
+    frame_cnt, frame.bytes, frame.transfers, frame.tiles, frame.draw_calls, 
+    frame.draw_time, (unsigned long)(frame.end_time - frame.start_time));
+  total.bytes += frame.bytes;
+  total.transfers += frame.transfers;
+  total.tiles += frame.tiles;
+  total.draw_calls += frame.draw_calls;
+  total.draw_time += frame.draw_time;
+  frame_cnt++;
+  frame_clear();
+}
+
+/* number of payload bytes after the record */
+unsigned payload_size(uint8_t type, uint8_t arg)
+{
+  if ( type == U8X8_MSG_BYTE_SEND )
+    return arg;
+  if ( type == (U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE) || type == (U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME) )
+    return 3;
+  return 0;
+}
+
+/* returns the next record, NULL if the record at p is incomplete */
+const uint8_t *next_record(const uint8_t *p, const uint8_t *end)
+{
+  if ( end - p < U8X8_TRACE_RECORD_SIZE )
+    return NULL;
+  if ( (size_t)(end - p - U8X8_TRACE_RECORD_SIZE) < payload_size(p[0], p[5]) )
+    return NULL;
+  return p + U8X8_TRACE_RECORD_SIZE + payload_size(p[0], p[5]);
+}
+
+/* first pass: check for frame markers */
+int scan_frame_marker(const uint8_t *p, const uint8_t *end)
+{
+  while( p < end )
+  {
+    if ( next_record(p, end) == NULL )
+      break;
+    if ( p[0] == U8X8_TRACE_FRAME )
+      return 1;
+    p = next_record(p, end);
+  }
+  return 0;
+}
+
+void do_record(uint8_t type, uint32_t t, uint8_t arg, const uint8_t *payload)
+{
+  int x, y;
+  
+  if ( type == (U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE) && is_frame_marker == 0 )
+  {
+    x = payload[0];
+    y = payload[1];
+    if ( y < last_y || ( y == last_y && x <= last_x ) )
+      frame_print();
+    last_x = x + payload[2]*arg - 1;
+    last_y = y;
+  }
+  
+  /* DRAW_FRAME: if not handled, the rows will follow as DRAW_TILE, starting at row y */
+  if ( type == (U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME) && is_frame_marker == 0 )
+  {
+    x = payload[0];
+    y = payload[1];
+    if ( y < last_y || ( y == last_y && x <= last_x ) )
+      frame_print();
+    last_x = 255;
+    last_y = y - 1;
+  }
+  if ( type == (U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME) && arg != 0 )
+  {
+    last_x = draw_frame[0] + draw_frame[2] - 1;
+    last_y = draw_frame[1] + arg - 1;
+  }
+  
+  if ( frame.is_used == 0 )
+  {
+    frame.start_time = t;
+    frame.is_used = 1;
+  }
+  frame.end_time = t;
+  
+  switch(type)
+  {
+    case U8X8_MSG_BYTE_SEND:
+      frame.bytes += arg;
+      break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+      frame.transfers++;
+      break;
+    case U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE:
+      frame.draw_calls++;
+      frame.tiles += (unsigned long)payload[2]*arg;
+      draw_start_time = t;
+      break;
+    case U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE:
+      frame.draw_time += t - draw_start_time;
+      break;
+    case U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME:
+      draw_frame[0] = payload[0];
+      draw_frame[1] = payload[1];
+      draw_frame[2] = payload[2];
+      draw_start_time = t;
+      break;
+    case U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME:
+      if ( arg != 0 )
+      {
+	frame.draw_calls++;
+	frame.tiles += (unsigned long)draw_frame[2]*arg;
+	frame.draw_time += t - draw_start_time;
+      }
+      break;
+    case U8X8_TRACE_FRAME:
+      frame_print();
+      break;
+  }
+}
+
+void print_record(uint8_t type, uint32_t t, uint8_t arg, const uint8_t *payload)
+{
+  int i;
+  printf("%10lu ", (unsigned long)t);
+  switch(type)
+  {
+    case U8X8_MSG_BYTE_INIT: printf("byte init"); break;
+    case U8X8_MSG_BYTE_SET_DC: printf("dc %u", arg); break;
+    case U8X8_MSG_BYTE_START_TRANSFER: printf("start"); break;
+    case U8X8_MSG_BYTE_END_TRANSFER: printf("end"); break;
+    case U8X8_MSG_BYTE_SEND:
+      printf("send %u:", arg);
+      for( i = 0; i < arg; i++ )
+	printf(" %02x", payload[i]);
+      break;
+    case U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_TILE:
+      printf("draw tile x=%u y=%u cnt=%u repeat=%u", payload[0], payload[1], payload[2], arg); 
+      break;
+    case U8X8_TRACE_DISPLAY|U8X8_MSG_DISPLAY_DRAW_FRAME:
+      printf("draw frame x=%u y=%u cnt=%u rows=%u", payload[0], payload[1], payload[2], arg); 
+      break;
+    case U8X8_TRACE_FRAME: printf("frame"); break;
+    default:
+      if ( (type & U8X8_TRACE_DONE) && (type & U8X8_TRACE_DISPLAY) )
+	printf("display msg %u done", type & ~(U8X8_TRACE_DONE|U8X8_TRACE_DISPLAY));
+      else if ( type & U8X8_TRACE_DISPLAY )
+	printf("display msg %u arg=%u", type & ~U8X8_TRACE_DISPLAY, arg);
+      else
+	printf("byte msg %u arg=%u", type, arg);
+      break;
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+  FILE *fp;
+  uint8_t *buf;
+  long len;
+  const uint8_t *p, *end, *next;
+  uint8_t type, arg;
+  uint32_t t;
+  const char *name = NULL;
+  
+  while( argc > 1 )
+  {
+    argc--; argv++;
+    if ( strcmp(argv[0], "-v") == 0 )
+      is_verbose = 1;
+    else
+      name = argv[0];
+  }
+  if ( name == NULL )
+  {
+    printf("usage: u8x8trace [-v] tracefile\n");
+    return 1;
+  }
+  
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
+  {
+    perror(name);
+    return 1;
+  }
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  buf = (uint8_t *)malloc(len+1);
+  if ( buf == NULL || fread(buf, 1, len, fp) != (size_t)len )
+  {
+    printf("%s: read error\n", name);
+    return 1;
+  }
+  fclose(fp);
+  
+  if ( len < U8X8_TRACE_HEADER_SIZE || memcmp(buf, "U8TR", 4) != 0 || buf[4] != U8X8_TRACE_VERSION )
+  {
+    printf("%s: not a u8x8 trace file (version %d)\n", name, U8X8_TRACE_VERSION);
+    return 1;
+  }
+  
+  p = buf + U8X8_TRACE_HEADER_SIZE;
+  end = buf + len;
+  is_frame_marker = scan_frame_marker(p, end);
+  frame_clear();
+  
+  if ( is_verbose == 0 )
+    printf(" frame    bytes transfers  tiles draw_calls draw_time frame_time\n");
+  while( p < end )
+  {
+    next = next_record(p, end);
+    if ( next == NULL )
+    {
+      /* e.g. the trace buffer was not flushed completely */
+      printf("%s: incomplete record at offset %lu, ignored\n", name, (unsigned long)(p - buf));
+      break;
+    }
+    type = p[0];
+    t = (uint32_t)p[1] | ((uint32_t)p[2]<<8) | ((uint32_t)p[3]<<16) | ((uint32_t)p[4]<<24);
+    arg = p[5];
+    if ( is_verbose )
+      print_record(type, t, arg, p + U8X8_TRACE_RECORD_SIZE);
+    else
+      do_record(type, t, arg, p + U8X8_TRACE_RECORD_SIZE);
+    p = next;
+  }
+  
+  if ( is_verbose == 0 )
+  {
+    frame_print();
+    printf("%lu frames, %lu bytes, %lu transfers, %lu tiles, %lu draw calls, draw time %lu\n", 
+      frame_cnt, total.bytes, total.transfers, total.tiles, total.draw_calls, total.draw_time);
+    if ( frame_cnt > 0 )
+      printf("per frame: %lu bytes, %lu transfers, draw time %lu\n", 
+	total.bytes/frame_cnt, total.transfers/frame_cnt, total.draw_time/frame_cnt);
+  }
+  free(buf);
+  return 0;
+}